@@ -22,60 +22,42 @@ using namespace std;
 namespace peacockspider
 {
   ABDADASearcherBase::ABDADASearcherBase(const EvaluationFunction *eval_fun, TranspositionTable *transpos_table, function<Searcher *(const EvaluationFunction *, TranspositionTable *, const vector<ABDADAThread> &, int, int)> fun, unsigned thread_count, int max_depth, int max_quiescence_depth) :
-    _M_transposition_table(transpos_table)
+    _M_evaluation_function(eval_fun), _M_transposition_table(transpos_table), _M_searcher_function(fun), _M_max_depth(max_depth), _M_max_quiescence_depth(max_quiescence_depth), _M_pawn_table_entry_count(DEFAULT_PAWN_TABLE_ENTRY_COUNT), _M_thread_pool(&shared_thread_pool())
+  { start_threads(thread_count); }
+  
+  ABDADASearcherBase::~ABDADASearcherBase()
+  { quit_threads(); }
+
+  void ABDADASearcherBase::start_threads(unsigned thread_count)
   {
     for(unsigned i = 0; i < thread_count; i++) {
       _M_threads.push_back(ABDADAThread());
-      _M_threads.back().searcher = unique_ptr<Searcher>(fun(eval_fun, transpos_table, _M_threads, max_depth + 1, max_quiescence_depth));
-      _M_threads.back().command = ABDADACommand::NO_COMMAND;
+      _M_threads.back().searcher = unique_ptr<Searcher>(_M_searcher_function(_M_evaluation_function, _M_transposition_table, _M_threads, _M_max_depth + 1, _M_max_quiescence_depth));
       _M_threads.back().result = ABDADAResult::NO_RESULT;
     }
     _M_best_thread = &(_M_threads[0]);
-    for(unsigned i = 0; i < thread_count; i++) {
-      _M_threads[i].thread = thread([this, i]() {
-        unique_lock<mutex> lock(_M_threads[i].mutex);
-        while(true) {
-          while(_M_threads[i].command == ABDADACommand::NO_COMMAND) {
-            _M_threads[i].start_condition_variable.wait(lock);
-          }
-          if(_M_threads[i].command == ABDADACommand::QUIT) break;
-          ABDADAResult result = ABDADAResult::NO_RESULT;
-          int value = 0;
-          Move best_move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
-          if(_M_threads[i].command == ABDADACommand::SEARCH) {
-            try {
-              value = _M_threads[i].searcher->search_from_root(_M_alpha, _M_beta, _M_depth, _M_search_moves, best_move, *_M_boards, _M_last_board);
-              result = ABDADAResult::VALUE;
-            } catch(ThinkingStopException &e) {
-              result = ABDADAResult::THINKING_STOP;
-            } catch(PonderingStopException &e) {
-              result = ABDADAResult::PONDERING_STOP;
-            }
-          }
-          _M_threads[i].command = ABDADACommand::NO_COMMAND;
-          _M_threads[i].result = result;
-          _M_threads[i].value = value;
-          _M_threads[i].best_move = best_move;
-          _M_threads[i].stop_condition_variable.notify_one();
-        }
-      });
-    }
+    _M_thread_pool->reserve(thread_count - 1);
   }
-  
-  ABDADASearcherBase::~ABDADASearcherBase()
+
+  void ABDADASearcherBase::quit_threads()
+  { _M_thread_pool->release(_M_threads.size() - 1); }
+
+  void ABDADASearcherBase::search_in_thread(unsigned i)
   {
-    for(ABDADAThread &thread : _M_threads) {
-      thread.searcher->stop_thinking();
-      thread.searcher->stop_pondering();
-    }
-    for(ABDADAThread &thread : _M_threads) {
-      unique_lock<mutex> lock(thread.mutex);
-      thread.command = ABDADACommand::QUIT;
-      thread.start_condition_variable.notify_one();
-    }
-    for(ABDADAThread &thread : _M_threads) {
-      thread.thread.join();
+    ABDADAResult result = ABDADAResult::NO_RESULT;
+    int value = 0;
+    Move best_move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+    try {
+      value = _M_threads[i].searcher->search_from_root(_M_alpha, _M_beta, _M_depth, _M_search_moves, best_move, *_M_boards, _M_last_board);
+      result = ABDADAResult::VALUE;
+    } catch(ThinkingStopException &e) {
+      result = ABDADAResult::THINKING_STOP;
+    } catch(PonderingStopException &e) {
+      result = ABDADAResult::PONDERING_STOP;
     }
+    _M_threads[i].result = result;
+    _M_threads[i].value = value;
+    _M_threads[i].best_move = best_move;
   }
 
   const Board &ABDADASearcherBase::board() const
@@ -88,20 +70,6 @@ namespace peacockspider
     }
   }
 
-  void ABDADASearcherBase::set_stop_time(const chrono::high_resolution_clock::time_point &time)
-  {
-    for(ABDADAThread &thread : _M_threads) {
-      thread.searcher->set_stop_time(time);
-    }
-  }
-
-  void ABDADASearcherBase::unset_stop_time()
-  {
-    for(ABDADAThread &thread : _M_threads) {
-      thread.searcher->unset_stop_time();
-    }
-  }
-
   void ABDADASearcherBase::set_stop_nodes(uint64_t nodes)
   {
     for(ABDADAThread &thread : _M_threads) {
@@ -135,7 +103,7 @@ namespace peacockspider
   {
     _M_transposition_table->clear();
     for(ABDADAThread &thread : _M_threads) {
-      thread.searcher->clear();
+      thread.searcher->clear_for_new_game();
     }
   }
 
@@ -147,17 +115,14 @@ namespace peacockspider
     _M_search_moves = search_moves;
     _M_boards = &boards;
     _M_last_board = last_board;
-    for(ABDADAThread &thread : _M_threads) {
-      unique_lock<mutex> lock(thread.mutex);
-      thread.command = ABDADACommand::SEARCH;
-      thread.start_condition_variable.notify_one();
+    // The first thread searches in the calling thread.
+    for(unsigned i = 1; i < _M_threads.size(); i++) {
+      _M_task_group.run(*_M_thread_pool, [this, i]() { search_in_thread(i); });
     }
+    search_in_thread(0);
+    _M_task_group.wait();
     ABDADAResult result = ABDADAResult::NO_RESULT;
     for(ABDADAThread &thread : _M_threads) {
-      unique_lock<mutex> lock(thread.mutex);
-      while(thread.result == ABDADAResult::NO_RESULT) {
-        thread.stop_condition_variable.wait(lock);
-      }
       result |= thread.result;
       thread.result = ABDADAResult::NO_RESULT;
     }
@@ -242,4 +207,100 @@ namespace peacockspider
     
   int ABDADASearcherBase::max_quiescence_depth() const
   { return _M_threads[0].searcher->max_quiescence_depth(); }
+
+  void ABDADASearcherBase::set_pawn_table_entry_count(size_t count)
+  {
+    _M_pawn_table_entry_count = count;
+    for(ABDADAThread &thread : _M_threads) {
+      thread.searcher->set_pawn_table_entry_count(count);
+    }
+  }
+
+  uint64_t ABDADASearcherBase::pawn_table_probe_count() const
+  {
+    uint64_t count = 0;
+    for(const ABDADAThread &thread : _M_threads) {
+      count += thread.searcher->pawn_table_probe_count();
+    }
+    return count;
+  }
+
+  uint64_t ABDADASearcherBase::pawn_table_hit_count() const
+  {
+    uint64_t count = 0;
+    for(const ABDADAThread &thread : _M_threads) {
+      count += thread.searcher->pawn_table_hit_count();
+    }
+    return count;
+  }
+
+  uint64_t ABDADASearcherBase::cutoff_count() const
+  {
+    uint64_t count = 0;
+    for(const ABDADAThread &thread : _M_threads) {
+      count += thread.searcher->cutoff_count();
+    }
+    return count;
+  }
+
+  uint64_t ABDADASearcherBase::first_move_cutoff_count() const
+  {
+    uint64_t count = 0;
+    for(const ABDADAThread &thread : _M_threads) {
+      count += thread.searcher->first_move_cutoff_count();
+    }
+    return count;
+  }
+
+  size_t ABDADASearcherBase::transposition_table_entry_count() const
+  { return _M_transposition_table->entry_count(); }
+
+  void ABDADASearcherBase::set_transposition_table_entry_count(size_t count)
+  { _M_transposition_table->resize(count); }
+
+  bool ABDADASearcherBase::save_transposition_table(const string &file_name) const
+  { return _M_transposition_table->save(file_name); }
+
+  bool ABDADASearcherBase::load_transposition_table(const string &file_name)
+  { return _M_transposition_table->load(file_name); }
+
+  const LateMoveReductionTable &ABDADASearcherBase::late_move_reduction_table() const
+  { return _M_threads[0].searcher->late_move_reduction_table(); }
+
+  void ABDADASearcherBase::set_late_move_reduction_table(const LateMoveReductionTable &table)
+  {
+    for(ABDADAThread &thread : _M_threads) {
+      thread.searcher->set_late_move_reduction_table(table);
+    }
+  }
+
+  const PruningFlags &ABDADASearcherBase::pruning_flags() const
+  { return _M_threads[0].searcher->pruning_flags(); }
+
+  void ABDADASearcherBase::set_pruning_flags(const PruningFlags &flags)
+  {
+    for(ABDADAThread &thread : _M_threads) {
+      thread.searcher->set_pruning_flags(flags);
+    }
+  }
+
+  bool ABDADASearcherBase::can_set_thread_count() const
+  { return true; }
+
+  void ABDADASearcherBase::set_thread_count(unsigned thread_count)
+  {
+    Board board = _M_threads[0].searcher->board();
+    LateMoveReductionTable late_move_reduction_table = _M_threads[0].searcher->late_move_reduction_table();
+    PruningFlags pruning_flags = _M_threads[0].searcher->pruning_flags();
+    quit_threads();
+    _M_threads.clear();
+    start_threads(thread_count);
+    for(ABDADAThread &thread : _M_threads) {
+      thread.searcher->set_board(board);
+      thread.searcher->set_pawn_table_entry_count(_M_pawn_table_entry_count);
+      thread.searcher->set_late_move_reduction_table(late_move_reduction_table);
+      thread.searcher->set_pruning_flags(pruning_flags);
+    }
+    _M_transposition_table->set_thread_count(thread_count);
+  }
 }
@@ -29,8 +29,12 @@ namespace peacockspider
 
   int ABDADASingleSearcher::search_from_root(int alpha, int beta, int depth, const vector<Move> *search_moves, Move &best_move, const vector<Board> &boards, const Board *last_board)
   {
+    _M_board = _M_root_board;
+    set_root_evaluation_accumulator();
+    _M_hash_key_history.set_root(boards, last_board);
     _M_stack[0].pv_line.clear();
-    _M_nodes.store(0);
+    reset_nodes();
+    NodePublisher node_publisher(this);
     try {
       check_stop_for_nodes();
     } catch(SearchingStopException &e) {
@@ -38,8 +42,7 @@ namespace peacockspider
     }
     _M_nodes++;
     _M_stack[0].move_pairs = MovePairList(_M_move_pairs.get(), 0);
-    _M_stack[0].board.generate_pseudolegal_moves(_M_stack[0].move_pairs);
-    _M_move_order.set_move_scores(_M_stack[0].move_pairs, 0, _M_stack[0].board, _M_evaluation_function, nullptr);
+    MovePicker move_picker(_M_stack[0].move_pairs, 0, _M_board, _M_move_order, _M_evaluation_function, nullptr);
     int best_value = MIN_VALUE;
     Move tmp_best_move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
     bool is_all_done = false;
@@ -47,36 +50,38 @@ namespace peacockspider
       for(int iter = 0; iter < 2 && alpha < beta && !is_all_done; iter++) {
         bool is_first = true;
         is_all_done = true;
-        for(size_t i = 0; i < _M_stack[0].move_pairs.length(); i++) {
-          if(iter == 0) _M_stack[0].move_pairs.select_sort_move(i);
-          Move move = _M_stack[0].move_pairs[i].move;
+        if(iter != 0) move_picker.rewind();
+        Move move;
+        while(move_picker.next(move)) {
           if(search_moves != nullptr ? find(search_moves->begin(), search_moves->end(), move) != search_moves->end() : true) {
-            if(_M_stack[0].board.make_move(move, _M_stack[1].board)) {
-              bool is_exclusive = (iter == 0 && !is_first);
-              int value;
-              if(repetitions(_M_stack[1].board, boards, last_board) >= 1) {
-                _M_stack[1].pv_line.clear();
-                value = 0;
-              } else
-                value = -search(-beta, -alpha, depth - 1, 1, is_exclusive);
-              if(value == -VALUE_ON_EVALUATION) {
-                is_all_done = false;
-              } else if(value > best_value) {
-                _M_stack[0].pv_line.update(move, _M_stack[1].pv_line);
-                tmp_best_move = move;
-                best_value = value;
-                if(best_value > alpha) {
-                  alpha = value;
-                  if(best_value >= beta) {
-                    _M_move_order.increase_history_for_cutoff(_M_stack[0].board.side(), move.from(), move.to(), depth);
-                    best_move = tmp_best_move;
-                    return best_value;
-                  }
-                  _M_move_order.increase_history_for_alpha(_M_stack[0].board.side(), move.from(), move.to(), depth);
+            do_move(move, 0);
+            if(depth > 1) prefetch();
+            bool is_exclusive = (iter == 0 && !is_first);
+            int value;
+            _M_hash_key_history.set_hash_key(1, _M_board.hash_key());
+            if(_M_hash_key_history.has_repetition(1, _M_board.halfmove_clock())) {
+              _M_stack[1].pv_line.clear();
+              value = 0;
+            } else
+              value = -search(-beta, -alpha, depth - 1, 1, is_exclusive);
+            undo_move(move, 0);
+            if(value == -VALUE_ON_EVALUATION) {
+              is_all_done = false;
+            } else if(value > best_value) {
+              _M_stack[0].pv_line.update(move, _M_stack[1].pv_line);
+              tmp_best_move = move;
+              best_value = value;
+              if(best_value > alpha) {
+                alpha = value;
+                if(best_value >= beta) {
+                  update_for_cutoff(move, depth, 0, move_picker);
+                  best_move = tmp_best_move;
+                  return best_value;
                 }
+                _M_move_order.increase_history_for_alpha(_M_root_board.side(), move.from(), move.to(), depth);
               }
-              is_first = false;
             }
+            is_first = false;
           }
         }
       }
@@ -88,13 +93,13 @@ namespace peacockspider
   }
 
   bool ABDADASingleSearcher::before(int &alpha, int &beta, int depth, int ply, int &best_value, Move &best_move, bool is_exclusive) 
-  { return _M_transposition_table->retrieve_for_abdada(_M_stack[ply].board.hash_key(), alpha, beta, depth, best_value, best_move, is_exclusive); }
+  { return _M_transposition_table->retrieve_for_abdada(_M_board.hash_key(), alpha, beta, depth, best_value, best_move, is_exclusive); }
 
   void ABDADASingleSearcher::after(int alpha, int beta, int depth, int ply, int best_value, Move best_move)
-  { _M_transposition_table->store(_M_stack[ply].board.hash_key(), alpha, beta, depth, best_value, best_move); }
+  { _M_transposition_table->store(_M_board.hash_key(), alpha, beta, depth, best_value, best_move); }
 
   void ABDADASingleSearcher::cutoff(int alpha, int beta, int depth, int ply, int best_value, Move best_move)
-  { _M_transposition_table->store(_M_stack[ply].board.hash_key(), alpha, beta, depth, best_value, best_move); }
+  { _M_transposition_table->store(_M_board.hash_key(), alpha, beta, depth, best_value, best_move); }
 
   int ABDADASingleSearcher::search(int alpha, int beta, int depth, int ply, bool is_exclusive_node)
   {
@@ -104,12 +109,14 @@ namespace peacockspider
       _M_stack[ply].pv_line.clear();
       _M_nodes++;
       check_stop_for_nodes();
-      if(_M_stack[ply].board.halfmove_clock() >= 100) return 0;
+      if(_M_board.halfmove_clock() >= 100) return 0;
+      _M_hash_key_history.set_hash_key(ply, _M_board.hash_key());
+      if(ply > 0 && _M_hash_key_history.has_repetition(ply, _M_board.halfmove_clock())) return 0;
       int tt_best_value;
       Move tt_best_move;
       if(before(alpha, beta, depth, ply, tt_best_value, tt_best_move, is_exclusive_node)) {
         if(tt_best_move.to() != -1) {
-          if(_M_stack[ply].board.has_legal_move_for_tt(tt_best_move)) {
+          if(_M_board.has_legal_move_for_tt(tt_best_move)) {
             _M_stack[ply + 1].pv_line.clear();
             _M_stack[ply].pv_line.update(tt_best_move, _M_stack[ply + 1].pv_line);
           } else
@@ -117,13 +124,28 @@ namespace peacockspider
         }
         return tt_best_value;
       }
-      ABDADAThreadCountDecrement dec(this, ply);
+      ABDADAThreadCountDecrement dec(this, _M_board.hash_key());
       if(ply == 0)
         _M_stack[ply].move_pairs = MovePairList(_M_move_pairs.get(), 0);
       else
         _M_stack[ply].move_pairs = _M_stack[ply - 1].move_pairs.to_next_list();
-      _M_stack[ply].board.generate_pseudolegal_moves(_M_stack[ply].move_pairs);
-      _M_move_order.set_move_scores(_M_stack[ply].move_pairs, ply, _M_stack[ply].board, _M_evaluation_function, &tt_best_move);
+      bool in_check = _M_board.in_check();
+      int eval_value = MAX_VALUE;
+      if(can_prune_node(alpha, beta, depth, ply, in_check)) {
+        eval_value = static_evaluation(ply);
+        if(can_use_reverse_futility_pruning(beta, depth, eval_value)) {
+          cutoff(alpha, beta, depth, ply, eval_value, Move(Piece::PAWN, -1, -1, PromotionPiece::NONE));
+          return eval_value;
+        }
+        if(can_use_razoring(alpha, depth, eval_value)) {
+          int value = quiescence_search(alpha, beta, _M_max_quiescence_depth, ply);
+          if(value <= alpha) {
+            after(alpha, beta, depth, ply, value, Move(Piece::PAWN, -1, -1, PromotionPiece::NONE));
+            return value;
+          }
+        }
+      }
+      MovePicker move_picker(_M_stack[ply].move_pairs, ply, _M_board, _M_move_order, _M_evaluation_function, &tt_best_move, previous_move(ply));
       int best_value = MIN_VALUE;
       int old_alpha = alpha;
       Move best_move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
@@ -132,35 +154,44 @@ namespace peacockspider
       for(int iter = 0; iter < 2 && alpha < beta && !is_all_done; iter++) {
         bool is_first = true;
         is_all_done = true;
-        for(size_t i = 0; i < _M_stack[ply].move_pairs.length(); i++) {
-          if(iter == 0) _M_stack[ply].move_pairs.select_sort_move(i);
-          Move move = _M_stack[ply].move_pairs[i].move;
-          if(_M_stack[ply].board.make_move(move, _M_stack[ply + 1].board)) {
-            is_legal_move = true;
-            bool is_exclusive = (iter == 0 && !is_first);
-            int value = -search(-beta, -alpha, depth - 1, ply + 1, is_exclusive);
-            if(value == -VALUE_ON_EVALUATION) {
-              is_all_done = false;
-            } else if(value > best_value) {
-              _M_stack[ply].pv_line.update(move, _M_stack[ply + 1].pv_line);
-              best_move = move;
-              best_value = value;
-              if(best_value > alpha) {
-                alpha = best_value;
-                if(best_value >= beta) {
-                  _M_move_order.increase_history_for_cutoff(_M_stack[0].board.side(), move.from(), move.to(), depth);
-                  cutoff(old_alpha, beta, depth, ply, best_value, best_move);
-                  return best_value;
-                }
-                _M_move_order.increase_history_for_alpha(_M_stack[0].board.side(), move.from(), move.to(), depth);
+        if(iter != 0) move_picker.rewind();
+        Move move;
+        while(move_picker.next(move)) {
+          do_move(move, ply);
+          if(depth > 1) prefetch();
+          is_legal_move = true;
+          if(best_value > MIN_VALUE && is_futile_move(move, alpha, depth, ply, eval_value)) {
+            undo_move(move, ply);
+            if(eval_value + FUTILITY_PRUNING_MARGIN * depth > best_value) best_value = eval_value + FUTILITY_PRUNING_MARGIN * depth;
+            continue;
+          }
+          bool is_exclusive = (iter == 0 && !is_first);
+          int reduction = late_move_reduction(move, depth, ply, in_check, move_picker);
+          int value = -search(-beta, -alpha, depth - reduction - 1, ply + 1, is_exclusive);
+          if(reduction > 0 && value != -VALUE_ON_EVALUATION && value > alpha)
+            value = -search(-beta, -alpha, depth - 1, ply + 1, is_exclusive);
+          undo_move(move, ply);
+          if(value == -VALUE_ON_EVALUATION) {
+            is_all_done = false;
+          } else if(value > best_value) {
+            _M_stack[ply].pv_line.update(move, _M_stack[ply + 1].pv_line);
+            best_move = move;
+            best_value = value;
+            if(best_value > alpha) {
+              alpha = best_value;
+              if(best_value >= beta) {
+                update_for_cutoff(move, depth, ply, move_picker);
+                cutoff(old_alpha, beta, depth, ply, best_value, best_move);
+                return best_value;
               }
+              _M_move_order.increase_history_for_alpha(_M_root_board.side(), move.from(), move.to(), depth);
             }
-            is_first = true;
           }
+          is_first = true;
         }
       }
       if(!is_legal_move) {
-        best_value = _M_stack[ply].board.in_check() ? MIN_VALUE + ply : 0;
+        best_value = in_check ? MIN_VALUE + ply : 0;
       }
       after(old_alpha, beta, depth, ply, best_value, best_move);
       return best_value;
@@ -35,6 +35,9 @@ namespace peacockspider
     return nodes;
   }
 
-  void ABDADASingleSearcherBase::decrease_thread_count(int ply)
-  { _M_transposition_table->decrease_thread_count(_M_stack[ply].board.hash_key()); }
+  void ABDADASingleSearcherBase::prefetch()
+  { _M_transposition_table->prefetch_for_abdada(_M_board.hash_key()); }
+
+  void ABDADASingleSearcherBase::decrease_thread_count(HashKey hash_key)
+  { _M_transposition_table->decrease_thread_count(hash_key); }
 }
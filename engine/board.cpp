@@ -15,6 +15,7 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
 #include <cctype>
 #include <sstream>
 #include "chess.hpp"
@@ -49,6 +50,7 @@ namespace peacockspider
     _M_en_passant_column = -1;
     _M_halfmove_clock = 0;
     _M_fullmove_number = 1;
+    update_pieces();
     update_hash_key();
   }
   
@@ -71,19 +73,23 @@ namespace peacockspider
       _M_castlings[side_to_index(Side::WHITE)] == board._M_castlings[side_to_index(Side::WHITE)] &&
       _M_castlings[side_to_index(Side::BLACK)] == board._M_castlings[side_to_index(Side::BLACK)] &&
       _M_en_passant_column == board._M_en_passant_column &&
-      _M_hash_key == board._M_hash_key;
+      _M_hash_key == board._M_hash_key &&
+      _M_pawn_hash_key == board._M_pawn_hash_key;
   }
 
   void Board::update_hash_key()
   {
     _M_hash_key = 0;
+    _M_pawn_hash_key = 0;
     for(Square squ = 0; squ < 64; squ++) {
       switch(color(squ)) {
         case Color::WHITE:
           _M_hash_key ^= zobrist[side_to_index(Side::WHITE)][piece_to_index(piece(squ))][squ];
+          if(piece(squ) == Piece::PAWN) _M_pawn_hash_key ^= zobrist[side_to_index(Side::WHITE)][piece_to_index(Piece::PAWN)][squ];
           break;
         case Color::BLACK:
           _M_hash_key ^= zobrist[side_to_index(Side::BLACK)][piece_to_index(piece(squ))][squ];
+          if(piece(squ) == Piece::PAWN) _M_pawn_hash_key ^= zobrist[side_to_index(Side::BLACK)][piece_to_index(Piece::PAWN)][squ];
           break;
         default:
           break;
@@ -95,34 +101,120 @@ namespace peacockspider
     _M_hash_key ^= zobrist_en_passant_column[_M_en_passant_column + 1];
   }
 
+  void Board::update_pieces()
+  {
+    for(Square squ = 0; squ < 64; squ++) {
+      pair<Piece, bool> tmp_piece_pair = make_pair(Piece::PAWN, false);
+      for(size_t i = 0; i < 6; i++) {
+        if((_M_piece_bitboards[i] & (static_cast<Bitboard>(1) << squ)) != 0) {
+          tmp_piece_pair = make_pair(static_cast<Piece>(i), true);
+          break;
+        }
+      }
+      _M_pieces[squ] = (tmp_piece_pair.second ? static_cast<int8_t>(piece_to_index(tmp_piece_pair.first)) : -1);
+    }
+  }
+
+  bool Board::has_consistent_pieces() const
+  {
+    for(Square squ = 0; squ < 64; squ++) {
+      int count = 0;
+      for(size_t i = 0; i < 6; i++) {
+        if((_M_piece_bitboards[i] & (static_cast<Bitboard>(1) << squ)) != 0) {
+          if(_M_pieces[squ] != static_cast<int8_t>(i)) return false;
+          count++;
+        }
+      }
+      if(count == 0 && _M_pieces[squ] != -1) return false;
+      if(count > 1) return false;
+    }
+    return true;
+  }
+
   bool Board::has_attack(Side side, Square squ) const
   {
     Side opp_side = ~side;
     if((color_bitboard(opp_side) & piece_bitboard(Piece::PAWN) & tab_pawn_capture_bitboards[side_to_index(side)][squ]) != 0 ||
       (color_bitboard(opp_side) & piece_bitboard(Piece::KNIGHT) & tab_knight_bitboards[squ]) != 0 ||
       (color_bitboard(opp_side) & piece_bitboard(Piece::KING) & tab_king_bitboards[squ]) != 0) return true;
-    for(int i = 0; i < 4; i++) {
-      int count = tab_bishop_square_counts[squ][i];
-      for(int j = 0; j < count; j++) {
-        int from = tab_bishop_squares[squ][i][j];
-        if(has_color_piece(opp_side, Piece::BISHOP, Piece::QUEEN, from)) return true;
-        if(!has_empty(from)) break;
-      }
+    Bitboard occupied = color_bitboard(Side::WHITE) | color_bitboard(Side::BLACK);
+    if((color_bitboard(opp_side) & (piece_bitboard(Piece::BISHOP) | piece_bitboard(Piece::QUEEN)) & bishop_attack_bitboard(squ, occupied)) != 0 ||
+      (color_bitboard(opp_side) & (piece_bitboard(Piece::ROOK) | piece_bitboard(Piece::QUEEN)) & rook_attack_bitboard(squ, occupied)) != 0) return true;
+    return false;
+  }
+
+  Bitboard Board::attacker_bitboard(Side side, Square squ, Bitboard occupied) const
+  {
+    Bitboard bbd = (piece_bitboard(Piece::PAWN) & tab_pawn_capture_bitboards[side_to_index(side)][squ]) |
+      (piece_bitboard(Piece::KNIGHT) & tab_knight_bitboards[squ]) |
+      (piece_bitboard(Piece::KING) & tab_king_bitboards[squ]) |
+      ((piece_bitboard(Piece::BISHOP) | piece_bitboard(Piece::QUEEN)) & bishop_attack_bitboard(squ, occupied)) |
+      ((piece_bitboard(Piece::ROOK) | piece_bitboard(Piece::QUEEN)) & rook_attack_bitboard(squ, occupied));
+    return bbd & color_bitboard(~side) & occupied;
+  }
+
+  Bitboard Board::pinned_piece_bitboard() const
+  {
+    Square king_squ = king_square(_M_side);
+    Bitboard occupied = color_bitboard(Side::WHITE) | color_bitboard(Side::BLACK);
+    Bitboard pinned_bbd = 0;
+    // Snipers are the opponent sliders which would attack the king on the empty board.
+    Bitboard sniper_bbd = (((piece_bitboard(Piece::BISHOP) | piece_bitboard(Piece::QUEEN)) & bishop_attack_bitboard(king_squ, 0)) |
+      ((piece_bitboard(Piece::ROOK) | piece_bitboard(Piece::QUEEN)) & rook_attack_bitboard(king_squ, 0))) & color_bitboard(~_M_side);
+    for(; sniper_bbd != 0; sniper_bbd &= sniper_bbd - 1) {
+      Bitboard between_bbd = tab_between_bitboards[king_squ][__builtin_ctzll(sniper_bbd)] & occupied;
+      if(between_bbd != 0 && (between_bbd & (between_bbd - 1)) == 0) pinned_bbd |= between_bbd & color_bitboard(_M_side);
     }
-    for(int i = 0; i < 4; i++) {
-      int count = tab_rook_square_counts[squ][i];
-      for(int j = 0; j < count; j++) {
-        int from = tab_rook_squares[squ][i][j];
-        if(has_color_piece(opp_side, Piece::ROOK, Piece::QUEEN, from)) return true;
-        if(!has_empty(from)) break;
+    return pinned_bbd;
+  }
+
+  int Board::see(Move move, const int *piece_values) const
+  {
+    Bitboard occupied = color_bitboard(Side::WHITE) | color_bitboard(Side::BLACK);
+    int gains[32];
+    int attacker_value = piece_values[piece_to_index(move.piece())];
+    if(has_color(~_M_side, move.to())) {
+      gains[0] = piece_values[piece_to_index(piece(move.to()))];
+    } else if(move.piece() == Piece::PAWN && (move.from() & 7) != (move.to() & 7)) {
+      // The pawn captured en passant isn't on the destination square.
+      gains[0] = piece_values[piece_to_index(Piece::PAWN)];
+      occupied &= ~(static_cast<Bitboard>(1) << (_M_side == Side::WHITE ? move.to() - 8 : move.to() + 8));
+    } else
+      gains[0] = 0;
+    if(move.promotion_piece() != PromotionPiece::NONE) {
+      gains[0] += piece_values[promotion_piece_to_index(move.promotion_piece())] - piece_values[piece_to_index(Piece::PAWN)];
+      attacker_value = piece_values[promotion_piece_to_index(move.promotion_piece())];
+    }
+    occupied &= ~(static_cast<Bitboard>(1) << move.from());
+    Side side = ~_M_side;
+    int depth = 0;
+    while(depth < 31) {
+      // The attackers are found again for each capture so that the sliders behind the captured pieces are found.
+      Bitboard attacker_bbd = attacker_bitboard(~side, move.to(), occupied);
+      if(attacker_bbd == 0) break;
+      size_t attacker_idx;
+      Bitboard bbd = 0;
+      for(attacker_idx = 0; attacker_idx < 6; attacker_idx++) {
+        bbd = attacker_bbd & _M_piece_bitboards[attacker_idx];
+        if(bbd != 0) break;
       }
+      depth++;
+      gains[depth] = attacker_value - gains[depth - 1];
+      if(max(-gains[depth - 1], gains[depth]) < 0) break;
+      attacker_value = piece_values[attacker_idx];
+      occupied &= ~(bbd & (~bbd + 1));
+      side = ~side;
     }
-    return false;
+    for(; depth > 0; depth--) {
+      gains[depth - 1] = -max(-gains[depth - 1], gains[depth]);
+    }
+    return gains[0];
   }
 
   void Board::generate_pseudolegal_moves(MovePairList &move_pairs) const
   {
     move_pairs.clear();
+    Bitboard occupied = color_bitboard(Side::WHITE) | color_bitboard(Side::BLACK);
     Bitboard bbd = color_bitboard(_M_side);
     for(Square i = 0; i < 64; i += 4) {
       int bits = bbd & 0xf;
@@ -162,46 +254,22 @@ namespace peacockspider
               move_pairs.add_move_pair(MovePair(Move(Piece::KNIGHT, from, to, PromotionPiece::NONE)));
           }
         } else if(has_piece(Piece::BISHOP, from)) {
-          for(int k = 0; k < 4; k++) {
-            int squ_count = tab_bishop_square_counts[from][k];
-            for(int l = 0; l < squ_count; l++) {
-              Square to = tab_bishop_squares[from][k][l];
-              if(has_color(~_M_side, to)) {
-                move_pairs.add_move_pair(MovePair(Move(Piece::BISHOP, from, to, PromotionPiece::NONE)));
-                break;
-              } else if(has_empty(to)) {
-                move_pairs.add_move_pair(MovePair(Move(Piece::BISHOP, from, to, PromotionPiece::NONE)));
-              } else
-                break;
-            }
+          Bitboard to_bbd = bishop_attack_bitboard(from, occupied) & ~color_bitboard(_M_side);
+          for(; to_bbd != 0; to_bbd &= to_bbd - 1) {
+            Square to = __builtin_ctzll(to_bbd);
+            move_pairs.add_move_pair(MovePair(Move(Piece::BISHOP, from, to, PromotionPiece::NONE)));
           }
         } else if(has_piece(Piece::ROOK, from)) {
-          for(int k = 0; k < 4; k++) {
-            int squ_count = tab_rook_square_counts[from][k];
-            for(int l = 0; l < squ_count; l++) {
-              Square to = tab_rook_squares[from][k][l];
-              if(has_color(~_M_side, to)) {
-                move_pairs.add_move_pair(MovePair(Move(Piece::ROOK, from, to, PromotionPiece::NONE)));
-                break;
-              } else if(has_empty(to)) {
-                move_pairs.add_move_pair(MovePair(Move(Piece::ROOK, from, to, PromotionPiece::NONE)));
-              } else
-                break;
-            }
+          Bitboard to_bbd = rook_attack_bitboard(from, occupied) & ~color_bitboard(_M_side);
+          for(; to_bbd != 0; to_bbd &= to_bbd - 1) {
+            Square to = __builtin_ctzll(to_bbd);
+            move_pairs.add_move_pair(MovePair(Move(Piece::ROOK, from, to, PromotionPiece::NONE)));
           }
         } else if(has_piece(Piece::QUEEN, from)) {
-          for(int k = 0; k < 8; k++) {
-            int squ_count = tab_queen_square_counts[from][k];
-            for(int l = 0; l < squ_count; l++) {
-              Square to = tab_queen_squares[from][k][l];
-              if(has_color(~_M_side, to)) {
-                move_pairs.add_move_pair(MovePair(Move(Piece::QUEEN, from, to, PromotionPiece::NONE)));
-                break;
-              } else if(has_empty(to)) {
-                move_pairs.add_move_pair(MovePair(Move(Piece::QUEEN, from, to, PromotionPiece::NONE)));
-              } else
-                break;
-            }
+          Bitboard to_bbd = queen_attack_bitboard(from, occupied) & ~color_bitboard(_M_side);
+          for(; to_bbd != 0; to_bbd &= to_bbd - 1) {
+            Square to = __builtin_ctzll(to_bbd);
+            move_pairs.add_move_pair(MovePair(Move(Piece::QUEEN, from, to, PromotionPiece::NONE)));
           }
         } else if(has_piece(Piece::KING, from)) {
           int squ_count = tab_king_square_counts[from];
@@ -235,6 +303,7 @@ namespace peacockspider
   void Board::generate_pseudolegal_good_moves(MovePairList &move_pairs) const
   {
     move_pairs.clear();
+    Bitboard occupied = color_bitboard(Side::WHITE) | color_bitboard(Side::BLACK);
     Bitboard bbd = color_bitboard(_M_side);
     for(Square i = 0; i < 64; i += 4) {
       int bits = bbd & 0xf;
@@ -269,40 +338,22 @@ namespace peacockspider
               move_pairs.add_move_pair(MovePair(Move(Piece::KNIGHT, from, to, PromotionPiece::NONE)));
           }
         } else if(has_piece(Piece::BISHOP, from)) {
-          for(int k = 0; k < 4; k++) {
-            int squ_count = tab_bishop_square_counts[from][k];
-            for(int l = 0; l < squ_count; l++) {
-              Square to = tab_bishop_squares[from][k][l];
-              if(has_color(~_M_side, to)) {
-                move_pairs.add_move_pair(MovePair(Move(Piece::BISHOP, from, to, PromotionPiece::NONE)));
-                break;
-              } else if(!has_empty(to))
-                break;
-            }
+          Bitboard to_bbd = bishop_attack_bitboard(from, occupied) & color_bitboard(~_M_side);
+          for(; to_bbd != 0; to_bbd &= to_bbd - 1) {
+            Square to = __builtin_ctzll(to_bbd);
+            move_pairs.add_move_pair(MovePair(Move(Piece::BISHOP, from, to, PromotionPiece::NONE)));
           }
         } else if(has_piece(Piece::ROOK, from)) {
-          for(int k = 0; k < 4; k++) {
-            int squ_count = tab_rook_square_counts[from][k];
-            for(int l = 0; l < squ_count; l++) {
-              Square to = tab_rook_squares[from][k][l];
-              if(has_color(~_M_side, to)) {
-                move_pairs.add_move_pair(MovePair(Move(Piece::ROOK, from, to, PromotionPiece::NONE)));
-                break;
-              } else if(!has_empty(to))
-                break;
-            }
+          Bitboard to_bbd = rook_attack_bitboard(from, occupied) & color_bitboard(~_M_side);
+          for(; to_bbd != 0; to_bbd &= to_bbd - 1) {
+            Square to = __builtin_ctzll(to_bbd);
+            move_pairs.add_move_pair(MovePair(Move(Piece::ROOK, from, to, PromotionPiece::NONE)));
           }
         } else if(has_piece(Piece::QUEEN, from)) {
-          for(int k = 0; k < 8; k++) {
-            int squ_count = tab_queen_square_counts[from][k];
-            for(int l = 0; l < squ_count; l++) {
-              Square to = tab_queen_squares[from][k][l];
-              if(has_color(~_M_side, to)) {
-                move_pairs.add_move_pair(MovePair(Move(Piece::QUEEN, from, to, PromotionPiece::NONE)));
-                break;
-              } else if(!has_empty(to))
-                break;
-            }
+          Bitboard to_bbd = queen_attack_bitboard(from, occupied) & color_bitboard(~_M_side);
+          for(; to_bbd != 0; to_bbd &= to_bbd - 1) {
+            Square to = __builtin_ctzll(to_bbd);
+            move_pairs.add_move_pair(MovePair(Move(Piece::QUEEN, from, to, PromotionPiece::NONE)));
           }
         } else if(has_piece(Piece::KING, from)) {
           int squ_count = tab_king_square_counts[from];
@@ -317,16 +368,151 @@ namespace peacockspider
     }
   }
 
+  void Board::generate_pseudolegal_quiet_moves(MovePairList &move_pairs) const
+  {
+    move_pairs.clear();
+    Bitboard occupied = color_bitboard(Side::WHITE) | color_bitboard(Side::BLACK);
+    Bitboard bbd = color_bitboard(_M_side);
+    for(Square i = 0; i < 64; i += 4) {
+      int bits = bbd & 0xf;
+      int count = tab_square_offset_counts[bits];
+      for(int j = 0; j < count; j++) {
+        Square from = i + tab_square_offsets[bits][j];
+        if(has_piece(Piece::PAWN, from)) {
+          if(from >> 3 != (_M_side == Side::WHITE ? 6 : 1)) {
+            int squ_count = tab_pawn_square_counts[side_to_index(_M_side)][from];
+            for(int k = 0; k < squ_count; k++) {
+              Square to = tab_pawn_squares[side_to_index(_M_side)][from][k];
+              if(has_empty(to))
+                move_pairs.add_move_pair(MovePair(Move(Piece::PAWN, from, to, PromotionPiece::NONE)));
+              else
+                break;
+            }
+          }
+        } else if(has_piece(Piece::KNIGHT, from)) {
+          int squ_count = tab_knight_square_counts[from];
+          for(int k = 0; k < squ_count; k++) {
+            Square to = tab_knight_squares[from][k];
+            if(has_empty(to))
+              move_pairs.add_move_pair(MovePair(Move(Piece::KNIGHT, from, to, PromotionPiece::NONE)));
+          }
+        } else if(has_piece(Piece::BISHOP, from)) {
+          Bitboard to_bbd = bishop_attack_bitboard(from, occupied) & ~occupied;
+          for(; to_bbd != 0; to_bbd &= to_bbd - 1) {
+            Square to = __builtin_ctzll(to_bbd);
+            move_pairs.add_move_pair(MovePair(Move(Piece::BISHOP, from, to, PromotionPiece::NONE)));
+          }
+        } else if(has_piece(Piece::ROOK, from)) {
+          Bitboard to_bbd = rook_attack_bitboard(from, occupied) & ~occupied;
+          for(; to_bbd != 0; to_bbd &= to_bbd - 1) {
+            Square to = __builtin_ctzll(to_bbd);
+            move_pairs.add_move_pair(MovePair(Move(Piece::ROOK, from, to, PromotionPiece::NONE)));
+          }
+        } else if(has_piece(Piece::QUEEN, from)) {
+          Bitboard to_bbd = queen_attack_bitboard(from, occupied) & ~occupied;
+          for(; to_bbd != 0; to_bbd &= to_bbd - 1) {
+            Square to = __builtin_ctzll(to_bbd);
+            move_pairs.add_move_pair(MovePair(Move(Piece::QUEEN, from, to, PromotionPiece::NONE)));
+          }
+        } else if(has_piece(Piece::KING, from)) {
+          int squ_count = tab_king_square_counts[from];
+          for(int k = 0; k < squ_count; k++) {
+            int to = tab_king_squares[from][k];
+            if(has_empty(to))
+              move_pairs.add_move_pair(MovePair(Move(Piece::KING, from, to, PromotionPiece::NONE)));
+          }
+        }
+      }
+      bbd >>= 4;
+    }
+    if((side_castlings(_M_side) & SideCastlings::SHORT) != SideCastlings::NONE) {
+      Bitboard castling_mask = static_cast<Bitboard>(0x60) << (_M_side == Side::WHITE ? 0 : 64 - 8);
+      if((occupied & castling_mask) == 0) {
+        Square from = (_M_side == Side::WHITE ? E1 : E8);
+        Square to = (_M_side == Side::WHITE ? G1 : G8);
+        move_pairs.add_move_pair(MovePair(Move(Piece::KING, from, to, PromotionPiece::NONE)));
+      }
+    }
+    if((side_castlings(_M_side) & SideCastlings::LONG) != SideCastlings::NONE) {
+      Bitboard castling_mask = static_cast<Bitboard>(0x0e) << (_M_side == Side::WHITE ? 0 : 64 - 8);
+      if((occupied & castling_mask) == 0) {
+        Square from = (_M_side == Side::WHITE ? E1 : E8);
+        Square to = (_M_side == Side::WHITE ? C1 : C8);
+        move_pairs.add_move_pair(MovePair(Move(Piece::KING, from, to, PromotionPiece::NONE)));
+      }
+    }
+  }
+
+  bool Board::has_pseudolegal_move(Move move) const
+  {
+    if(move.from() < 0 || move.from() >= 64 || move.to() < 0 || move.to() >= 64) return false;
+    if(!has_color_piece(_M_side, move.piece(), move.from()) || has_color(_M_side, move.to())) return false;
+    Bitboard occupied = color_bitboard(Side::WHITE) | color_bitboard(Side::BLACK);
+    Bitboard dst_bbd = static_cast<Bitboard>(1) << move.to();
+    if(move.piece() == Piece::PAWN) {
+      if(move.from() >> 3 == (_M_side == Side::WHITE ? 6 : 1)) {
+        if(move.promotion_piece() != PromotionPiece::QUEEN && move.promotion_piece() != PromotionPiece::KNIGHT) return false;
+      } else {
+        if(move.promotion_piece() != PromotionPiece::NONE) return false;
+      }
+      if((tab_pawn_capture_bitboards[side_to_index(_M_side)][move.from()] & dst_bbd) != 0) {
+        Square en_passant_squ = (_M_en_passant_column != -1 ? _M_en_passant_column + (_M_side == Side::WHITE ? 050 : 020) : -1);
+        return has_color(~_M_side, move.to()) || move.to() == en_passant_squ;
+      }
+      int squ_count = tab_pawn_square_counts[side_to_index(_M_side)][move.from()];
+      for(int i = 0; i < squ_count; i++) {
+        Square to = tab_pawn_squares[side_to_index(_M_side)][move.from()][i];
+        if(!has_empty(to)) return false;
+        if(to == move.to()) return true;
+      }
+      return false;
+    }
+    if(move.promotion_piece() != PromotionPiece::NONE) return false;
+    switch(move.piece()) {
+      case Piece::KNIGHT:
+        return (tab_knight_bitboards[move.from()] & dst_bbd) != 0;
+      case Piece::BISHOP:
+        return (bishop_attack_bitboard(move.from(), occupied) & dst_bbd) != 0;
+      case Piece::ROOK:
+        return (rook_attack_bitboard(move.from(), occupied) & dst_bbd) != 0;
+      case Piece::QUEEN:
+        return (queen_attack_bitboard(move.from(), occupied) & dst_bbd) != 0;
+      case Piece::KING:
+        if((tab_king_bitboards[move.from()] & dst_bbd) != 0) return true;
+        if(move.from() == (_M_side == Side::WHITE ? E1 : E8)) {
+          if(move.to() == (_M_side == Side::WHITE ? G1 : G8) && (side_castlings(_M_side) & SideCastlings::SHORT) != SideCastlings::NONE) {
+            Bitboard castling_mask = static_cast<Bitboard>(0x60) << (_M_side == Side::WHITE ? 0 : 64 - 8);
+            return (occupied & castling_mask) == 0;
+          }
+          if(move.to() == (_M_side == Side::WHITE ? C1 : C8) && (side_castlings(_M_side) & SideCastlings::LONG) != SideCastlings::NONE) {
+            Bitboard castling_mask = static_cast<Bitboard>(0x0e) << (_M_side == Side::WHITE ? 0 : 64 - 8);
+            return (occupied & castling_mask) == 0;
+          }
+        }
+        return false;
+      default:
+        return false;
+    }
+  }
+
   bool Board::make_move(Move move, Board &board) const
+  {
+    if(move.piece() == Piece::KING && move.from() == (_M_side == Side::WHITE ? E1 : E8) && (move.to() == (_M_side == Side::WHITE ? G1 : G8) || move.to() == (_M_side == Side::WHITE ? C1 : C8))) {
+      if(in_check()) return false;
+      if(has_attack(_M_side, (move.from() + move.to()) >> 1)) return false;
+    }
+    unsafely_make_move(move, board);
+    return !board.in_check(_M_side);
+  }
+
+  void Board::unsafely_make_move(Move move, Board &board) const
   {
     Square short_castling_dst = (_M_side == Side::WHITE ? G1 : G8);
     Square long_castling_dst = (_M_side == Side::WHITE ? C1 : C8);
     Side opp_side = ~_M_side;
     if(move.piece() == Piece::KING && move.from() == (_M_side == Side::WHITE ? E1 : E8) && move.to() == short_castling_dst) {
-      if(in_check()) return false;
       Square rook_src = (_M_side == Side::WHITE ? H1 : H8);
       Square rook_dst = (_M_side == Side::WHITE ? F1 : F8);
-      if(has_attack(_M_side, rook_dst)) return false;
       board.set_color_bitboard(Side::WHITE, color_bitboard(Side::WHITE));
       board.set_color_bitboard(Side::BLACK, color_bitboard(Side::BLACK));
       board.set_piece_bitboard(Piece::PAWN, piece_bitboard(Piece::PAWN));
@@ -343,6 +529,11 @@ namespace peacockspider
       board.or_piece_bitboard(Piece::KING, static_cast<Bitboard>(1) << move.to());
       board.and_piece_bitboard(Piece::ROOK, ~(static_cast<Bitboard>(1) << rook_src));
       board.or_piece_bitboard(Piece::ROOK, static_cast<Bitboard>(1) << rook_dst);
+      copy(_M_pieces, _M_pieces + 64, board._M_pieces);
+      board._M_pieces[move.from()] = -1;
+      board._M_pieces[move.to()] = static_cast<int8_t>(piece_to_index(Piece::KING));
+      board._M_pieces[rook_src] = -1;
+      board._M_pieces[rook_dst] = static_cast<int8_t>(piece_to_index(Piece::ROOK));
       board.set_king_square(_M_side, move.to());
       board.set_king_square(opp_side, king_square(opp_side));
       board._M_side = opp_side;
@@ -352,6 +543,7 @@ namespace peacockspider
       board._M_halfmove_clock = _M_halfmove_clock + 1;
       board._M_fullmove_number = _M_fullmove_number + (_M_side == Side::BLACK ? 1 : 0); 
       board._M_hash_key = _M_hash_key;
+      board._M_pawn_hash_key = _M_pawn_hash_key;
       board._M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::KING)][move.from()];
       board._M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::KING)][move.to()];
       board._M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::ROOK)][rook_src];
@@ -362,10 +554,8 @@ namespace peacockspider
       board._M_hash_key ^= zobrist_en_passant_column[_M_en_passant_column + 1];
       board._M_hash_key ^= zobrist_en_passant_column[board._M_en_passant_column + 1];
     } else if(move.piece() == Piece::KING && move.from() == (_M_side == Side::WHITE ? E1 : E8) && move.to() == long_castling_dst) {
-      if(in_check()) return false;
       Square rook_src = (_M_side == Side::WHITE ? A1 : A8);
       Square rook_dst = (_M_side == Side::WHITE ? D1 : D8);
-      if(has_attack(_M_side, rook_dst)) return false;
       board.set_color_bitboard(Side::WHITE, color_bitboard(Side::WHITE));
       board.set_color_bitboard(Side::BLACK, color_bitboard(Side::BLACK));
       board.set_piece_bitboard(Piece::PAWN, piece_bitboard(Piece::PAWN));
@@ -382,6 +572,11 @@ namespace peacockspider
       board.or_piece_bitboard(Piece::KING, static_cast<Bitboard>(1) << move.to());
       board.and_piece_bitboard(Piece::ROOK, ~(static_cast<Bitboard>(1) << rook_src));
       board.or_piece_bitboard(Piece::ROOK, static_cast<Bitboard>(1) << rook_dst);
+      copy(_M_pieces, _M_pieces + 64, board._M_pieces);
+      board._M_pieces[move.from()] = -1;
+      board._M_pieces[move.to()] = static_cast<int8_t>(piece_to_index(Piece::KING));
+      board._M_pieces[rook_src] = -1;
+      board._M_pieces[rook_dst] = static_cast<int8_t>(piece_to_index(Piece::ROOK));
       board.set_king_square(_M_side, move.to());
       board.set_king_square(opp_side, king_square(opp_side));
       board._M_side = opp_side;
@@ -391,6 +586,7 @@ namespace peacockspider
       board._M_halfmove_clock = _M_halfmove_clock + 1;
       board._M_fullmove_number = _M_fullmove_number + (_M_side == Side::BLACK ? 1 : 0); 
       board._M_hash_key = _M_hash_key;
+      board._M_pawn_hash_key = _M_pawn_hash_key;
       board._M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::KING)][move.from()];
       board._M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::KING)][move.to()];
       board._M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::ROOK)][rook_src];
@@ -422,8 +618,11 @@ namespace peacockspider
         board.or_piece_bitboard(move.promotion_piece(), dst_bbd);
         dst_piece_idx = promotion_piece_to_index(move.promotion_piece());
       }
+      copy(_M_pieces, _M_pieces + 64, board._M_pieces);
+      board._M_pieces[move.from()] = -1;
+      board._M_pieces[move.to()] = static_cast<int8_t>(dst_piece_idx);
       bool is_cap = ((color_bitboard(opp_side) & dst_bbd) != 0);
-      bool is_cap_rook = (is_cap ? ((piece_bitboard(Piece::ROOK) & dst_bbd) != 0) : false);
+      bool is_cap_rook = (is_cap ? (_M_pieces[move.to()] == static_cast<int8_t>(piece_to_index(Piece::ROOK))) : false);
       Square en_passant_squ = (_M_en_passant_column != -1 ? _M_en_passant_column + (_M_side == Side::WHITE ? 050 : 020) : -1);
       Square en_passant_cap_squ = -1;
       if(move.piece() == Piece::PAWN && move.to() == en_passant_squ) {
@@ -433,6 +632,7 @@ namespace peacockspider
         en_passant_cap_squ = (_M_side == Side::WHITE ? move.to() - 8 : move.to() + 8);
         board.and_color_bitboard(opp_side, cap_mask);
         board.and_piece_bitboard(Piece::PAWN, cap_mask);
+        board._M_pieces[en_passant_cap_squ] = -1;
       }
       board.set_king_square(_M_side, move.piece() == Piece::KING ? move.to() : king_square(_M_side));
       board.set_king_square(opp_side, king_square(opp_side));
@@ -474,26 +674,22 @@ namespace peacockspider
       board._M_hash_key = _M_hash_key;
       board._M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(move.piece())][move.from()];
       board._M_hash_key ^= zobrist[side_to_index(_M_side)][dst_piece_idx][move.to()];
+      board._M_pawn_hash_key = _M_pawn_hash_key;
+      if(move.piece() == Piece::PAWN) {
+        board._M_pawn_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::PAWN)][move.from()];
+        if(move.promotion_piece() == PromotionPiece::NONE)
+          board._M_pawn_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::PAWN)][move.to()];
+      }
       if((color_bitboard(opp_side) & dst_bbd) != 0) {
-        Piece cap_piece;
-        if((piece_bitboard(Piece::PAWN) & dst_bbd) != 0)
-          cap_piece = Piece::PAWN;
-        else if((piece_bitboard(Piece::KNIGHT) & dst_bbd) != 0)
-          cap_piece = Piece::KNIGHT;
-        else if((piece_bitboard(Piece::BISHOP) & dst_bbd) != 0)
-          cap_piece = Piece::BISHOP;
-        else if((piece_bitboard(Piece::ROOK) & dst_bbd) != 0)
-          cap_piece = Piece::ROOK;
-        else if((piece_bitboard(Piece::QUEEN) & dst_bbd) != 0)
-          cap_piece = Piece::QUEEN;
-        else if((piece_bitboard(Piece::KING) & dst_bbd) != 0)
-          cap_piece = Piece::KING;
-        else
-          cap_piece = Piece::PAWN;
+        Piece cap_piece = piece(move.to());
         board._M_hash_key ^= zobrist[side_to_index(opp_side)][piece_to_index(cap_piece)][move.to()];
+        if(cap_piece == Piece::PAWN)
+          board._M_pawn_hash_key ^= zobrist[side_to_index(opp_side)][piece_to_index(Piece::PAWN)][move.to()];
       }
-      if(en_passant_cap_squ != -1)
+      if(en_passant_cap_squ != -1) {
         board._M_hash_key ^= zobrist[side_to_index(opp_side)][piece_to_index(Piece::PAWN)][en_passant_cap_squ];
+        board._M_pawn_hash_key ^= zobrist[side_to_index(opp_side)][piece_to_index(Piece::PAWN)][en_passant_cap_squ];
+      }
       board._M_hash_key ^= zobrist_white_side;
       board._M_hash_key ^= zobrist_castlings[side_to_index(_M_side)][side_castlings_to_index(side_castlings(_M_side))];
       board._M_hash_key ^= zobrist_castlings[side_to_index(_M_side)][side_castlings_to_index(board.side_castlings(_M_side))];
@@ -502,7 +698,160 @@ namespace peacockspider
       board._M_hash_key ^= zobrist_en_passant_column[_M_en_passant_column + 1];
       board._M_hash_key ^= zobrist_en_passant_column[board._M_en_passant_column + 1];
     }
-    return !board.in_check(_M_side);
+  }
+
+  void Board::do_move(Move move, UndoRecord &undo)
+  {
+    Side opp_side = ~_M_side;
+    Bitboard src_bbd = static_cast<Bitboard>(1) << move.from();
+    Bitboard dst_bbd = static_cast<Bitboard>(1) << move.to();
+    undo.captured_piece_pair = ((color_bitboard(opp_side) & dst_bbd) != 0 ? piece_pair(move.to()) : make_pair(Piece::PAWN, false));
+    undo.castlings[side_to_index(Side::WHITE)] = side_castlings(Side::WHITE);
+    undo.castlings[side_to_index(Side::BLACK)] = side_castlings(Side::BLACK);
+    undo.en_passant_column = _M_en_passant_column;
+    undo.halfmove_clock = _M_halfmove_clock;
+    undo.hash_key = _M_hash_key;
+    undo.pawn_hash_key = _M_pawn_hash_key;
+    _M_hash_key ^= zobrist_castlings[side_to_index(Side::WHITE)][side_castlings_to_index(side_castlings(Side::WHITE))];
+    _M_hash_key ^= zobrist_castlings[side_to_index(Side::BLACK)][side_castlings_to_index(side_castlings(Side::BLACK))];
+    _M_hash_key ^= zobrist_en_passant_column[_M_en_passant_column + 1];
+    if(move.piece() == Piece::KING && move.from() == (_M_side == Side::WHITE ? E1 : E8) && (move.to() == (_M_side == Side::WHITE ? G1 : G8) || move.to() == (_M_side == Side::WHITE ? C1 : C8))) {
+      bool is_short = (move.to() == (_M_side == Side::WHITE ? G1 : G8));
+      Square rook_src = (is_short ? (_M_side == Side::WHITE ? H1 : H8) : (_M_side == Side::WHITE ? A1 : A8));
+      Square rook_dst = (is_short ? (_M_side == Side::WHITE ? F1 : F8) : (_M_side == Side::WHITE ? D1 : D8));
+      Bitboard rook_bbd = (static_cast<Bitboard>(1) << rook_src) | (static_cast<Bitboard>(1) << rook_dst);
+      _M_color_bitboards[side_to_index(_M_side)] ^= src_bbd | dst_bbd | rook_bbd;
+      _M_piece_bitboards[piece_to_index(Piece::KING)] ^= src_bbd | dst_bbd;
+      _M_piece_bitboards[piece_to_index(Piece::ROOK)] ^= rook_bbd;
+      _M_pieces[move.from()] = -1;
+      _M_pieces[move.to()] = static_cast<int8_t>(piece_to_index(Piece::KING));
+      _M_pieces[rook_src] = -1;
+      _M_pieces[rook_dst] = static_cast<int8_t>(piece_to_index(Piece::ROOK));
+      _M_king_squares[side_to_index(_M_side)] = move.to();
+      set_side_castlings(_M_side, SideCastlings::NONE);
+      _M_en_passant_column = -1;
+      _M_halfmove_clock++;
+      _M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::KING)][move.from()];
+      _M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::KING)][move.to()];
+      _M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::ROOK)][rook_src];
+      _M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::ROOK)][rook_dst];
+    } else {
+      bool is_cap = undo.captured_piece_pair.second;
+      if(is_cap) {
+        _M_color_bitboards[side_to_index(opp_side)] &= ~dst_bbd;
+        _M_piece_bitboards[piece_to_index(undo.captured_piece_pair.first)] &= ~dst_bbd;
+        _M_hash_key ^= zobrist[side_to_index(opp_side)][piece_to_index(undo.captured_piece_pair.first)][move.to()];
+        if(undo.captured_piece_pair.first == Piece::PAWN)
+          _M_pawn_hash_key ^= zobrist[side_to_index(opp_side)][piece_to_index(Piece::PAWN)][move.to()];
+        if(undo.captured_piece_pair.first == Piece::ROOK) {
+          if(move.to() == (_M_side == Side::WHITE ? H8 : H1))
+            set_side_castlings(opp_side, side_castlings(opp_side) & ~SideCastlings::SHORT);
+          else if(move.to() == (_M_side == Side::WHITE ? A8 : A1))
+            set_side_castlings(opp_side, side_castlings(opp_side) & ~SideCastlings::LONG);
+        }
+      }
+      Square en_passant_squ = (_M_en_passant_column != -1 ? _M_en_passant_column + (_M_side == Side::WHITE ? 050 : 020) : -1);
+      if(move.piece() == Piece::PAWN && move.to() == en_passant_squ) {
+        is_cap = true;
+        Square en_passant_cap_squ = (_M_side == Side::WHITE ? move.to() - 8 : move.to() + 8);
+        Bitboard cap_mask = ~(static_cast<Bitboard>(1) << en_passant_cap_squ);
+        _M_color_bitboards[side_to_index(opp_side)] &= cap_mask;
+        _M_piece_bitboards[piece_to_index(Piece::PAWN)] &= cap_mask;
+        _M_pieces[en_passant_cap_squ] = -1;
+        _M_hash_key ^= zobrist[side_to_index(opp_side)][piece_to_index(Piece::PAWN)][en_passant_cap_squ];
+        _M_pawn_hash_key ^= zobrist[side_to_index(opp_side)][piece_to_index(Piece::PAWN)][en_passant_cap_squ];
+      }
+      size_t dst_piece_idx = (move.promotion_piece() == PromotionPiece::NONE ? piece_to_index(move.piece()) : promotion_piece_to_index(move.promotion_piece()));
+      _M_color_bitboards[side_to_index(_M_side)] ^= src_bbd | dst_bbd;
+      _M_piece_bitboards[piece_to_index(move.piece())] &= ~src_bbd;
+      _M_piece_bitboards[dst_piece_idx] |= dst_bbd;
+      _M_pieces[move.from()] = -1;
+      _M_pieces[move.to()] = static_cast<int8_t>(dst_piece_idx);
+      _M_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(move.piece())][move.from()];
+      _M_hash_key ^= zobrist[side_to_index(_M_side)][dst_piece_idx][move.to()];
+      if(move.piece() == Piece::PAWN) {
+        _M_pawn_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::PAWN)][move.from()];
+        if(move.promotion_piece() == PromotionPiece::NONE)
+          _M_pawn_hash_key ^= zobrist[side_to_index(_M_side)][piece_to_index(Piece::PAWN)][move.to()];
+      }
+      switch(move.piece()) {
+        case Piece::ROOK:
+          if(move.from() == (_M_side == Side::WHITE ? H1 : H8))
+            set_side_castlings(_M_side, side_castlings(_M_side) & ~SideCastlings::SHORT);
+          else if(move.from() == (_M_side == Side::WHITE ? A1 : A8))
+            set_side_castlings(_M_side, side_castlings(_M_side) & ~SideCastlings::LONG);
+          break;
+        case Piece::KING:
+          _M_king_squares[side_to_index(_M_side)] = move.to();
+          set_side_castlings(_M_side, SideCastlings::NONE);
+          break;
+        default:
+          break;
+      }
+      _M_en_passant_column = -1;
+      Row pawn_src_row2 = (_M_side == Side::WHITE ? 1 : 6);
+      Row pawn_dst_row2 = (_M_side == Side::WHITE ? 3 : 4);
+      if(move.piece() == Piece::PAWN && (move.from() >> 3) == pawn_src_row2 && (move.to() >> 3) == pawn_dst_row2) {
+        Square en_passant_squ2 = move.from() + (_M_side == Side::WHITE ? 8 : -8);
+        if((color_bitboard(opp_side) & piece_bitboard(Piece::PAWN) & tab_pawn_capture_bitboards[side_to_index(_M_side)][en_passant_squ2]) != 0)
+          _M_en_passant_column = move.from() & 7;
+      }
+      _M_halfmove_clock = ((!is_cap && move.piece() != Piece::PAWN) ? _M_halfmove_clock + 1 : 0);
+    }
+    _M_fullmove_number += (_M_side == Side::BLACK ? 1 : 0);
+    _M_side = opp_side;
+    _M_hash_key ^= zobrist_white_side;
+    _M_hash_key ^= zobrist_castlings[side_to_index(Side::WHITE)][side_castlings_to_index(side_castlings(Side::WHITE))];
+    _M_hash_key ^= zobrist_castlings[side_to_index(Side::BLACK)][side_castlings_to_index(side_castlings(Side::BLACK))];
+    _M_hash_key ^= zobrist_en_passant_column[_M_en_passant_column + 1];
+  }
+
+  void Board::undo_move(Move move, const UndoRecord &undo)
+  {
+    Side opp_side = _M_side;
+    _M_side = ~_M_side;
+    _M_fullmove_number -= (_M_side == Side::BLACK ? 1 : 0);
+    Bitboard src_bbd = static_cast<Bitboard>(1) << move.from();
+    Bitboard dst_bbd = static_cast<Bitboard>(1) << move.to();
+    if(move.piece() == Piece::KING && move.from() == (_M_side == Side::WHITE ? E1 : E8) && (move.to() == (_M_side == Side::WHITE ? G1 : G8) || move.to() == (_M_side == Side::WHITE ? C1 : C8))) {
+      bool is_short = (move.to() == (_M_side == Side::WHITE ? G1 : G8));
+      Square rook_src = (is_short ? (_M_side == Side::WHITE ? H1 : H8) : (_M_side == Side::WHITE ? A1 : A8));
+      Square rook_dst = (is_short ? (_M_side == Side::WHITE ? F1 : F8) : (_M_side == Side::WHITE ? D1 : D8));
+      Bitboard rook_bbd = (static_cast<Bitboard>(1) << rook_src) | (static_cast<Bitboard>(1) << rook_dst);
+      _M_color_bitboards[side_to_index(_M_side)] ^= src_bbd | dst_bbd | rook_bbd;
+      _M_piece_bitboards[piece_to_index(Piece::KING)] ^= src_bbd | dst_bbd;
+      _M_piece_bitboards[piece_to_index(Piece::ROOK)] ^= rook_bbd;
+      _M_pieces[move.from()] = static_cast<int8_t>(piece_to_index(Piece::KING));
+      _M_pieces[move.to()] = -1;
+      _M_pieces[rook_src] = static_cast<int8_t>(piece_to_index(Piece::ROOK));
+      _M_pieces[rook_dst] = -1;
+      _M_king_squares[side_to_index(_M_side)] = move.from();
+    } else {
+      size_t dst_piece_idx = (move.promotion_piece() == PromotionPiece::NONE ? piece_to_index(move.piece()) : promotion_piece_to_index(move.promotion_piece()));
+      _M_color_bitboards[side_to_index(_M_side)] ^= src_bbd | dst_bbd;
+      _M_piece_bitboards[dst_piece_idx] &= ~dst_bbd;
+      _M_piece_bitboards[piece_to_index(move.piece())] |= src_bbd;
+      _M_pieces[move.from()] = static_cast<int8_t>(piece_to_index(move.piece()));
+      _M_pieces[move.to()] = -1;
+      if(undo.captured_piece_pair.second) {
+        _M_color_bitboards[side_to_index(opp_side)] |= dst_bbd;
+        _M_piece_bitboards[piece_to_index(undo.captured_piece_pair.first)] |= dst_bbd;
+        _M_pieces[move.to()] = static_cast<int8_t>(piece_to_index(undo.captured_piece_pair.first));
+      } else if(move.piece() == Piece::PAWN && (move.from() & 7) != (move.to() & 7)) {
+        Square cap_squ = (_M_side == Side::WHITE ? move.to() - 8 : move.to() + 8);
+        Bitboard cap_bbd = static_cast<Bitboard>(1) << cap_squ;
+        _M_color_bitboards[side_to_index(opp_side)] |= cap_bbd;
+        _M_piece_bitboards[piece_to_index(Piece::PAWN)] |= cap_bbd;
+        _M_pieces[cap_squ] = static_cast<int8_t>(piece_to_index(Piece::PAWN));
+      }
+      if(move.piece() == Piece::KING) _M_king_squares[side_to_index(_M_side)] = move.from();
+    }
+    set_side_castlings(Side::WHITE, undo.castlings[side_to_index(Side::WHITE)]);
+    set_side_castlings(Side::BLACK, undo.castlings[side_to_index(Side::BLACK)]);
+    _M_en_passant_column = undo.en_passant_column;
+    _M_halfmove_clock = undo.halfmove_clock;
+    _M_hash_key = undo.hash_key;
+    _M_pawn_hash_key = undo.pawn_hash_key;
   }
 
   void Board::make_null_move(Board &board) const
@@ -515,6 +864,7 @@ namespace peacockspider
     board.set_piece_bitboard(Piece::ROOK, piece_bitboard(Piece::ROOK));
     board.set_piece_bitboard(Piece::QUEEN, piece_bitboard(Piece::QUEEN));
     board.set_piece_bitboard(Piece::KING, piece_bitboard(Piece::KING));
+    copy(_M_pieces, _M_pieces + 64, board._M_pieces);
     board.set_king_square(Side::WHITE, king_square(Side::WHITE));
     board.set_king_square(Side::BLACK, king_square(Side::BLACK));
     board._M_side = ~_M_side;
@@ -524,16 +874,94 @@ namespace peacockspider
     board._M_halfmove_clock = _M_halfmove_clock;
     board._M_fullmove_number = _M_fullmove_number + (_M_side == Side::BLACK ? 1 : 0);
     board._M_hash_key = _M_hash_key;
+    board._M_pawn_hash_key = _M_pawn_hash_key;
     board._M_hash_key ^= zobrist_white_side;
     board._M_hash_key ^= zobrist_en_passant_column[_M_en_passant_column + 1];
     board._M_hash_key ^= zobrist_en_passant_column[board._M_en_passant_column + 1];
   }
   
-  bool Board::has_legal_move(Move move) const
+  void Board::do_null_move(UndoRecord &undo)
   {
-    Board tmp_board;
-    return make_move(move, tmp_board);
+    undo.captured_piece_pair = make_pair(Piece::PAWN, false);
+    undo.castlings[side_to_index(Side::WHITE)] = side_castlings(Side::WHITE);
+    undo.castlings[side_to_index(Side::BLACK)] = side_castlings(Side::BLACK);
+    undo.en_passant_column = _M_en_passant_column;
+    undo.halfmove_clock = _M_halfmove_clock;
+    undo.hash_key = _M_hash_key;
+    undo.pawn_hash_key = _M_pawn_hash_key;
+    _M_fullmove_number += (_M_side == Side::BLACK ? 1 : 0);
+    _M_side = ~_M_side;
+    _M_hash_key ^= zobrist_white_side;
+    _M_hash_key ^= zobrist_en_passant_column[_M_en_passant_column + 1];
+    _M_en_passant_column = -1;
+    _M_hash_key ^= zobrist_en_passant_column[_M_en_passant_column + 1];
+  }
+
+  void Board::undo_null_move(const UndoRecord &undo)
+  {
+    _M_side = ~_M_side;
+    _M_fullmove_number -= (_M_side == Side::BLACK ? 1 : 0);
+    _M_en_passant_column = undo.en_passant_column;
+    _M_hash_key = undo.hash_key;
   }
+
+  bool Board::has_legal_move(Move move, Bitboard checker_bbd, Bitboard pinned_bbd) const
+  {
+    Square king_squ = king_square(_M_side);
+    Bitboard occupied = color_bitboard(Side::WHITE) | color_bitboard(Side::BLACK);
+    Bitboard from_bbd = static_cast<Bitboard>(1) << move.from();
+    Bitboard to_bbd = static_cast<Bitboard>(1) << move.to();
+    if(move.piece() == Piece::KING) {
+      if(move.from() == (_M_side == Side::WHITE ? E1 : E8) && (move.to() == (_M_side == Side::WHITE ? G1 : G8) || move.to() == (_M_side == Side::WHITE ? C1 : C8))) {
+        if(checker_bbd != 0) return false;
+        return !has_attack(_M_side, (move.from() + move.to()) >> 1) && !has_attack(_M_side, move.to());
+      }
+      return attacker_bitboard(_M_side, move.to(), occupied & ~from_bbd) == 0;
+    }
+    // Only the king can move for the double check.
+    if((checker_bbd & (checker_bbd - 1)) != 0) return false;
+    if(move.piece() == Piece::PAWN && (move.from() & 7) != (move.to() & 7) && has_empty(move.to())) {
+      // The en passant capture removes two pieces from one line so it is checked on the new occupied squares.
+      Bitboard cap_bbd = static_cast<Bitboard>(1) << (move.to() + (_M_side == Side::WHITE ? -8 : 8));
+      return attacker_bitboard(_M_side, king_squ, (occupied & ~from_bbd & ~cap_bbd) | to_bbd) == 0;
+    }
+    if(checker_bbd != 0 && ((tab_between_bitboards[king_squ][__builtin_ctzll(checker_bbd)] | checker_bbd) & to_bbd) == 0) return false;
+    if((pinned_bbd & from_bbd) != 0 && (tab_line_bitboards[king_squ][move.from()] & to_bbd) == 0) return false;
+    return true;
+  }
+
+  void Board::filter_legal_moves(MovePairList &move_pairs) const
+  {
+    Bitboard checker_bbd = checker_bitboard();
+    Bitboard pinned_bbd = pinned_piece_bitboard();
+    size_t length = move_pairs.length();
+    move_pairs.clear();
+    for(size_t i = 0; i < length; i++) {
+      MovePair move_pair = move_pairs[i];
+      if(has_legal_move(move_pair.move, checker_bbd, pinned_bbd)) move_pairs.add_move_pair(move_pair);
+    }
+  }
+
+  void Board::generate_legal_moves(MovePairList &move_pairs) const
+  {
+    generate_pseudolegal_moves(move_pairs);
+    filter_legal_moves(move_pairs);
+  }
+
+  void Board::generate_legal_good_moves(MovePairList &move_pairs) const
+  {
+    generate_pseudolegal_good_moves(move_pairs);
+    filter_legal_moves(move_pairs);
+  }
+
+  void Board::generate_legal_quiet_moves(MovePairList &move_pairs) const
+  {
+    generate_pseudolegal_quiet_moves(move_pairs);
+    filter_legal_moves(move_pairs);
+  }
+
+  bool Board::has_legal_move(Move move) const
+  { return has_legal_move(move, checker_bitboard(), pinned_piece_bitboard()); }
   
   bool Board::has_legal_move_for_tt(Move move) const
   { return has_color_piece(_M_side, move.piece(), move.from()) && (has_color(~_M_side, move.to()) || has_empty(move.to())); }
@@ -541,11 +969,8 @@ namespace peacockspider
   bool Board::in_checkmate(MovePairList &move_pairs) const
   {
     if(in_check()) {
-      generate_pseudolegal_moves(move_pairs);
-      for(size_t i = 0; i < move_pairs.length(); i++) {
-        if(has_legal_move(move_pairs[i].move)) return false;
-      }
-      return true;
+      generate_legal_moves(move_pairs);
+      return move_pairs.length() == 0;
     } else
       return false;
   }
@@ -553,11 +978,8 @@ namespace peacockspider
   bool Board::in_stalemate(MovePairList &move_pairs) const
   {
     if(!in_check()) {
-      generate_pseudolegal_moves(move_pairs);
-      for(size_t i = 0; i < move_pairs.length(); i++) {
-        if(has_legal_move(move_pairs[i].move)) return false;
-      }
-      return true;
+      generate_legal_moves(move_pairs);
+      return move_pairs.length() == 0;
     } else
       return false;
   }
@@ -15,6 +15,7 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
 #include <cctype>
 #include <iomanip>
 #include "chess.hpp"
@@ -202,32 +203,91 @@ namespace peacockspider
   }
 
   size_t repetitions(const Board &board, const vector<Board> &boards)
+  { return repetitions(board, boards, nullptr); }
+
+  size_t repetitions(const Board &board, const vector<Board> &boards, const Board *last_board)
   {
+    // The boards before the last irreversible move can't be repeated.
     size_t count = 0;
+    if(last_board != nullptr) {
+      if(board.hash_key() == last_board->hash_key() && board.equal_for_repetitions(*last_board)) count++;
+      if(last_board->halfmove_clock() == 0) return count;
+    }
     for(size_t i = boards.size(); i > 0; i--) {
-      if(board.equal_for_repetitions(boards[i - 1])) count++;
+      if(board.hash_key() == boards[i - 1].hash_key() && board.equal_for_repetitions(boards[i - 1])) count++;
+      if(boards[i - 1].halfmove_clock() == 0) break;
     }
     return count;
   }
 
-  size_t repetitions(const Board &board, const vector<Board> &boards, const Board *last_board)
+  HashKeyHistory::HashKeyHistory(size_t max_ply_count) :
+    _M_root_index(0), _M_max_ply_count(max_ply_count)
   {
-    size_t count = 0;
-    if(last_board != nullptr && board.equal_for_repetitions(*last_board)) count++;
-    for(size_t i = boards.size(); i > 0; i--) {
-      if(board.equal_for_repetitions(boards[i - 1])) count++;
+    _M_hash_keys.resize(max_ply_count + 1);
+    _M_first_indices.resize(max_ply_count + 1, 0);
+    _M_null_move_flags.resize(max_ply_count + 1, false);
+  }
+
+  void HashKeyHistory::set_root(const vector<Board> &boards, const Board *last_board)
+  {
+    size_t board_count = boards.size() + (last_board != nullptr ? 1 : 0);
+    if(board_count == 0) {
+      _M_hash_keys.assign(_M_max_ply_count + 1, 0);
+      _M_first_indices.assign(_M_max_ply_count + 1, 0);
+      _M_null_move_flags.assign(_M_max_ply_count + 1, false);
+      _M_root_index = 0;
+      return;
     }
-    return count;
+    const Board &root_board = (last_board != nullptr ? *last_board : boards.back());
+    // Only positions since the last irreversible move can be repeated.
+    size_t count = min(static_cast<size_t>(root_board.halfmove_clock()) + 1, board_count);
+    _M_hash_keys.resize(count + _M_max_ply_count);
+    _M_first_indices.assign(count + _M_max_ply_count, 0);
+    _M_null_move_flags.assign(count + _M_max_ply_count, false);
+    size_t j = 0;
+    for(size_t i = board_count - count; i < boards.size(); i++, j++) {
+      _M_hash_keys[j] = boards[i].hash_key();
+    }
+    if(last_board != nullptr) _M_hash_keys[j] = last_board->hash_key();
+    _M_root_index = count - 1;
+  }
+
+  void HashKeyHistory::copy_plies(const HashKeyHistory &history, int ply)
+  {
+    // Both histories must have the same root, so only the plies after the root are copied. The
+    // null move flags of the copied plies aren't used by the next plies, so they are cleared.
+    size_t begin = _M_root_index + 1;
+    size_t end = _M_root_index + ply + 1;
+    copy(history._M_hash_keys.begin() + begin, history._M_hash_keys.begin() + end, _M_hash_keys.begin() + begin);
+    copy(history._M_first_indices.begin() + begin, history._M_first_indices.begin() + end, _M_first_indices.begin() + begin);
+    fill(_M_null_move_flags.begin() + begin, _M_null_move_flags.end(), false);
+  }
+
+  size_t HashKeyHistory::repetitions(int ply, int halfmove_clock) const
+  {
+    size_t i = _M_root_index + ply;
+    HashKey hash_key = _M_hash_keys[i];
+    size_t count = min(static_cast<size_t>(halfmove_clock), i - _M_first_indices[i]);
+    size_t repetition_count = 0;
+    for(size_t j = 4; j <= count; j += 2) {
+      if(_M_hash_keys[i - j] == hash_key) repetition_count++;
+    }
+    return repetition_count;
   }
 
   Result result_for_boards(const vector<Board> &boards, MovePairList &move_pairs)
   {
-    if(!boards.empty() && boards.back().in_checkmate(move_pairs)) {
+    bool has_legal_moves = true;
+    if(!boards.empty()) {
+      boards.back().generate_legal_moves(move_pairs);
+      has_legal_moves = (move_pairs.length() != 0);
+    }
+    if(!has_legal_moves && boards.back().in_check()) {
       if(boards.back().side() == Side::WHITE)
         return Result::BLACK_WIN;
       else
         return Result::WHITE_WIN;
-    } else if(!boards.empty() && boards.back().in_stalemate(move_pairs)) {
+    } else if(!has_legal_moves) {
       return Result::DRAW;
     } else if(!boards.empty() && boards.back().halfmove_clock() >= 100) {
       return Result::DRAW;
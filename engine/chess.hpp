@@ -18,6 +18,7 @@
 #ifndef _CHESS_HPP
 #define _CHESS_HPP
 
+#include <algorithm>
 #include <cstddef>
 #include <ostream>
 #include <string>
@@ -428,10 +429,21 @@ namespace peacockspider
     { return MovePairList(_M_move_pairs + _M_length, 0); } 
   };
 
+  struct UndoRecord
+  {
+    std::pair<Piece, bool> captured_piece_pair;
+    SideCastlings castlings[2];
+    Column en_passant_column;
+    int halfmove_clock;
+    HashKey hash_key;
+    HashKey pawn_hash_key;
+  };
+
   class Board
   {
     Bitboard _M_color_bitboards[2];
     Bitboard _M_piece_bitboards[6];
+    std::int8_t _M_pieces[64];
     int _M_king_squares[2];
     Side _M_side;
     SideCastlings _M_castlings[2];
@@ -439,6 +451,7 @@ namespace peacockspider
     int _M_halfmove_clock;
     int _M_fullmove_number;
     HashKey _M_hash_key;
+    HashKey _M_pawn_hash_key;
   public:
     Board();
 
@@ -473,7 +486,8 @@ namespace peacockspider
 
     Bitboard piece_bitboard(Piece piece) const
     { return _M_piece_bitboards[piece_to_index(piece)]; }
-
+  private:
+    // These mutators don't update the pieces of squares, so only the board uses them.
     void set_piece_bitboard(Piece piece, Bitboard bbd)
     { _M_piece_bitboards[piece_to_index(piece)] = bbd; }
 
@@ -488,7 +502,7 @@ namespace peacockspider
 
     void or_piece_bitboard(PromotionPiece promotion_piece, Bitboard bbd)
     { _M_piece_bitboards[promotion_piece_to_index(promotion_piece)] |= bbd; }
-
+  public:
     Square king_square(Side side) const
     { return _M_king_squares[side_to_index(side)]; }
     
@@ -528,7 +542,14 @@ namespace peacockspider
     HashKey hash_key() const
     { return _M_hash_key; }
 
+    HashKey pawn_hash_key() const
+    { return _M_pawn_hash_key; }
+
     void update_hash_key();
+
+    void update_pieces();
+
+    bool has_consistent_pieces() const;
     
     bool has_color(Side side, Square squ) const
     { return (_M_color_bitboards[side_to_index(side)] & (static_cast<Bitboard>(1) << squ)) != 0; }
@@ -572,18 +593,8 @@ namespace peacockspider
     
     std::pair<Piece, bool> piece_pair(Square squ) const
     {
-      if((_M_piece_bitboards[piece_to_index(Piece::PAWN)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return std::make_pair(Piece::PAWN, true);
-      else if((_M_piece_bitboards[piece_to_index(Piece::KNIGHT)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return std::make_pair(Piece::KNIGHT, true);
-      else if((_M_piece_bitboards[piece_to_index(Piece::BISHOP)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return std::make_pair(Piece::BISHOP, true);
-      else if((_M_piece_bitboards[piece_to_index(Piece::ROOK)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return std::make_pair(Piece::ROOK, true);
-      else if((_M_piece_bitboards[piece_to_index(Piece::QUEEN)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return std::make_pair(Piece::QUEEN, true);
-      else if((_M_piece_bitboards[piece_to_index(Piece::KING)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return std::make_pair(Piece::KING, true);
+      if(_M_pieces[squ] != -1)
+        return std::make_pair(static_cast<Piece>(_M_pieces[squ]), true);
       else
         return std::make_pair(Piece::PAWN, false);
     }
@@ -597,25 +608,11 @@ namespace peacockspider
       _M_piece_bitboards[piece_to_index(Piece::QUEEN)] &= ~(static_cast<Bitboard>(1) << squ);
       _M_piece_bitboards[piece_to_index(Piece::KING)] &= ~(static_cast<Bitboard>(1) << squ);
       if(piece_pair.second) _M_piece_bitboards[piece_to_index(piece_pair.first)] |= static_cast<Bitboard>(1) << squ;
+      _M_pieces[squ] = (piece_pair.second ? static_cast<std::int8_t>(piece_to_index(piece_pair.first)) : -1);
     }
 
     Piece piece(Square squ) const
-    {
-      if((_M_piece_bitboards[piece_to_index(Piece::PAWN)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return Piece::PAWN;
-      else if((_M_piece_bitboards[piece_to_index(Piece::KNIGHT)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return Piece::KNIGHT;
-      else if((_M_piece_bitboards[piece_to_index(Piece::BISHOP)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return Piece::BISHOP;
-      else if((_M_piece_bitboards[piece_to_index(Piece::ROOK)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return Piece::ROOK;
-      else if((_M_piece_bitboards[piece_to_index(Piece::QUEEN)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return Piece::QUEEN;
-      else if((_M_piece_bitboards[piece_to_index(Piece::KING)] & (static_cast<Bitboard>(1) << squ)) != 0)
-        return Piece::KING;
-      else
-        return Piece::PAWN;
-    }
+    { return _M_pieces[squ] != -1 ? static_cast<Piece>(_M_pieces[squ]) : Piece::PAWN; }
 
     void set_piece(Square squ, Piece piece)
     {
@@ -626,6 +623,7 @@ namespace peacockspider
       _M_piece_bitboards[piece_to_index(Piece::QUEEN)] &= ~(static_cast<Bitboard>(1) << squ);
       _M_piece_bitboards[piece_to_index(Piece::KING)] &= ~(static_cast<Bitboard>(1) << squ);
       _M_piece_bitboards[piece_to_index(piece)] |= static_cast<Bitboard>(1) << squ;
+      _M_pieces[squ] = static_cast<std::int8_t>(piece_to_index(piece));
     }
 
     void unset_piece(Square squ)
@@ -636,6 +634,7 @@ namespace peacockspider
       _M_piece_bitboards[piece_to_index(Piece::ROOK)] &= ~(static_cast<Bitboard>(1) << squ);
       _M_piece_bitboards[piece_to_index(Piece::QUEEN)] &= ~(static_cast<Bitboard>(1) << squ);
       _M_piece_bitboards[piece_to_index(Piece::KING)] &= ~(static_cast<Bitboard>(1) << squ);
+      _M_pieces[squ] = -1;
     }
 
     bool has_color_piece(Side side, Piece piece, Square squ) const
@@ -651,15 +650,48 @@ namespace peacockspider
 
     bool in_check(Side side) const
     { return has_attack(side, _M_king_squares[side_to_index(side)]); }
+
+    Bitboard attacker_bitboard(Side side, Square squ, Bitboard occupied) const;
+
+    Bitboard checker_bitboard() const
+    { return attacker_bitboard(_M_side, _M_king_squares[side_to_index(_M_side)], _M_color_bitboards[0] | _M_color_bitboards[1]); }
+
+    Bitboard pinned_piece_bitboard() const;
+
+    int see(Move move, const int *piece_values) const;
     
     void generate_pseudolegal_moves(MovePairList &move_pairs) const;
 
     void generate_pseudolegal_good_moves(MovePairList &move_pairs) const;
 
+    void generate_pseudolegal_quiet_moves(MovePairList &move_pairs) const;
+
+    bool has_pseudolegal_move(Move move) const;
+  private:
+    bool has_legal_move(Move move, Bitboard checker_bbd, Bitboard pinned_bbd) const;
+
+    void filter_legal_moves(MovePairList &move_pairs) const;
+  public:
+    void generate_legal_moves(MovePairList &move_pairs) const;
+
+    void generate_legal_good_moves(MovePairList &move_pairs) const;
+
+    void generate_legal_quiet_moves(MovePairList &move_pairs) const;
+
     bool make_move(Move move, Board &board) const;
 
+    void unsafely_make_move(Move move, Board &board) const;
+
+    void do_move(Move move, UndoRecord &undo);
+
+    void undo_move(Move move, const UndoRecord &undo);
+
     void make_null_move(Board &board) const;
 
+    void do_null_move(UndoRecord &undo);
+
+    void undo_null_move(const UndoRecord &undo);
+
     bool has_legal_move(Move move) const;
     
     bool has_legal_move_for_tt(Move move) const;
@@ -675,6 +707,48 @@ namespace peacockspider
     std::string to_string() const;
   };
   
+  class HashKeyHistory
+  {
+    std::vector<HashKey> _M_hash_keys;
+    std::vector<std::size_t> _M_first_indices;
+    std::vector<bool> _M_null_move_flags;
+    std::size_t _M_root_index;
+    std::size_t _M_max_ply_count;
+  public:
+    explicit HashKeyHistory(std::size_t max_ply_count);
+
+    void set_root(const std::vector<Board> &boards, const Board *last_board);
+
+    HashKey hash_key(int ply) const
+    { return _M_hash_keys[_M_root_index + ply]; }
+
+    void set_hash_key(int ply, HashKey hash_key)
+    {
+      std::size_t i = _M_root_index + ply;
+      _M_hash_keys[i] = hash_key;
+      // A position after the null move can't repeat a position before the null move.
+      _M_first_indices[i] = (_M_null_move_flags[i] || i == 0 ? i : _M_first_indices[i - 1]);
+    }
+
+    void set_null_move_flag(int ply, bool flag)
+    { _M_null_move_flags[_M_root_index + ply] = flag; }
+
+    void copy_plies(const HashKeyHistory &history, int ply);
+
+    std::size_t repetitions(int ply, int halfmove_clock) const;
+
+    bool has_repetition(int ply, int halfmove_clock) const
+    {
+      std::size_t i = _M_root_index + ply;
+      HashKey hash_key = _M_hash_keys[i];
+      std::size_t count = std::min(static_cast<std::size_t>(halfmove_clock), i - _M_first_indices[i]);
+      for(std::size_t j = 4; j <= count; j += 2) {
+        if(_M_hash_keys[i - j] == hash_key) return true;
+      }
+      return false;
+    }
+  };
+
   struct PrefixAndBoard
   {
     const std::string &prefix;
@@ -29,7 +29,7 @@ namespace peacockspider
     _M_thread_command(ThreadCommand::NO_COMMAND),
     _M_mode(Mode::GAME),
     _M_previous_mode(Mode::GAME),
-    _M_thinking_output_function([](int depth, int value, unsigned ms, const Searcher *searcher, const Board *board, const Move *move) {}),
+    _M_thinking_output_function([](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher, const Board *board, const Move *move) {}),
     _M_move_output_function([](const Board &board, Move move, const Move *pondering_move) {}),
     _M_result_output_function([](Result result, const string &comment) {}),
     _M_board_output_function([](const Board &board) {}),
@@ -110,13 +110,13 @@ namespace peacockspider
     _M_thread.join();
   }
 
-  function<void (int, int, unsigned, const Searcher *, const Board *, const Move *)> Engine::thinking_output_function()
+  function<void (int, int, ValueType, unsigned, const Searcher *, const Board *, const Move *)> Engine::thinking_output_function()
   {
     unique_lock<mutex> lock(_M_mutex);
     return _M_thinking_output_function;
   }
   
-  void Engine::set_thinking_output_function(function<void (int, int, unsigned, const Searcher *, const Board *, const Move *)> fun)
+  void Engine::set_thinking_output_function(function<void (int, int, ValueType, unsigned, const Searcher *, const Board *, const Move *)> fun)
   {
     unique_lock<mutex> lock(_M_mutex);
     _M_thinking_output_function = fun;
@@ -173,6 +173,85 @@ namespace peacockspider
     _M_result_comment = "";
   }
 
+  void Engine::set_pawn_table_entry_count(size_t count)
+  {
+    _M_thinker->stop_pondering();
+    unique_lock<mutex> lock(_M_mutex);
+    _M_thinker->set_pawn_table_entry_count(count);
+  }
+
+  bool Engine::get_transposition_table_entry_count(size_t &count)
+  {
+    _M_thinker->stop_pondering();
+    unique_lock<mutex> lock(_M_mutex);
+    count = _M_thinker->transposition_table_entry_count();
+    return count > 0;
+  }
+
+  void Engine::set_transposition_table_entry_count(size_t count)
+  {
+    _M_thinker->stop_pondering();
+    unique_lock<mutex> lock(_M_mutex);
+    _M_thinker->set_transposition_table_entry_count(count);
+  }
+
+  bool Engine::get_thread_count(unsigned &thread_count)
+  {
+    _M_thinker->stop_pondering();
+    unique_lock<mutex> lock(_M_mutex);
+    thread_count = _M_thinker->thread_count();
+    return _M_thinker->can_set_thread_count();
+  }
+
+  void Engine::set_thread_count(unsigned thread_count)
+  {
+    _M_thinker->stop_pondering();
+    unique_lock<mutex> lock(_M_mutex);
+    _M_thinker->set_thread_count(thread_count);
+  }
+
+  bool Engine::save_transposition_table(const string &file_name)
+  {
+    _M_thinker->stop_pondering();
+    unique_lock<mutex> lock(_M_mutex);
+    return _M_thinker->save_transposition_table(file_name);
+  }
+
+  bool Engine::load_transposition_table(const string &file_name)
+  {
+    _M_thinker->stop_pondering();
+    unique_lock<mutex> lock(_M_mutex);
+    return _M_thinker->load_transposition_table(file_name);
+  }
+
+  void Engine::get_late_move_reduction_table(LateMoveReductionTable &table)
+  {
+    _M_thinker->stop_pondering();
+    unique_lock<mutex> lock(_M_mutex);
+    table = _M_thinker->late_move_reduction_table();
+  }
+
+  void Engine::set_late_move_reduction_table(const LateMoveReductionTable &table)
+  {
+    _M_thinker->stop_pondering();
+    unique_lock<mutex> lock(_M_mutex);
+    _M_thinker->set_late_move_reduction_table(table);
+  }
+
+  void Engine::get_pruning_flags(PruningFlags &flags)
+  {
+    _M_thinker->stop_pondering();
+    unique_lock<mutex> lock(_M_mutex);
+    flags = _M_thinker->pruning_flags();
+  }
+
+  void Engine::set_pruning_flags(const PruningFlags &flags)
+  {
+    _M_thinker->stop_pondering();
+    unique_lock<mutex> lock(_M_mutex);
+    _M_thinker->set_pruning_flags(flags);
+  }
+
   void Engine::set_level(unsigned mps, unsigned base, unsigned inc)
   {
     unique_lock<mutex> lock(_M_limit_mutex);
@@ -377,6 +456,14 @@ namespace peacockspider
     return true;
   }
 
+  bool Engine::get_stop_latency(unsigned &latency)
+  {
+    unique_lock<mutex> lock(_M_hint_move_mutex);
+    if(!_M_thinker->has_stop_latency()) return false;
+    latency = _M_thinker->stop_latency();
+    return true;
+  }
+
   void Engine::set_result(Result result, const string &comment)
   {
     _M_thinker->stop_pondering();
@@ -529,7 +616,9 @@ namespace peacockspider
   void Engine::unsafely_set_result_for_boards()
   {
     MovePairList move_pairs(_M_move_pairs.get(), 0);
-    if(_M_boards.back().in_checkmate(move_pairs)) {
+    _M_boards.back().generate_legal_moves(move_pairs);
+    bool has_legal_moves = (move_pairs.length() != 0);
+    if(!has_legal_moves && _M_boards.back().in_check()) {
       if(_M_boards.back().side() == Side::WHITE) {
         _M_result = Result::BLACK_WIN;
         _M_result_comment = "Black mates";
@@ -537,7 +626,7 @@ namespace peacockspider
         _M_result = Result::WHITE_WIN;
         _M_result_comment = "White mates";
       }
-    } else if(_M_boards.back().in_stalemate(move_pairs)) {
+    } else if(!has_legal_moves) {
       _M_result = Result::DRAW;
       _M_result_comment = "Stalemate";
     } else if(_M_boards.back().halfmove_clock() >= 100) {
@@ -606,13 +695,13 @@ namespace peacockspider
     }
     {
       unique_lock<mutex> hint_move_lock(_M_hint_move_mutex);
-      _M_thinker->think(depth, time, search_moves, nodes, checkmate_move_count, best_move, _M_boards, [this](int depth, int value, unsigned ms, const Searcher *searcher) {
+      _M_thinker->think(depth, time, search_moves, nodes, checkmate_move_count, best_move, _M_boards, [this](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
         bool thinking_output_flag = false;
         {
           unique_lock<mutex> other_lock(_M_other_mutex);
           thinking_output_flag = _M_thinking_output_flag;
         }
-        if(thinking_output_flag) _M_thinking_output_function(depth, value, ms, searcher, nullptr, nullptr);
+        if(thinking_output_flag) _M_thinking_output_function(depth, value, value_type, ms, searcher, nullptr, nullptr);
       });
     }
     if(_M_mode != Mode::ANALYSIS && best_move.to() != -1) {
@@ -641,7 +730,7 @@ namespace peacockspider
       if(!_M_thinker->has_hint_move()) return;
       _M_thinker->set_pondering_move();
     }
-    _M_thinker->ponder(depth, search_moves, nodes, checkmate_move_count, _M_boards, [this, pondering_move_flag](int depth, int value, unsigned ms, const Searcher *searcher) {
+    _M_thinker->ponder(depth, search_moves, nodes, checkmate_move_count, _M_boards, [this, pondering_move_flag](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
       bool thinking_output_flag = false;
       {
         unique_lock<mutex> other_lock(_M_other_mutex);
@@ -651,7 +740,7 @@ namespace peacockspider
         Move tmp_pondering_move = (pondering_move_flag ? _M_thinker->pondering_move() : Move());
         const Board *pondering_board = (pondering_move_flag ? &(_M_boards.back()) : nullptr); 
         const Move *pondering_move = (pondering_move_flag ? &tmp_pondering_move : nullptr); 
-        _M_thinking_output_function(depth, value, ms, searcher, pondering_board, pondering_move);
+        _M_thinking_output_function(depth, value, value_type, ms, searcher, pondering_board, pondering_move);
       }
     }, pondering_move_flag);
   }
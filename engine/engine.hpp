@@ -70,7 +70,7 @@ namespace peacockspider
     ThreadCommand _M_thread_command;
     Mode _M_mode;
     Mode _M_previous_mode;
-    std::function<void (int, int, unsigned, const Searcher *, const Board *, const Move *move)> _M_thinking_output_function;
+    std::function<void (int, int, ValueType, unsigned, const Searcher *, const Board *, const Move *move)> _M_thinking_output_function;
     std::function<void (const Board &, Move, const Move *)> _M_move_output_function;
     std::function<void (Result, const std::string &)> _M_result_output_function;
     std::function<void (const Board &)> _M_board_output_function;
@@ -103,9 +103,9 @@ namespace peacockspider
 
     ~Engine();
 
-    std::function<void (int, int, unsigned, const Searcher *, const Board *, const Move *)> thinking_output_function();
+    std::function<void (int, int, ValueType, unsigned, const Searcher *, const Board *, const Move *)> thinking_output_function();
 
-    void set_thinking_output_function(std::function<void (int, int, unsigned, const Searcher *, const Board *, const Move *)> fun);
+    void set_thinking_output_function(std::function<void (int, int, ValueType, unsigned, const Searcher *, const Board *, const Move *)> fun);
 
     std::function<void (const Board &, Move, const Move *)> move_output_function();
 
@@ -121,6 +121,28 @@ namespace peacockspider
     
     void new_game();
 
+    void set_pawn_table_entry_count(std::size_t count);
+
+    bool get_transposition_table_entry_count(std::size_t &count);
+
+    void set_transposition_table_entry_count(std::size_t count);
+
+    bool get_thread_count(unsigned &thread_count);
+
+    void set_thread_count(unsigned thread_count);
+
+    bool save_transposition_table(const std::string &file_name);
+
+    bool load_transposition_table(const std::string &file_name);
+
+    void get_late_move_reduction_table(LateMoveReductionTable &table);
+
+    void set_late_move_reduction_table(const LateMoveReductionTable &table);
+
+    void get_pruning_flags(PruningFlags &flags);
+
+    void set_pruning_flags(const PruningFlags &flags);
+
     void set_level(unsigned mps, unsigned base, unsigned inc);
     
     void set_time(unsigned time);
@@ -161,6 +183,8 @@ namespace peacockspider
 
     bool get_hint_move(Move &move);
 
+    bool get_stop_latency(unsigned &latency);
+
     void set_result(Result result, const std::string &comment);
 
     void set_thinking_output_flag(bool flag);
@@ -197,14 +221,14 @@ namespace peacockspider
   class OutputFunctionSettings
   {
     Engine *_M_engine;
-    std::function<void (int, int, unsigned, const Searcher *, const Board *, const Move *move)> _M_saved_thinking_output_function;
+    std::function<void (int, int, ValueType, unsigned, const Searcher *, const Board *, const Move *move)> _M_saved_thinking_output_function;
     std::function<void (const Board &, Move, const Move *)> _M_saved_move_output_function;
     std::function<void (Result, const std::string &)> _M_saved_result_output_function;
     std::function<void (const Board &)> _M_saved_board_output_function;
   public:
     OutputFunctionSettings(
       Engine *engine,
-      std::function<void (int, int, unsigned, const Searcher *, const Board *, const Move *)> thinking_output_fun,
+      std::function<void (int, int, ValueType, unsigned, const Searcher *, const Board *, const Move *)> thinking_output_fun,
       std::function<void (const Board &, Move, const Move *)> move_output_fun,
       std::function<void (Result, const std::string &)> result_output_fun,
       std::function<void (const Board &)> board_output_fun) : _M_engine(engine)
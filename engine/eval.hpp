@@ -22,6 +22,7 @@
 #include <istream>
 #include <ostream>
 #include "chess.hpp"
+#include "pawn_table.hpp"
 
 namespace peacockspider
 {
@@ -75,6 +76,12 @@ namespace peacockspider
       first_parent(first_parent), second_parent(second_parent) {}
   };
 
+  struct EvaluationAccumulator
+  {
+    int material_values[2];
+    int piece_square_values[2];
+  };
+
   class EvaluationFunction
   {
     int _M_piece_material[6];
@@ -96,9 +103,60 @@ namespace peacockspider
 
     int operator()(const Board &board) const;
 
+    int operator()(const Board &board, const EvaluationAccumulator &accumulator) const
+    { return evaluate(board, accumulator, pawn_structure_value(board)); }
+
+    int operator()(const Board &board, const EvaluationAccumulator &accumulator, PawnTable &pawn_table) const
+    {
+      int pawn_value;
+      if(!pawn_table.retrieve(board.pawn_hash_key(), pawn_value)) {
+        pawn_value = pawn_structure_value(board);
+        pawn_table.store(board.pawn_hash_key(), pawn_value);
+      }
+      return evaluate(board, accumulator, pawn_value);
+    }
+
+    int pawn_structure_value(const Board &board) const;
+
+    void set_accumulator(const Board &board, EvaluationAccumulator &accumulator) const;
+
+    void update_accumulator(const Board &board, Move move, const EvaluationAccumulator &accumulator, EvaluationAccumulator &new_accumulator) const
+    {
+      Side side = board.side();
+      Side opp_side = ~side;
+      std::size_t side_idx = side_to_index(side);
+      std::size_t opp_side_idx = side_to_index(opp_side);
+      std::size_t piece_idx = piece_to_index(move.piece());
+      new_accumulator = accumulator;
+      if(move.piece() == Piece::KING && move.from() == (side == Side::WHITE ? E1 : E8) && (move.to() == (side == Side::WHITE ? G1 : G8) || move.to() == (side == Side::WHITE ? C1 : C8))) {
+        bool is_short = (move.to() == (side == Side::WHITE ? G1 : G8));
+        Square rook_src = (is_short ? (side == Side::WHITE ? H1 : H8) : (side == Side::WHITE ? A1 : A8));
+        Square rook_dst = (is_short ? (side == Side::WHITE ? F1 : F8) : (side == Side::WHITE ? D1 : D8));
+        new_accumulator.piece_square_values[side_idx] += _M_piece_square[side_idx][piece_to_index(Piece::ROOK)][rook_dst] - _M_piece_square[side_idx][piece_to_index(Piece::ROOK)][rook_src];
+        return;
+      }
+      std::size_t dst_piece_idx = (move.promotion_piece() == PromotionPiece::NONE ? piece_idx : promotion_piece_to_index(move.promotion_piece()));
+      new_accumulator.piece_square_values[side_idx] += _M_piece_square[side_idx][dst_piece_idx][move.to()] - _M_piece_square[side_idx][piece_idx][move.from()];
+      new_accumulator.material_values[side_idx] += _M_piece_material[dst_piece_idx] - _M_piece_material[piece_idx];
+      if(board.has_color(opp_side, move.to())) {
+        std::size_t cap_piece_idx = piece_to_index(board.piece(move.to()));
+        new_accumulator.piece_square_values[opp_side_idx] -= _M_piece_square[opp_side_idx][cap_piece_idx][move.to()];
+        new_accumulator.material_values[opp_side_idx] -= _M_piece_material[cap_piece_idx];
+      } else if(move.piece() == Piece::PAWN && (move.from() & 7) != (move.to() & 7)) {
+        Square cap_squ = (side == Side::WHITE ? move.to() - 8 : move.to() + 8);
+        new_accumulator.piece_square_values[opp_side_idx] -= _M_piece_square[opp_side_idx][piece_to_index(Piece::PAWN)][cap_squ];
+        new_accumulator.material_values[opp_side_idx] -= _M_piece_material[piece_to_index(Piece::PAWN)];
+      }
+    }
+
     int piece_material_value(Piece piece) const;
     
     int promotion_piece_material_value(PromotionPiece piece) const;
+
+    const int *piece_material_values() const
+    { return _M_piece_material; }
+  private:
+    int evaluate(const Board &board, const EvaluationAccumulator &accumulator, int pawn_value) const;
   };
 
   std::istream &read_evaluation_parameters(std::istream &is, ParentPair *parent_pair, int *params, std::size_t param_count = MAX_EVALUATION_PARAMETER_COUNT);
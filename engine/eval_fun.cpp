@@ -199,10 +199,61 @@ namespace peacockspider
   }
   
   int EvaluationFunction::operator()(const Board &board) const
+  {
+    EvaluationAccumulator accumulator;
+    set_accumulator(board, accumulator);
+    return (*this)(board, accumulator);
+  }
+
+  int EvaluationFunction::pawn_structure_value(const Board &board) const
   {
     int value = 0;
+    for(Column col = 0; col < 8; col++) {
+      if((board.color_bitboard(Side::WHITE) & board.piece_bitboard(Piece::PAWN) & tab_column_bitboards[col]) != 0) {
+        if((board.color_bitboard(Side::WHITE) & board.piece_bitboard(Piece::PAWN) & tab_neighbour_column_bitboards[col]) == 0)
+          value += _M_isolated_pawn;
+      }
+      if((board.color_bitboard(Side::BLACK) & board.piece_bitboard(Piece::PAWN) & tab_column_bitboards[col]) != 0) {
+        if((board.color_bitboard(Side::BLACK) & board.piece_bitboard(Piece::PAWN) & tab_neighbour_column_bitboards[col]) == 0)
+          value -= _M_isolated_pawn;
+      }
+      int pawn_count = 0;
+      for(Row row = 0; row < 7; row++) {
+        if(board.has_color_piece(Side::WHITE, Piece::PAWN, col + (row << 3))) pawn_count++;
+      }
+      if(pawn_count >= 2) value += _M_doubled_pawn;
+      pawn_count = 0;
+      for(Row row = 7; row >= 0; row--) {
+        if(board.has_color_piece(Side::BLACK, Piece::PAWN, col + (row << 3))) pawn_count++;
+      }
+      if(pawn_count >= 2) value -= _M_doubled_pawn;
+    }
+    return value;
+  }
+
+  int EvaluationFunction::evaluate(const Board &board, const EvaluationAccumulator &accumulator, int pawn_value) const
+  {
+    int value = accumulator.piece_square_values[side_to_index(Side::WHITE)] - accumulator.piece_square_values[side_to_index(Side::BLACK)];
+    int white_material_value = accumulator.material_values[side_to_index(Side::WHITE)];
+    int black_material_value = accumulator.material_values[side_to_index(Side::BLACK)];
+    value += white_material_value - black_material_value;
+    if(white_material_value + black_material_value > _M_endgame_material) {
+      value += _M_king_square[side_to_index(Side::WHITE)][board.king_square(Side::WHITE)];
+      value -= _M_king_square[side_to_index(Side::BLACK)][board.king_square(Side::BLACK)];
+    } else {
+      value += _M_king_square_for_endgame[board.king_square(Side::WHITE)];
+      value -= _M_king_square_for_endgame[board.king_square(Side::BLACK)];
+    }
+    value += pawn_value;
+    return (board.side() == Side::WHITE ? value : -value);
+  }
+
+  void EvaluationFunction::set_accumulator(const Board &board, EvaluationAccumulator &accumulator) const
+  {
     int white_material_value = 0;
     int black_material_value = 0;
+    int white_piece_square_value = 0;
+    int black_piece_square_value = 0;
     for(Square i = 0; i < 64; i += 4) {
       int bits, count;
       bits = ((board.color_bitboard(Side::WHITE) & board.piece_bitboard(Piece::PAWN)) >> i) & 0xf;
@@ -236,55 +287,30 @@ namespace peacockspider
       count = tab_square_offset_counts[bits];
       black_material_value += _M_piece_material[piece_to_index(Piece::QUEEN)] * count;
       bits = ((board.color_bitboard(Side::WHITE) & board.piece_bitboard(Piece::PAWN)) >> i) & 0xf;
-      value += _M_piece_square_bits[side_to_index(Side::WHITE)][piece_to_index(Piece::PAWN)][i >> 2][bits];
+      white_piece_square_value += _M_piece_square_bits[side_to_index(Side::WHITE)][piece_to_index(Piece::PAWN)][i >> 2][bits];
       bits = ((board.color_bitboard(Side::BLACK) & board.piece_bitboard(Piece::PAWN)) >> i) & 0xf;
-      value -= _M_piece_square_bits[side_to_index(Side::BLACK)][piece_to_index(Piece::PAWN)][i >> 2][bits];
+      black_piece_square_value += _M_piece_square_bits[side_to_index(Side::BLACK)][piece_to_index(Piece::PAWN)][i >> 2][bits];
       bits = ((board.color_bitboard(Side::WHITE) & board.piece_bitboard(Piece::KNIGHT)) >> i) & 0xf;
-      value += _M_piece_square_bits[side_to_index(Side::WHITE)][piece_to_index(Piece::KNIGHT)][i >> 2][bits];
+      white_piece_square_value += _M_piece_square_bits[side_to_index(Side::WHITE)][piece_to_index(Piece::KNIGHT)][i >> 2][bits];
       bits = ((board.color_bitboard(Side::BLACK) & board.piece_bitboard(Piece::KNIGHT)) >> i) & 0xf;
-      value -= _M_piece_square_bits[side_to_index(Side::BLACK)][piece_to_index(Piece::KNIGHT)][i >> 2][bits];
+      black_piece_square_value += _M_piece_square_bits[side_to_index(Side::BLACK)][piece_to_index(Piece::KNIGHT)][i >> 2][bits];
       bits = ((board.color_bitboard(Side::WHITE) & board.piece_bitboard(Piece::BISHOP)) >> i) & 0xf;
-      value += _M_piece_square_bits[side_to_index(Side::WHITE)][piece_to_index(Piece::BISHOP)][i >> 2][bits];
+      white_piece_square_value += _M_piece_square_bits[side_to_index(Side::WHITE)][piece_to_index(Piece::BISHOP)][i >> 2][bits];
       bits = ((board.color_bitboard(Side::BLACK) & board.piece_bitboard(Piece::BISHOP)) >> i) & 0xf;
-      value -= _M_piece_square_bits[side_to_index(Side::BLACK)][piece_to_index(Piece::BISHOP)][i >> 2][bits];
+      black_piece_square_value += _M_piece_square_bits[side_to_index(Side::BLACK)][piece_to_index(Piece::BISHOP)][i >> 2][bits];
       bits = ((board.color_bitboard(Side::WHITE) & board.piece_bitboard(Piece::ROOK)) >> i) & 0xf;
-      value += _M_piece_square_bits[side_to_index(Side::WHITE)][piece_to_index(Piece::ROOK)][i >> 2][bits];
+      white_piece_square_value += _M_piece_square_bits[side_to_index(Side::WHITE)][piece_to_index(Piece::ROOK)][i >> 2][bits];
       bits = ((board.color_bitboard(Side::BLACK) & board.piece_bitboard(Piece::ROOK)) >> i) & 0xf;
-      value -= _M_piece_square_bits[side_to_index(Side::BLACK)][piece_to_index(Piece::ROOK)][i >> 2][bits];
+      black_piece_square_value += _M_piece_square_bits[side_to_index(Side::BLACK)][piece_to_index(Piece::ROOK)][i >> 2][bits];
       bits = ((board.color_bitboard(Side::WHITE) & board.piece_bitboard(Piece::QUEEN)) >> i) & 0xf;
-      value += _M_piece_square_bits[side_to_index(Side::WHITE)][piece_to_index(Piece::QUEEN)][i >> 2][bits];
+      white_piece_square_value += _M_piece_square_bits[side_to_index(Side::WHITE)][piece_to_index(Piece::QUEEN)][i >> 2][bits];
       bits = ((board.color_bitboard(Side::BLACK) & board.piece_bitboard(Piece::QUEEN)) >> i) & 0xf;
-      value -= _M_piece_square_bits[side_to_index(Side::BLACK)][piece_to_index(Piece::QUEEN)][i >> 2][bits];
+      black_piece_square_value += _M_piece_square_bits[side_to_index(Side::BLACK)][piece_to_index(Piece::QUEEN)][i >> 2][bits];
     }
-    value += white_material_value - black_material_value;
-    if(white_material_value + black_material_value > _M_endgame_material) {
-      value += _M_king_square[side_to_index(Side::WHITE)][board.king_square(Side::WHITE)];
-      value -= _M_king_square[side_to_index(Side::BLACK)][board.king_square(Side::BLACK)];
-    } else {
-      value += _M_king_square_for_endgame[board.king_square(Side::WHITE)];
-      value -= _M_king_square_for_endgame[board.king_square(Side::BLACK)];
-    }
-    for(Column col = 0; col < 8; col++) {
-      if((board.color_bitboard(Side::WHITE) & board.piece_bitboard(Piece::PAWN) & tab_column_bitboards[col]) != 0) {
-        if((board.color_bitboard(Side::WHITE) & board.piece_bitboard(Piece::PAWN) & tab_neighbour_column_bitboards[col]) == 0)
-          value += _M_isolated_pawn;
-      }
-      if((board.color_bitboard(Side::BLACK) & board.piece_bitboard(Piece::PAWN) & tab_column_bitboards[col]) != 0) {
-        if((board.color_bitboard(Side::BLACK) & board.piece_bitboard(Piece::PAWN) & tab_neighbour_column_bitboards[col]) == 0)
-          value -= _M_isolated_pawn;
-      }
-      int pawn_count = 0;
-      for(Row row = 0; row < 7; row++) {
-        if(board.has_color_piece(Side::WHITE, Piece::PAWN, col + (row << 3))) pawn_count++;
-      }
-      if(pawn_count >= 2) value += _M_doubled_pawn;
-      pawn_count = 0;
-      for(Row row = 7; row >= 0; row--) {
-        if(board.has_color_piece(Side::BLACK, Piece::PAWN, col + (row << 3))) pawn_count++;
-      }
-      if(pawn_count >= 2) value -= _M_doubled_pawn;
-    }
-    return (board.side() == Side::WHITE ? value : -value);
+    accumulator.material_values[side_to_index(Side::WHITE)] = white_material_value;
+    accumulator.material_values[side_to_index(Side::BLACK)] = black_material_value;
+    accumulator.piece_square_values[side_to_index(Side::WHITE)] = white_piece_square_value;
+    accumulator.piece_square_values[side_to_index(Side::BLACK)] = black_piece_square_value;
   }
 
   int EvaluationFunction::piece_material_value(Piece piece) const
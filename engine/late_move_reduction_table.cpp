@@ -0,0 +1,43 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+#include "search.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  void LateMoveReductionTable::set(bool flag, int base, int divisor)
+  {
+    _M_flag = flag;
+    _M_base = base;
+    _M_divisor = divisor;
+    for(int depth = 0; depth < MAX_LATE_MOVE_REDUCTION_DEPTH; depth++) {
+      for(int move_count = 0; move_count < MAX_LATE_MOVE_REDUCTION_MOVE_COUNT; move_count++) {
+        int reduction = 0;
+        // The first three moves and the moves at the small depths aren't reduced.
+        if(flag && depth >= 3 && move_count >= 4) {
+          double r = (base + log(depth) * log(move_count) * 10000.0 / divisor) / 100.0;
+          reduction = min(max(static_cast<int>(r), 0), depth - 2);
+        }
+        _M_reductions[depth][move_count] = reduction;
+      }
+    }
+  }
+}
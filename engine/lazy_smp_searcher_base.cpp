@@ -15,55 +15,71 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
 #include "search.hpp"
 
 using namespace std;
 
 namespace peacockspider
 {
+  namespace
+  {
+    const int skip_sizes[] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+    const int skip_phases[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+    const size_t skip_count = sizeof(skip_sizes) / sizeof(skip_sizes[0]);
+
+    inline bool must_skip_depth(unsigned thread_index, int depth)
+    {
+      size_t i = thread_index % skip_count;
+      return ((depth + skip_phases[i]) / skip_sizes[i]) % 2 != 0;
+    }
+  }
+
   LazySMPSearcherBase::LazySMPSearcherBase(const EvaluationFunction *eval_fun, TranspositionTable *transpos_table, function<Searcher *(const EvaluationFunction *, TranspositionTable *, const Searcher *, const vector<LazySMPThread> &, int, int)> fun, unsigned thread_count, int max_depth, int max_quiescence_depth) :
-    _M_transposition_table(transpos_table)
+    _M_evaluation_function(eval_fun), _M_transposition_table(transpos_table), _M_searcher_function(fun), _M_max_depth(max_depth), _M_max_quiescence_depth(max_quiescence_depth), _M_pawn_table_entry_count(DEFAULT_PAWN_TABLE_ENTRY_COUNT), _M_thread_pool(&shared_thread_pool()), _M_are_threads_searching(false), _M_has_search_moves(false), _M_has_last_board(false), _M_pv_line(max_depth + 1 + max_quiescence_depth)
   {
     _M_main_searcher = unique_ptr<Searcher>(fun(eval_fun, transpos_table, nullptr, _M_threads, max_depth, max_quiescence_depth));
+    start_threads(thread_count);
+  }
+
+  LazySMPSearcherBase::~LazySMPSearcherBase()
+  { quit_threads(); }
+
+  void LazySMPSearcherBase::start_threads(unsigned thread_count)
+  {
     for(unsigned i = 0; i < thread_count - 1; i++) {
       _M_threads.push_back(LazySMPThread());
-      _M_threads.back().searcher = unique_ptr<Searcher>(fun(eval_fun, transpos_table, _M_main_searcher.get(), _M_threads, max_depth + 1, max_quiescence_depth));
-      _M_threads.back().command = LazySMPCommand::NO_COMMAND;
-      _M_threads.back().result = LazySMPResult::NO_RESULT;
-    }
-    for(unsigned i = 0; i < thread_count - 1; i++) {
-      _M_threads[i].thread = thread([this, i]() {
-        unique_lock<mutex> lock(_M_threads[i].mutex);
-        while(true) {
-          while(_M_threads[i].command == LazySMPCommand::NO_COMMAND) {
-            _M_threads[i].start_condition_variable.wait(lock);
-          }
-          if(_M_threads[i].command == LazySMPCommand::QUIT) break;
-          if(_M_threads[i].command == LazySMPCommand::SEARCH) {
-            Move best_move;
-            int depth = _M_depth + (i % 2 == 0 ? 1 : 0);
-            _M_threads[i].searcher->search_from_root(_M_alpha, _M_beta, depth, _M_search_moves, best_move, *_M_boards, _M_last_board);
-          }
-          _M_threads[i].command = LazySMPCommand::NO_COMMAND;
-          _M_threads[i].result = LazySMPResult::STOP;
-          _M_threads[i].stop_condition_variable.notify_one();
-        }
-      });
+      _M_threads.back().searcher = unique_ptr<Searcher>(_M_searcher_function(_M_evaluation_function, _M_transposition_table, _M_main_searcher.get(), _M_threads, _M_max_depth + 1, _M_max_quiescence_depth));
+      _M_threads.back().stop_flag.store(false);
+      _M_threads.back().completed_depth = 0;
+      _M_threads.back().start_nodes = 0;
+      _M_threads.back().completed_pv_line.set_moves(new Move[_M_max_depth + 1 + _M_max_quiescence_depth]);
     }
+    _M_thread_pool->reserve(thread_count - 1);
   }
 
-  LazySMPSearcherBase::~LazySMPSearcherBase()
+  void LazySMPSearcherBase::quit_threads()
   {
-    for(LazySMPThread &thread : _M_threads) {
-      thread.searcher->stop_searching();
-    }
-    for(LazySMPThread &thread : _M_threads) {
-      unique_lock<mutex> lock(thread.mutex);
-      thread.command = LazySMPCommand::QUIT;
-      thread.start_condition_variable.notify_one();
-    }
-    for(LazySMPThread &thread : _M_threads) {
-      thread.thread.join();
+    stop_threads();
+    _M_thread_pool->release(_M_threads.size());
+  }
+
+  void LazySMPSearcherBase::search_in_thread(unsigned i)
+  {
+    // Each helper thread has own iterative deepening that is stopped at the end of thinking.
+    const vector<Move> *search_moves = (_M_has_search_moves ? &_M_search_moves : nullptr);
+    const Board *last_board = (_M_has_last_board ? &_M_last_board : nullptr);
+    for(int depth = 1; depth <= _M_max_depth && !_M_threads[i].stop_flag.load(); depth++) {
+      if(must_skip_depth(i + 1, depth)) continue;
+      Move best_move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+      int value = _M_threads[i].searcher->search_from_root(MIN_VALUE, MAX_VALUE, depth, search_moves, best_move, _M_boards, last_board);
+      if(_M_threads[i].stop_flag.load()) break;
+      _M_threads[i].searcher->set_previous_pv_line(_M_threads[i].searcher->pv_line());
+      lock_guard<mutex> completed_lock(_M_threads[i].completed_mutex);
+      _M_threads[i].completed_depth = depth;
+      _M_threads[i].completed_value = value;
+      _M_threads[i].completed_best_move = best_move;
+      _M_threads[i].completed_pv_line = _M_threads[i].searcher->pv_line();
     }
   }
 
@@ -72,18 +88,13 @@ namespace peacockspider
 
   void LazySMPSearcherBase::set_board(const Board &board)
   {
+    stop_threads();
     _M_main_searcher->set_board(board);
     for(LazySMPThread &thread : _M_threads) {
       thread.searcher->set_board(board);
     }
   }
     
-  void LazySMPSearcherBase::set_stop_time(const chrono::high_resolution_clock::time_point &time)
-  { _M_main_searcher->set_stop_time(time); }
-
-  void LazySMPSearcherBase::unset_stop_time()
-  { _M_main_searcher->unset_stop_nodes(); }
-
   void LazySMPSearcherBase::set_stop_nodes(uint64_t nodes)
   { _M_main_searcher->set_stop_nodes(nodes); }
 
@@ -91,49 +102,47 @@ namespace peacockspider
   { _M_main_searcher->unset_stop_nodes(); }
 
   void LazySMPSearcherBase::set_previous_pv_line(const PVLine &pv_line)
-  {
-    _M_main_searcher->set_previous_pv_line(pv_line);
-    for(LazySMPThread &thread : _M_threads) {
-      thread.searcher->set_previous_pv_line(pv_line);
-    }
-  }
+  { _M_main_searcher->set_previous_pv_line(pv_line); }
 
   void LazySMPSearcherBase::clear()
   {
+    stop_threads();
     _M_transposition_table->increase_age_or_clear();
     _M_main_searcher->clear();
     for(LazySMPThread &thread : _M_threads) {
       thread.searcher->clear();
+      thread.start_nodes = 0;
     }
   }
 
   void LazySMPSearcherBase::clear_for_new_game()
   {
+    stop_threads();
     _M_transposition_table->clear();
-    _M_main_searcher->clear();
+    _M_main_searcher->clear_for_new_game();
     for(LazySMPThread &thread : _M_threads) {
-      thread.searcher->clear();
+      thread.searcher->clear_for_new_game();
+      thread.start_nodes = 0;
     }
   }
 
   int LazySMPSearcherBase::search_from_root(int alpha, int beta, int depth, const vector<Move> *search_moves, Move &best_move, const vector<Board> &boards, const Board *last_board)
   {
-    _M_alpha = alpha;
-    _M_beta = beta;
-    _M_depth = depth;
-    _M_search_moves = search_moves;
-    _M_boards = &boards;
-    _M_last_board = last_board;
+    if(!_M_are_threads_searching) search_in_threads(search_moves, boards, last_board);
+    // The helper nodes are counted for the iteration of the main searcher like its nodes.
     for(LazySMPThread &thread : _M_threads) {
-      unique_lock<mutex> lock(thread.mutex);
-      thread.searcher->clear_searching_stop_flag();
-      thread.command = LazySMPCommand::SEARCH;
-      thread.start_condition_variable.notify_one();
+      thread.start_nodes = thread.searcher->nodes();
     }
-    LazySMPStop stop(this);
-    return _M_main_searcher->search_from_root(alpha, beta, depth, search_moves, best_move, boards, last_board);
+    int value = _M_main_searcher->search_from_root(alpha, beta, depth, search_moves, best_move, boards, last_board);
+    _M_pv_line = _M_main_searcher->pv_line();
+    if(value > alpha && value < beta && best_move.to() != -1)
+      value = vote(alpha, beta, depth, value, best_move);
+    return value;
   }
 
+  void LazySMPSearcherBase::finish_thinking()
+  { stop_threads(); }
+
   void LazySMPSearcherBase::set_pondering_flag(bool flag)
   { _M_main_searcher->set_pondering_flag(flag); }
 
@@ -159,7 +168,7 @@ namespace peacockspider
   { _M_main_searcher->set_non_stop_flag(flag); }
 
   const PVLine &LazySMPSearcherBase::pv_line() const
-  { return _M_main_searcher->pv_line(); }
+  { return _M_pv_line; }
 
   uint64_t LazySMPSearcherBase::nodes() const
   { return _M_main_searcher->all_nodes(); }
@@ -170,17 +179,178 @@ namespace peacockspider
   int LazySMPSearcherBase::max_quiescence_depth() const
   { return _M_main_searcher->max_quiescence_depth(); }
 
+  void LazySMPSearcherBase::set_pawn_table_entry_count(size_t count)
+  {
+    stop_threads();
+    _M_pawn_table_entry_count = count;
+    _M_main_searcher->set_pawn_table_entry_count(count);
+    for(LazySMPThread &thread : _M_threads) {
+      thread.searcher->set_pawn_table_entry_count(count);
+    }
+  }
+
+  uint64_t LazySMPSearcherBase::pawn_table_probe_count() const
+  {
+    uint64_t count = _M_main_searcher->pawn_table_probe_count();
+    for(const LazySMPThread &thread : _M_threads) {
+      count += thread.searcher->pawn_table_probe_count();
+    }
+    return count;
+  }
+
+  uint64_t LazySMPSearcherBase::pawn_table_hit_count() const
+  {
+    uint64_t count = _M_main_searcher->pawn_table_hit_count();
+    for(const LazySMPThread &thread : _M_threads) {
+      count += thread.searcher->pawn_table_hit_count();
+    }
+    return count;
+  }
+
+  uint64_t LazySMPSearcherBase::cutoff_count() const
+  {
+    uint64_t count = _M_main_searcher->cutoff_count();
+    for(const LazySMPThread &thread : _M_threads) {
+      count += thread.searcher->cutoff_count();
+    }
+    return count;
+  }
+
+  uint64_t LazySMPSearcherBase::first_move_cutoff_count() const
+  {
+    uint64_t count = _M_main_searcher->first_move_cutoff_count();
+    for(const LazySMPThread &thread : _M_threads) {
+      count += thread.searcher->first_move_cutoff_count();
+    }
+    return count;
+  }
+
+  size_t LazySMPSearcherBase::transposition_table_entry_count() const
+  { return _M_transposition_table->entry_count(); }
+
+  void LazySMPSearcherBase::set_transposition_table_entry_count(size_t count)
+  {
+    stop_threads();
+    _M_transposition_table->resize(count);
+  }
+
+  bool LazySMPSearcherBase::save_transposition_table(const string &file_name) const
+  { return _M_transposition_table->save(file_name); }
+
+  bool LazySMPSearcherBase::load_transposition_table(const string &file_name)
+  {
+    stop_threads();
+    return _M_transposition_table->load(file_name);
+  }
+
+  const LateMoveReductionTable &LazySMPSearcherBase::late_move_reduction_table() const
+  { return _M_main_searcher->late_move_reduction_table(); }
+
+  void LazySMPSearcherBase::set_late_move_reduction_table(const LateMoveReductionTable &table)
+  {
+    stop_threads();
+    _M_main_searcher->set_late_move_reduction_table(table);
+    for(LazySMPThread &thread : _M_threads) {
+      thread.searcher->set_late_move_reduction_table(table);
+    }
+  }
+
+  const PruningFlags &LazySMPSearcherBase::pruning_flags() const
+  { return _M_main_searcher->pruning_flags(); }
+
+  void LazySMPSearcherBase::set_pruning_flags(const PruningFlags &flags)
+  {
+    stop_threads();
+    _M_main_searcher->set_pruning_flags(flags);
+    for(LazySMPThread &thread : _M_threads) {
+      thread.searcher->set_pruning_flags(flags);
+    }
+  }
+
+  bool LazySMPSearcherBase::can_set_thread_count() const
+  { return true; }
+
+  void LazySMPSearcherBase::set_thread_count(unsigned thread_count)
+  {
+    quit_threads();
+    _M_threads.clear();
+    start_threads(thread_count);
+    for(LazySMPThread &thread : _M_threads) {
+      thread.searcher->set_board(_M_main_searcher->board());
+      thread.searcher->set_pawn_table_entry_count(_M_pawn_table_entry_count);
+      thread.searcher->set_late_move_reduction_table(_M_main_searcher->late_move_reduction_table());
+      thread.searcher->set_pruning_flags(_M_main_searcher->pruning_flags());
+    }
+    _M_transposition_table->set_thread_count(thread_count);
+  }
+
+  void LazySMPSearcherBase::search_in_threads(const vector<Move> *search_moves, const vector<Board> &boards, const Board *last_board)
+  {
+    _M_has_search_moves = (search_moves != nullptr);
+    if(search_moves != nullptr) _M_search_moves = *search_moves;
+    _M_boards = boards;
+    _M_has_last_board = (last_board != nullptr);
+    if(last_board != nullptr) _M_last_board = *last_board;
+    for(unsigned i = 0; i < _M_threads.size(); i++) {
+      {
+        lock_guard<mutex> lock(_M_threads[i].completed_mutex);
+        _M_threads[i].completed_depth = 0;
+      }
+      _M_threads[i].stop_flag.store(false);
+      _M_threads[i].searcher->clear_searching_stop_flag();
+      _M_task_group.run(*_M_thread_pool, [this, i]() { search_in_thread(i); });
+    }
+    _M_are_threads_searching = true;
+  }
+
   void LazySMPSearcherBase::stop_threads()
   {
+    if(!_M_are_threads_searching) return;
     for(LazySMPThread &thread : _M_threads) {
+      thread.stop_flag.store(true);
       thread.searcher->stop_searching();
     }
+    _M_task_group.wait();
+    _M_are_threads_searching = false;
+  }
+
+  int LazySMPSearcherBase::vote(int alpha, int beta, int depth, int value, Move &best_move)
+  {
+    vector<unique_lock<mutex>> locks;
+    vector<Move> moves;
+    vector<int> depths;
+    vector<int> values;
+    vector<const PVLine *> pv_lines;
+    moves.push_back(best_move);
+    depths.push_back(depth);
+    values.push_back(value);
+    pv_lines.push_back(&_M_pv_line);
+    // Only completed iterations of the helper threads that are not shallower than the main search vote.
     for(LazySMPThread &thread : _M_threads) {
-      unique_lock<mutex> lock(thread.mutex);
-      while(thread.result == LazySMPResult::NO_RESULT) {
-        thread.stop_condition_variable.wait(lock);
+      locks.push_back(unique_lock<mutex>(thread.completed_mutex));
+      if(thread.completed_depth >= depth && thread.completed_value > alpha && thread.completed_value < beta && thread.completed_best_move.to() != -1) {
+        moves.push_back(thread.completed_best_move);
+        depths.push_back(thread.completed_depth);
+        values.push_back(thread.completed_value);
+        pv_lines.push_back(&thread.completed_pv_line);
+      }
+    }
+    if(moves.size() == 1) return value;
+    int min_value = *min_element(values.begin(), values.end());
+    size_t best_i = 0;
+    int64_t best_votes = 0;
+    for(size_t i = 0; i < moves.size(); i++) {
+      int64_t votes = 0;
+      for(size_t j = 0; j < moves.size(); j++) {
+        if(moves[j] == moves[i]) votes += static_cast<int64_t>(values[j] - min_value + 14) * depths[j];
+      }
+      if(votes > best_votes || (moves[i] == moves[best_i] && depths[i] > depths[best_i])) {
+        best_i = i;
+        best_votes = votes;
       }
-      thread.result = LazySMPResult::NO_RESULT;
     }
+    best_move = moves[best_i];
+    if(best_i != 0) _M_pv_line = *(pv_lines[best_i]);
+    return values[best_i];
   }
 }
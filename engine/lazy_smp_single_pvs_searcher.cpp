@@ -22,24 +22,32 @@ using namespace std;
 namespace peacockspider
 {
   LazySMPSinglePVSSearcher::LazySMPSinglePVSSearcher(const EvaluationFunction *eval_fun, TranspositionTable *transpos_table, const Searcher *main_searcher, const vector<LazySMPThread> &threads, int max_depth, int max_quiescence_depth) :
-    SinglePVSSearcherWithTT(eval_fun, transpos_table, max_depth, max_quiescence_depth), _M_main_searcher(main_searcher), _M_threads(threads) {}
+    SinglePVSSearcherWithTT(eval_fun, transpos_table, max_depth, max_quiescence_depth), _M_main_searcher(main_searcher), _M_threads(threads)
+  { _M_node_reset_flag = (main_searcher == nullptr); }
 
   LazySMPSinglePVSSearcher::~LazySMPSinglePVSSearcher() {}
 
   void LazySMPSinglePVSSearcher::clear()
-  { _M_move_order.clear(); }
+  {
+    _M_move_order.clear();
+    _M_pawn_table.clear_counts();
+    clear_cutoff_counts();
+    reset_nodes();
+  }
 
   void LazySMPSinglePVSSearcher::clear_for_new_game()
-  { _M_move_order.clear(); }
+  {
+    clear();
+    _M_pawn_table.clear();
+  }
 
   uint64_t LazySMPSinglePVSSearcher::all_nodes() const
   {
     const Searcher *main_searcher = (_M_main_searcher != nullptr ? _M_main_searcher : this);
     uint64_t nodes = main_searcher->nodes();
     for(const LazySMPThread &thread : _M_threads) {
-      nodes += thread.searcher->nodes();
+      nodes += thread.nodes();
     }
     return nodes;
   }
 }
-
@@ -45,30 +45,28 @@ namespace peacockspider
   bool Move::is_check(const Board &board) const
   {
     Board tmp_board;
-    board.make_move(*this, tmp_board);
+    board.unsafely_make_move(*this, tmp_board);
     return tmp_board.in_check();
   }
   
   bool Move::is_checkmate(const Board &board, MovePairList &move_pairs) const
   {
     Board tmp_board;
-    board.make_move(*this, tmp_board);
+    board.unsafely_make_move(*this, tmp_board);
     return tmp_board.in_checkmate(move_pairs);
   }
 
   bool Move::set_can(const CANMove &move, const Board &board, MovePairList &move_pairs)
   {
-    board.generate_pseudolegal_moves(move_pairs);
+    board.generate_legal_moves(move_pairs);
     for(size_t i = 0; i < move_pairs.length(); i++) {
       Move tmp_move = move_pairs[i].move;
-      if(board.has_legal_move(tmp_move)) {
-        if(tmp_move.from() == move.from() &&
-          tmp_move.to() == move.to() &&
-          ::peacockspider::equal_for_promotion(tmp_move.promotion_piece(), move.promotion_piece())) {
-          *this = tmp_move;
-          set_promotion_piece(move.promotion_piece());
-          return true;
-        }
+      if(tmp_move.from() == move.from() &&
+        tmp_move.to() == move.to() &&
+        ::peacockspider::equal_for_promotion(tmp_move.promotion_piece(), move.promotion_piece())) {
+        *this = tmp_move;
+        set_promotion_piece(move.promotion_piece());
+        return true;
       }
     }
     return false;
@@ -78,25 +76,23 @@ namespace peacockspider
   {
     bool is_found = false;
     Move found_move;
-    board.generate_pseudolegal_moves(move_pairs);
+    board.generate_legal_moves(move_pairs);
     Square castling_src = (board.side() == Side::WHITE ? E1 : E8); 
     Square short_castling_dst = (board.side() == Side::WHITE ? G1 : G8); 
     Square long_castling_dst = (board.side() == Side::WHITE ? C1 : C8); 
     for(size_t i = 0; i < move_pairs.length(); i++) {
       Move tmp_move = move_pairs[i].move;
-      if(board.has_legal_move(tmp_move)) {
-        if((move.flags() & (SANMoveFlags::SHORT_CASTLING | SANMoveFlags::LONG_CASTLING)) != SANMoveFlags::NONE ?
-          ((move.flags() & SANMoveFlags::SHORT_CASTLING) != SANMoveFlags::NONE && tmp_move.piece() == Piece::KING && tmp_move.from() == castling_src && tmp_move.to() == short_castling_dst && tmp_move.promotion_piece() == PromotionPiece::NONE) ||
-          ((move.flags() & SANMoveFlags::LONG_CASTLING) != SANMoveFlags::NONE && tmp_move.piece() == Piece::KING && tmp_move.from() == castling_src && tmp_move.to() == long_castling_dst && tmp_move.promotion_piece() == PromotionPiece::NONE) :
-          tmp_move.piece() == move.piece() &&
-          (move.from_column() != -1 ? (tmp_move.from() & 7) == move.from_column() : true) &&
-          (move.from_row() != -1 ? (tmp_move.from() >> 3) == move.from_row() : true) &&
-          tmp_move.to() == move.to() &&
-          ::peacockspider::equal_for_promotion(tmp_move.promotion_piece(), move.promotion_piece())) {
-          if(is_found) return false;
-          found_move = tmp_move;
-          is_found = true;
-        }
+      if((move.flags() & (SANMoveFlags::SHORT_CASTLING | SANMoveFlags::LONG_CASTLING)) != SANMoveFlags::NONE ?
+        ((move.flags() & SANMoveFlags::SHORT_CASTLING) != SANMoveFlags::NONE && tmp_move.piece() == Piece::KING && tmp_move.from() == castling_src && tmp_move.to() == short_castling_dst && tmp_move.promotion_piece() == PromotionPiece::NONE) ||
+        ((move.flags() & SANMoveFlags::LONG_CASTLING) != SANMoveFlags::NONE && tmp_move.piece() == Piece::KING && tmp_move.from() == castling_src && tmp_move.to() == long_castling_dst && tmp_move.promotion_piece() == PromotionPiece::NONE) :
+        tmp_move.piece() == move.piece() &&
+        (move.from_column() != -1 ? (tmp_move.from() & 7) == move.from_column() : true) &&
+        (move.from_row() != -1 ? (tmp_move.from() >> 3) == move.from_row() : true) &&
+        tmp_move.to() == move.to() &&
+        ::peacockspider::equal_for_promotion(tmp_move.promotion_piece(), move.promotion_piece())) {
+        if(is_found) return false;
+        found_move = tmp_move;
+        is_found = true;
       }
     }
     if(is_found) {
@@ -122,18 +118,16 @@ namespace peacockspider
   {
     SANMove move;
     bool is_found = false;
-    board.generate_pseudolegal_moves(move_pairs);
+    board.generate_legal_moves(move_pairs);
     Square castling_src = (board.side() == Side::WHITE ? E1 : E8); 
     Square short_castling_dst = (board.side() == Side::WHITE ? G1 : G8); 
     Square long_castling_dst = (board.side() == Side::WHITE ? C1 : C8); 
     if(piece() == Piece::KING && from() == castling_src && (to() == short_castling_dst || to() == long_castling_dst) && promotion_piece() == PromotionPiece::NONE) {
       for(size_t i = 0; i < move_pairs.length(); i++) {
         Move tmp_move = move_pairs[i].move;
-        if(board.has_legal_move(tmp_move)) {
-          if(tmp_move == *this) {
-            is_found = true;
-            break;
-          }
+        if(tmp_move == *this) {
+          is_found = true;
+          break;
         }
       }
       if(to() == short_castling_dst)
@@ -147,15 +141,13 @@ namespace peacockspider
       move.set_flags(SANMoveFlags::NONE);
       for(size_t i = 0; i < move_pairs.length(); i++) {
         Move tmp_move = move_pairs[i].move;
-        if(board.has_legal_move(tmp_move)) {
-          if(tmp_move.equal_for_promotion(*this)) {
-            is_found = true;
-          } else if(tmp_move.piece() == piece() && tmp_move.to() == to() &&
-            ::peacockspider::equal_for_promotion(tmp_move.promotion_piece(), promotion_piece()))  {
-            if((tmp_move.from() & 7) == (from() & 7)) must_be_src_row = true;
-            if((tmp_move.from() >> 3) == (from() >> 3)) must_be_src_col = true;
-            is_ambiguous = true;
-          }
+        if(tmp_move.equal_for_promotion(*this)) {
+          is_found = true;
+        } else if(tmp_move.piece() == piece() && tmp_move.to() == to() &&
+          ::peacockspider::equal_for_promotion(tmp_move.promotion_piece(), promotion_piece()))  {
+          if((tmp_move.from() & 7) == (from() & 7)) must_be_src_row = true;
+          if((tmp_move.from() >> 3) == (from() >> 3)) must_be_src_col = true;
+          is_ambiguous = true;
         }
       }      
       if(is_ambiguous && !must_be_src_col && !must_be_src_row) must_be_src_col = true;
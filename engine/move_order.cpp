@@ -21,7 +21,7 @@ using namespace std;
 
 namespace peacockspider
 {
-  int MoveOrder::move_score(Move move, int ply, const Board &board, const EvaluationFunction *eval_fun, Move *best_move) const
+  int MoveOrder::move_score(Move move, int ply, const Board &board, const EvaluationFunction *eval_fun, Move *best_move, Move previous_move) const
   {
     if(static_cast<size_t>(ply) < _M_previous_pv_line.length() && move == _M_previous_pv_line[ply]) {
       return MOVE_SCORE_PV;
@@ -31,6 +31,9 @@ namespace peacockspider
       bool is_cap = move.is_capture(board);
       if(is_cap || move.promotion_piece() != PromotionPiece::NONE) {
         int score = MOVE_SCORE_GOOD_MOVE;
+        // Captures that lose material by the static exchange evaluation are bad moves.
+        if(is_cap && eval_fun->piece_material_value(move.piece()) > eval_fun->piece_material_value(board.piece(move.to())) && board.see(move, eval_fun->piece_material_values()) < 0)
+          score = MOVE_SCORE_BAD_MOVE;
         if(is_cap) {
           score += eval_fun->piece_material_value(board.piece(move.to())) * 10000;
           score -= eval_fun->piece_material_value(move.piece());
@@ -40,6 +43,12 @@ namespace peacockspider
           score += eval_fun->promotion_piece_material_value(move.promotion_piece()) * 10000;
         }
         return score;
+      } else if(static_cast<size_t>(ply) < _M_max_killer_ply && move == killer_move(ply, 0)) {
+        return MOVE_SCORE_KILLER_MOVE + 1;
+      } else if(static_cast<size_t>(ply) < _M_max_killer_ply && move == killer_move(ply, 1)) {
+        return MOVE_SCORE_KILLER_MOVE;
+      } else if(previous_move.to() != -1 && move == countermove(board.side(), previous_move)) {
+        return MOVE_SCORE_COUNTERMOVE;
       } else if(_M_history[side_to_index(board.side())][move.from()][move.to()] > 0) {
         return MOVE_SCORE_HISTORY + _M_history[side_to_index(board.side())][move.from()][move.to()];
       } else
@@ -47,10 +56,10 @@ namespace peacockspider
     }
   }
 
-  void MoveOrder::set_move_scores(MovePairList &move_pairs, int ply, const Board &board, const EvaluationFunction *eval_fun, Move *best_move) const
+  void MoveOrder::set_move_scores(MovePairList &move_pairs, int ply, const Board &board, const EvaluationFunction *eval_fun, Move *best_move, Move previous_move) const
   {
     for(size_t i = 0; i < move_pairs.length(); i++) {
-      move_pairs[i].score = move_score(move_pairs[i].move, ply, board, eval_fun, best_move);
+      move_pairs[i].score = move_score(move_pairs[i].move, ply, board, eval_fun, best_move, previous_move);
     }
   }
 
@@ -63,9 +72,32 @@ namespace peacockspider
         }
       }
     }
+    for(size_t i = 0; i < _M_max_killer_ply * KILLER_MOVE_COUNT; i++) {
+      _M_killer_moves[i] = Move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+    }
+    for(int side = 0; side < 2; side++) {
+      for(int piece = 0; piece < 6; piece++) {
+        for(Square to = 0; to < 64; to++) {
+          _M_countermoves[side][piece][to] = Move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+        }
+      }
+    }
     _M_previous_pv_line.clear();
   }
 
   void MoveOrder::set_previous_pv_line(const PVLine &pv_line)
   { _M_previous_pv_line = pv_line; }
+
+  void MoveOrder::add_cutoff_move(Move move, int ply, const Board &board, Move previous_move)
+  {
+    // Captures and promotions are already ordered by material, so only quiet moves are
+    // remembered as killer moves and countermoves.
+    if(move.is_capture(board) || move.promotion_piece() != PromotionPiece::NONE) return;
+    if(static_cast<size_t>(ply) < _M_max_killer_ply && move != killer_move(ply, 0)) {
+      _M_killer_moves[ply * KILLER_MOVE_COUNT + 1] = _M_killer_moves[ply * KILLER_MOVE_COUNT];
+      _M_killer_moves[ply * KILLER_MOVE_COUNT] = move;
+    }
+    if(previous_move.to() != -1)
+      _M_countermoves[side_to_index(board.side())][piece_to_index(previous_move.piece())][previous_move.to()] = move;
+  }
 }
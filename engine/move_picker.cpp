@@ -0,0 +1,105 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "search.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  MovePicker::MovePicker(MovePairList &move_pairs, int ply, const Board &board, const MoveOrder &move_order, const EvaluationFunction *eval_fun, Move *best_move, Move previous_move) :
+    _M_move_pairs(move_pairs), _M_ply(ply), _M_board(board), _M_move_order(move_order), _M_evaluation_function(eval_fun), _M_best_move(best_move), _M_previous_move(previous_move),
+    _M_stage(MovePickerStage::BEST_MOVES), _M_last_stage(MovePickerStage::QUIET_MOVES), _M_best_move_count(0), _M_index(0), _M_sorting_flag(true)
+  { _M_move_pairs.clear(); }
+
+  MovePicker::MovePicker(MovePairList &move_pairs, int ply, const Board &board, const MoveOrder &move_order, const EvaluationFunction *eval_fun) :
+    _M_move_pairs(move_pairs), _M_ply(ply), _M_board(board), _M_move_order(move_order), _M_evaluation_function(eval_fun), _M_best_move(nullptr), _M_previous_move(Piece::PAWN, -1, -1, PromotionPiece::NONE),
+    _M_stage(MovePickerStage::GOOD_MOVES), _M_last_stage(MovePickerStage::GOOD_MOVES), _M_best_move_count(0), _M_index(0), _M_sorting_flag(true)
+  { _M_move_pairs.clear(); }
+
+  bool MovePicker::next(Move &move)
+  {
+    while(true) {
+      if(_M_index < _M_move_pairs.length()) {
+        if(_M_sorting_flag) _M_move_pairs.select_sort_move(_M_index);
+        // Bad captures are tried after quiet moves.
+        if(_M_stage != MovePickerStage::QUIET_MOVES || _M_move_pairs[_M_index].score >= MOVE_SCORE_NONE) break;
+      }
+      switch(_M_stage) {
+        case MovePickerStage::BEST_MOVES:
+          // The PV move and the best move from the transposition table are tried before generating moves.
+          if(static_cast<size_t>(_M_ply) < _M_move_order.previous_pv_line().length())
+            add_best_move(_M_move_order.previous_pv_line()[_M_ply], MOVE_SCORE_PV);
+          if(_M_best_move != nullptr) add_best_move(*_M_best_move, MOVE_SCORE_BEST_MOVE);
+          _M_best_move_count = _M_move_pairs.length();
+          _M_stage = MovePickerStage::GOOD_MOVES;
+          break;
+        case MovePickerStage::GOOD_MOVES:
+        {
+          MovePairList tmp_move_pairs = _M_move_pairs.to_next_list();
+          _M_board.generate_legal_good_moves(tmp_move_pairs);
+          add_moves(tmp_move_pairs);
+          _M_stage = (_M_last_stage != MovePickerStage::GOOD_MOVES ? MovePickerStage::QUIET_MOVES : MovePickerStage::END);
+          break;
+        }
+        case MovePickerStage::QUIET_MOVES:
+        {
+          MovePairList tmp_move_pairs = _M_move_pairs.to_next_list();
+          _M_board.generate_legal_quiet_moves(tmp_move_pairs);
+          add_moves(tmp_move_pairs);
+          _M_stage = MovePickerStage::END;
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+    move = _M_move_pairs[_M_index].move;
+    _M_index++;
+    return true;
+  }
+
+  void MovePicker::rewind()
+  {
+    // Moves are already sorted after the first pass.
+    _M_index = 0;
+    _M_sorting_flag = false;
+  }
+
+  void MovePicker::add_best_move(Move move, int score)
+  {
+    if(_M_move_pairs.contain_move(move) || !_M_board.has_pseudolegal_move(move) || !_M_board.has_legal_move(move)) return;
+    _M_move_pairs.add_move_pair(MovePair(move, score));
+  }
+
+  void MovePicker::add_moves(MovePairList &move_pairs)
+  {
+    // Generated moves are moved to the end of the move list without the already tried best moves.
+    size_t length = move_pairs.length();
+    for(size_t i = 0; i < length; i++) {
+      Move move = move_pairs[i].move;
+      bool is_best_move = false;
+      for(size_t j = 0; j < _M_best_move_count; j++) {
+        if(_M_move_pairs[j].move == move) {
+          is_best_move = true;
+          break;
+        }
+      }
+      if(!is_best_move) _M_move_pairs.add_move_pair(MovePair(move, _M_move_order.move_score(move, _M_ply, _M_board, _M_evaluation_function, _M_best_move, _M_previous_move)));
+    }
+  }
+}
@@ -0,0 +1,49 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "pawn_table.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  PawnTable::PawnTable(size_t count) :
+    _M_entry_mask(0), _M_probe_count(0), _M_hit_count(0)
+  { resize(count); }
+
+  PawnTable::~PawnTable() {}
+
+  void PawnTable::resize(size_t count)
+  {
+    // The entry count is rounded down to a power of two.
+    size_t entry_count = 1;
+    while(entry_count * 2 <= count) entry_count *= 2;
+    _M_entries = unique_ptr<PawnTableEntry []>(new PawnTableEntry[entry_count]);
+    _M_entry_mask = entry_count - 1;
+    clear();
+  }
+
+  void PawnTable::clear()
+  {
+    // A zero key is the key of a board without pawns, for which the value is zero.
+    for(size_t i = 0; i <= _M_entry_mask; i++) {
+      _M_entries[i].pawn_hash_key = 0;
+      _M_entries[i].value = 0;
+    }
+    clear_counts();
+  }
+}
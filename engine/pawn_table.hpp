@@ -0,0 +1,86 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _PAWN_TABLE_HPP
+#define _PAWN_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "types.hpp"
+
+namespace peacockspider
+{
+  struct PawnTableEntry
+  {
+    HashKey pawn_hash_key;
+    int value;
+  };
+
+  const std::size_t DEFAULT_PAWN_TABLE_ENTRY_COUNT = (1024 * 1024) / sizeof(PawnTableEntry);
+
+  class PawnTable
+  {
+    std::unique_ptr<PawnTableEntry []> _M_entries;
+    std::size_t _M_entry_mask;
+    std::atomic<std::uint64_t> _M_probe_count;
+    std::atomic<std::uint64_t> _M_hit_count;
+  public:
+    PawnTable(std::size_t count = DEFAULT_PAWN_TABLE_ENTRY_COUNT);
+
+    ~PawnTable();
+
+    std::size_t entry_count() const
+    { return _M_entry_mask + 1; }
+
+    void resize(std::size_t count);
+
+    void clear();
+
+    bool retrieve(HashKey pawn_hash_key, int &value)
+    {
+      const PawnTableEntry &entry = _M_entries[pawn_hash_key & _M_entry_mask];
+      _M_probe_count.store(_M_probe_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      if(entry.pawn_hash_key != pawn_hash_key) return false;
+      _M_hit_count.store(_M_hit_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      value = entry.value;
+      return true;
+    }
+
+    void store(HashKey pawn_hash_key, int value)
+    {
+      PawnTableEntry &entry = _M_entries[pawn_hash_key & _M_entry_mask];
+      entry.pawn_hash_key = pawn_hash_key;
+      entry.value = value;
+    }
+
+    std::uint64_t probe_count() const
+    { return _M_probe_count.load(std::memory_order_relaxed); }
+
+    std::uint64_t hit_count() const
+    { return _M_hit_count.load(std::memory_order_relaxed); }
+
+    void clear_counts()
+    {
+      _M_probe_count.store(0, std::memory_order_relaxed);
+      _M_hit_count.store(0, std::memory_order_relaxed);
+    }
+  };
+}
+
+#endif
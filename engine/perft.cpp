@@ -0,0 +1,88 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "perft.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  const PerftPosition perft_positions[] = {
+    { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609 },
+    { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4078017 },
+    { "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11026307 },
+    { "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 354089 },
+    { "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 1918444 },
+    { "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594 }
+  };
+
+  const size_t perft_position_count = sizeof(perft_positions) / sizeof(perft_positions[0]);
+
+  uint64_t perft(const Board &board, int depth, MovePairList &move_pairs)
+  {
+    if(depth <= 0) return 1;
+    uint64_t nodes = 0;
+    board.generate_legal_moves(move_pairs);
+    if(depth == 1) {
+      // Counts legal moves without calling perft for the leaves.
+      nodes = move_pairs.length();
+    } else {
+      MovePairList next_move_pairs = move_pairs.to_next_list();
+      for(size_t i = 0; i < move_pairs.length(); i++) {
+        Board tmp_board;
+        board.unsafely_make_move(move_pairs[i].move, tmp_board);
+        nodes += perft(tmp_board, depth - 1, next_move_pairs);
+      }
+    }
+    return nodes;
+  }
+
+  uint64_t perft_with_undo(Board &board, int depth, MovePairList &move_pairs)
+  {
+    if(depth <= 0) return 1;
+    uint64_t nodes = 0;
+    board.generate_legal_moves(move_pairs);
+    if(depth == 1) {
+      nodes = move_pairs.length();
+    } else {
+      MovePairList next_move_pairs = move_pairs.to_next_list();
+      for(size_t i = 0; i < move_pairs.length(); i++) {
+        UndoRecord undo;
+        board.do_move(move_pairs[i].move, undo);
+        nodes += perft_with_undo(board, depth - 1, next_move_pairs);
+        board.undo_move(move_pairs[i].move, undo);
+      }
+    }
+    return nodes;
+  }
+
+  uint64_t divide(const Board &board, int depth, MovePairList &move_pairs, function<void (Move, uint64_t)> fun)
+  {
+    if(depth <= 0) return 1;
+    uint64_t nodes = 0;
+    board.generate_legal_moves(move_pairs);
+    MovePairList next_move_pairs = move_pairs.to_next_list();
+    for(size_t i = 0; i < move_pairs.length(); i++) {
+      Board tmp_board;
+      board.unsafely_make_move(move_pairs[i].move, tmp_board);
+      uint64_t move_nodes = perft(tmp_board, depth - 1, next_move_pairs);
+      fun(move_pairs[i].move, move_nodes);
+      nodes += move_nodes;
+    }
+    return nodes;
+  }
+}
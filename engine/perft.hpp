@@ -0,0 +1,48 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _PERFT_HPP
+#define _PERFT_HPP
+
+#include <cstdint>
+#include <functional>
+#include "chess.hpp"
+
+namespace peacockspider
+{
+  struct PerftPosition
+  {
+    const char *fen;
+    int depth;
+    std::uint64_t nodes;
+  };
+
+  // Positions for the perft benchmark. The node counts differ from the commonly known numbers
+  // for positions with promotions because only promotions to a queen and a knight are generated.
+  extern const PerftPosition perft_positions[];
+  extern const std::size_t perft_position_count;
+
+  // The move pair list must have a space for MAX_MOVE_COUNT move pairs for every depth.
+  std::uint64_t perft(const Board &board, int depth, MovePairList &move_pairs);
+
+  // This perft makes and unmakes moves on the same board instead of copying the board.
+  std::uint64_t perft_with_undo(Board &board, int depth, MovePairList &move_pairs);
+
+  std::uint64_t divide(const Board &board, int depth, MovePairList &move_pairs, std::function<void (Move, std::uint64_t)> fun);
+}
+
+#endif
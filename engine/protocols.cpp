@@ -15,7 +15,11 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include "perft.hpp"
 #include "protocols.hpp"
 
 using namespace std;
@@ -70,4 +74,23 @@ namespace peacockspider
       *ols << str << endl;
     }
   }
+
+  void print_perft(Engine *engine, int depth, ostream *ols)
+  {
+    Board board;
+    engine->get_board(board);
+    unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT * depth]);
+    MovePairList move_pairs(tmp_move_pairs.get(), 0);
+    auto start_time = chrono::high_resolution_clock::now();
+    uint64_t nodes = divide(board, depth, move_pairs, [ols](Move move, uint64_t move_nodes) {
+      ostringstream oss;
+      oss << move.to_can_string() << ": " << move_nodes;
+      print_line(ols, oss.str());
+    });
+    auto end_time = chrono::high_resolution_clock::now();
+    unsigned ms = chrono::duration_cast<chrono::milliseconds>(end_time - start_time).count();
+    ostringstream oss;
+    oss << "nodes " << nodes << " time " << ms << " nps " << (nodes * 1000 / (ms > 0 ? ms : 1));
+    print_line(ols, oss.str());
+  }
 }
@@ -37,6 +37,8 @@ namespace peacockspider
 
   void print_line(std::ostream *ols, const std::string &str);
 
+  void print_perft(Engine *engine, int depth, std::ostream *ols);
+
   bool xboard_loop(Engine *engine, std::ostream *ols, std::function<std::pair<bool, bool> (Engine *, const std::string &, std::ostream *)> fun);
 
   std::pair<bool, bool> uci_loop(Engine *engine, const std::string &first_cmd_line, std::ostream *ols);
@@ -30,11 +30,13 @@
 #include <utility>
 #include "chess.hpp"
 #include "eval.hpp"
+#include "pawn_table.hpp"
+#include "spinlock.hpp"
+#include "thread_pool.hpp"
 #include "transpos_table.hpp"
 
 namespace peacockspider
 {
-  class LazySMPStop;
   class ABDADAThreadCountDecrement;
 
   const int MAX_VALUE = 30000;
@@ -43,8 +45,11 @@ namespace peacockspider
   const int MOVE_SCORE_PV = 2000000000;
   const int MOVE_SCORE_BEST_MOVE = 1500000000;
   const int MOVE_SCORE_GOOD_MOVE = 1000000000;
+  const int MOVE_SCORE_KILLER_MOVE = 900000000;
+  const int MOVE_SCORE_COUNTERMOVE = 800000000;
   const int MOVE_SCORE_HISTORY = 500000000;
   const int MOVE_SCORE_NONE = 0;
+  const int MOVE_SCORE_BAD_MOVE = -1000000000;
 
   class ThinkingStopException
   {
@@ -71,6 +76,9 @@ namespace peacockspider
 
     PVLine(std::size_t max_length);
 
+    PVLine(PVLine &&pv_line) :
+      _M_moves(std::move(pv_line._M_moves)), _M_length(pv_line._M_length) {}
+
     ~PVLine();
 
     PVLine &operator=(const PVLine &pv_line);
@@ -90,20 +98,28 @@ namespace peacockspider
     { _M_moves = std::unique_ptr<Move []>(moves); }
   };
 
+  const std::size_t KILLER_MOVE_COUNT = 2;
+
   class MoveOrder
   {
     PVLine _M_previous_pv_line;
+    std::unique_ptr<Move []> _M_killer_moves;
+    std::size_t _M_max_killer_ply;
+    Move _M_countermoves[2][6][64];
     int _M_history[2][64][64];
   public:
     MoveOrder(std::size_t max_pv_line_length) :
-      _M_previous_pv_line(max_pv_line_length) {}
+      _M_previous_pv_line(max_pv_line_length), _M_killer_moves(new Move[max_pv_line_length * KILLER_MOVE_COUNT]), _M_max_killer_ply(max_pv_line_length) {}
 
-    int move_score(Move move, int ply, const Board &board, const EvaluationFunction *eval_fun, Move *best_move) const;
+    int move_score(Move move, int ply, const Board &board, const EvaluationFunction *eval_fun, Move *best_move, Move previous_move = Move(Piece::PAWN, -1, -1, PromotionPiece::NONE)) const;
 
-    void set_move_scores(MovePairList &move_pairs, int ply, const Board &board, const EvaluationFunction *eval_fun, Move *best_move) const;
+    void set_move_scores(MovePairList &move_pairs, int ply, const Board &board, const EvaluationFunction *eval_fun, Move *best_move, Move previous_move = Move(Piece::PAWN, -1, -1, PromotionPiece::NONE)) const;
     
     void clear();
 
+    const PVLine &previous_pv_line() const
+    { return _M_previous_pv_line; }
+
     void set_previous_pv_line(const PVLine &pv_line);
     
     void increase_history_for_alpha(Side side, Square from, Square to, int depth)
@@ -111,6 +127,120 @@ namespace peacockspider
     
     void increase_history_for_cutoff(Side side, Square from, Square to, int depth)
     { _M_history[side_to_index(side)][from][to] += depth * 3; }
+
+    Move killer_move(int ply, std::size_t i) const
+    { return _M_killer_moves[ply * KILLER_MOVE_COUNT + i]; }
+
+    Move countermove(Side side, Move previous_move) const
+    { return _M_countermoves[side_to_index(side)][piece_to_index(previous_move.piece())][previous_move.to()]; }
+
+    void add_cutoff_move(Move move, int ply, const Board &board, Move previous_move);
+  };
+
+  enum class MovePickerStage
+  {
+    BEST_MOVES,
+    GOOD_MOVES,
+    QUIET_MOVES,
+    END
+  };
+
+  class MovePicker
+  {
+    MovePairList &_M_move_pairs;
+    int _M_ply;
+    const Board &_M_board;
+    const MoveOrder &_M_move_order;
+    const EvaluationFunction *_M_evaluation_function;
+    Move *_M_best_move;
+    Move _M_previous_move;
+    MovePickerStage _M_stage;
+    MovePickerStage _M_last_stage;
+    std::size_t _M_best_move_count;
+    std::size_t _M_index;
+    bool _M_sorting_flag;
+  public:
+    MovePicker(MovePairList &move_pairs, int ply, const Board &board, const MoveOrder &move_order, const EvaluationFunction *eval_fun, Move *best_move, Move previous_move = Move(Piece::PAWN, -1, -1, PromotionPiece::NONE));
+
+    MovePicker(MovePairList &move_pairs, int ply, const Board &board, const MoveOrder &move_order, const EvaluationFunction *eval_fun);
+
+    bool next(Move &move);
+
+    void rewind();
+
+    bool is_first_move() const
+    { return _M_index == 1 && _M_sorting_flag; }
+
+    std::size_t move_count() const
+    { return _M_index; }
+
+    bool is_bad_move() const
+    { return _M_move_pairs[_M_index - 1].score < MOVE_SCORE_NONE; }
+  private:
+    void add_best_move(Move move, int score);
+
+    void add_moves(MovePairList &move_pairs);
+  };
+
+  const int MAX_LATE_MOVE_REDUCTION_DEPTH = 64;
+  const int MAX_LATE_MOVE_REDUCTION_MOVE_COUNT = 64;
+  const int DEFAULT_LATE_MOVE_REDUCTION_BASE = 75;
+  const int DEFAULT_LATE_MOVE_REDUCTION_DIVISOR = 225;
+
+  class LateMoveReductionTable
+  {
+    bool _M_flag;
+    int _M_base;
+    int _M_divisor;
+    int _M_reductions[MAX_LATE_MOVE_REDUCTION_DEPTH][MAX_LATE_MOVE_REDUCTION_MOVE_COUNT];
+  public:
+    LateMoveReductionTable()
+    { set(true, DEFAULT_LATE_MOVE_REDUCTION_BASE, DEFAULT_LATE_MOVE_REDUCTION_DIVISOR); }
+
+    LateMoveReductionTable(bool flag, int base, int divisor)
+    { set(flag, base, divisor); }
+
+    bool flag() const
+    { return _M_flag; }
+
+    int base() const
+    { return _M_base; }
+
+    int divisor() const
+    { return _M_divisor; }
+
+    void set(bool flag, int base, int divisor);
+
+    int reduction(int depth, std::size_t move_count) const
+    {
+      if(depth >= MAX_LATE_MOVE_REDUCTION_DEPTH) depth = MAX_LATE_MOVE_REDUCTION_DEPTH - 1;
+      if(move_count >= static_cast<std::size_t>(MAX_LATE_MOVE_REDUCTION_MOVE_COUNT)) move_count = MAX_LATE_MOVE_REDUCTION_MOVE_COUNT - 1;
+      return _M_reductions[depth][move_count];
+    }
+  };
+
+  const int REVERSE_FUTILITY_PRUNING_MAX_DEPTH = 3;
+  const int REVERSE_FUTILITY_PRUNING_MARGIN = 120;
+  const int FUTILITY_PRUNING_MAX_DEPTH = 3;
+  const int FUTILITY_PRUNING_MARGIN = 150;
+  const int RAZORING_MAX_DEPTH = 2;
+  const int RAZORING_MARGIN = 300;
+  const int DELTA_PRUNING_MARGIN = 200;
+  const int MAX_PRUNING_DEPTH = 3;
+
+  struct PruningFlags
+  {
+    bool reverse_futility_pruning;
+    bool futility_pruning;
+    bool razoring;
+    bool delta_pruning;
+    bool see_pruning;
+
+    PruningFlags() :
+      reverse_futility_pruning(true), futility_pruning(true), razoring(true), delta_pruning(true), see_pruning(true) {}
+
+    PruningFlags(bool reverse_futility_pruning, bool futility_pruning, bool razoring, bool delta_pruning, bool see_pruning) :
+      reverse_futility_pruning(reverse_futility_pruning), futility_pruning(futility_pruning), razoring(razoring), delta_pruning(delta_pruning), see_pruning(see_pruning) {}
   };
 
   class Searcher
@@ -124,12 +254,6 @@ namespace peacockspider
 
     virtual void set_board(const Board &board) = 0;
 
-    void set_time(unsigned ms);
-    
-    virtual void set_stop_time(const std::chrono::high_resolution_clock::time_point &time) = 0;
-
-    virtual void unset_stop_time() = 0;
-    
     virtual void set_stop_nodes(std::uint64_t nodes) = 0;
 
     virtual void unset_stop_nodes() = 0;
@@ -142,6 +266,8 @@ namespace peacockspider
 
     virtual int search_from_root(int alpha, int beta, int depth, const std::vector<Move> *search_moves, Move &best_move, const std::vector<Board> &boards, const Board *last_board) = 0;
 
+    virtual void finish_thinking();
+
     virtual void set_pondering_flag(bool flag) = 0;
     
     virtual void clear_thinking_stop_flag() = 0;
@@ -167,26 +293,81 @@ namespace peacockspider
     virtual unsigned thread_count() const = 0;
     
     virtual int max_quiescence_depth() const = 0;
+
+    virtual void set_pawn_table_entry_count(std::size_t count) = 0;
+
+    virtual std::uint64_t pawn_table_probe_count() const = 0;
+
+    virtual std::uint64_t pawn_table_hit_count() const = 0;
+
+    virtual std::uint64_t cutoff_count() const = 0;
+
+    virtual std::uint64_t first_move_cutoff_count() const = 0;
+
+    virtual std::size_t transposition_table_entry_count() const;
+
+    virtual void set_transposition_table_entry_count(std::size_t count);
+
+    virtual bool can_set_thread_count() const;
+
+    virtual void set_thread_count(unsigned thread_count);
+
+    virtual bool save_transposition_table(const std::string &file_name) const;
+
+    virtual bool load_transposition_table(const std::string &file_name);
+
+    virtual const LateMoveReductionTable &late_move_reduction_table() const = 0;
+
+    virtual void set_late_move_reduction_table(const LateMoveReductionTable &table) = 0;
+
+    virtual const PruningFlags &pruning_flags() const = 0;
+
+    virtual void set_pruning_flags(const PruningFlags &flags) = 0;
   };
 
   struct SearchStackElement
   {
-    Board board;
+    UndoRecord undo;
+    EvaluationAccumulator evaluation_accumulator;
     MovePairList move_pairs;
     PVLine pv_line;
+    Move move;
+  };
+
+  const std::size_t CACHE_LINE_SIZE = 64;
+  const std::uint64_t NODE_PUBLISHING_MASK = 1023;
+
+  struct NodeCounterSlot
+  {
+    // The slot is padded on both sides because the searchers aren't allocated with the cache line alignment.
+    char padding1[CACHE_LINE_SIZE];
+    std::atomic<std::uint64_t> nodes;
+    std::atomic<std::uint64_t> cutoff_count;
+    std::atomic<std::uint64_t> first_move_cutoff_count;
+    char padding2[CACHE_LINE_SIZE];
+
+    NodeCounterSlot() :
+      nodes(0), cutoff_count(0), first_move_cutoff_count(0) {}
   };
 
   class SingleSearcherBase : public Searcher
   {
   protected:
     const EvaluationFunction *_M_evaluation_function;
+    Board _M_root_board;
+    Board _M_board;
     std::unique_ptr<MovePair []> _M_move_pairs;
     std::unique_ptr<SearchStackElement []> _M_stack;
+    HashKeyHistory _M_hash_key_history;
+    PawnTable _M_pawn_table;
     int _M_max_quiescence_depth;
     MoveOrder _M_move_order;
-    std::atomic<std::uint64_t> _M_nodes;
-    bool _M_has_stop_time;
-    std::chrono::high_resolution_clock::time_point _M_stop_time;
+    LateMoveReductionTable _M_late_move_reduction_table;
+    PruningFlags _M_pruning_flags;
+    std::uint64_t _M_nodes;
+    NodeCounterSlot _M_node_counter_slot;
+    std::uint64_t _M_cutoff_count;
+    std::uint64_t _M_first_move_cutoff_count;
     bool _M_has_stop_nodes;
     std::uint64_t _M_stop_nodes;
     bool _M_pondering_flag;
@@ -194,6 +375,7 @@ namespace peacockspider
     std::atomic<bool> _M_pondering_stop_flag;
     std::atomic<bool> _M_searching_stop_flag;
     bool _M_non_stop_flag;
+    bool _M_node_reset_flag;
   
     SingleSearcherBase(const EvaluationFunction *eval_fun, int max_depth, int max_quiescence_depth);
   public:
@@ -203,10 +385,6 @@ namespace peacockspider
 
     virtual void set_board(const Board &board);
     
-    virtual void set_stop_time(const std::chrono::high_resolution_clock::time_point &time);
-
-    virtual void unset_stop_time();
-    
     virtual void set_stop_nodes(std::uint64_t nodes);
 
     virtual void unset_stop_nodes();
@@ -214,6 +392,8 @@ namespace peacockspider
     virtual void set_previous_pv_line(const PVLine &pv_line);
     
     virtual void clear();
+
+    virtual void clear_for_new_game();
     
     virtual void set_pondering_flag(bool flag);
 
@@ -238,11 +418,151 @@ namespace peacockspider
     virtual unsigned thread_count() const;
     
     virtual int max_quiescence_depth() const;
+
+    virtual void set_pawn_table_entry_count(std::size_t count);
+
+    virtual std::uint64_t pawn_table_probe_count() const;
+
+    virtual std::uint64_t pawn_table_hit_count() const;
+
+    virtual std::uint64_t cutoff_count() const;
+
+    virtual std::uint64_t first_move_cutoff_count() const;
+
+    virtual const LateMoveReductionTable &late_move_reduction_table() const;
+
+    virtual void set_late_move_reduction_table(const LateMoveReductionTable &table);
+
+    virtual const PruningFlags &pruning_flags() const;
+
+    virtual void set_pruning_flags(const PruningFlags &flags);
   protected:
     virtual void check_stop();
-    
+
+    virtual void prefetch();
+
+    void publish_nodes()
+    {
+      // The cutoff counts are published with the nodes.
+      _M_node_counter_slot.nodes.store(_M_nodes, std::memory_order_relaxed);
+      _M_node_counter_slot.cutoff_count.store(_M_cutoff_count, std::memory_order_relaxed);
+      _M_node_counter_slot.first_move_cutoff_count.store(_M_first_move_cutoff_count, std::memory_order_relaxed);
+    }
+
+    void reset_nodes()
+    {
+      _M_nodes = 0;
+      publish_nodes();
+    }
+
+    void reset_nodes_for_search()
+    {
+      // A Lazy SMP helper doesn't reset the nodes for its own iterations, because the main
+      // searcher counts the helper nodes from the start of its iteration.
+      if(_M_node_reset_flag) reset_nodes();
+    }
+
     void check_stop_for_nodes()
-    { if((_M_nodes & 1023) == 0) check_stop(); }
+    {
+      if((_M_nodes & NODE_PUBLISHING_MASK) == 0) {
+        publish_nodes();
+        check_stop();
+      }
+    }
+
+    class NodePublisher
+    {
+      SingleSearcherBase *_M_searcher;
+    public:
+      NodePublisher(SingleSearcherBase *searcher) :
+        _M_searcher(searcher) {}
+
+      ~NodePublisher()
+      { _M_searcher->publish_nodes(); }
+    };
+
+    void set_root_evaluation_accumulator()
+    { _M_evaluation_function->set_accumulator(_M_board, _M_stack[0].evaluation_accumulator); }
+
+    void do_move(Move move, int ply)
+    {
+      _M_evaluation_function->update_accumulator(_M_board, move, _M_stack[ply].evaluation_accumulator, _M_stack[ply + 1].evaluation_accumulator);
+      _M_board.do_move(move, _M_stack[ply].undo);
+      _M_stack[ply].move = move;
+    }
+
+    void undo_move(Move move, int ply)
+    { _M_board.undo_move(move, _M_stack[ply].undo); }
+
+    void do_null_move(int ply)
+    {
+      _M_stack[ply + 1].evaluation_accumulator = _M_stack[ply].evaluation_accumulator;
+      _M_board.do_null_move(_M_stack[ply].undo);
+      _M_stack[ply].move = Move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+      _M_hash_key_history.set_null_move_flag(ply + 1, true);
+    }
+
+    void undo_null_move(int ply)
+    {
+      _M_board.undo_null_move(_M_stack[ply].undo);
+      _M_hash_key_history.set_null_move_flag(ply + 1, false);
+    }
+
+    Move previous_move(int ply) const
+    { return ply > 0 ? _M_stack[ply - 1].move : Move(Piece::PAWN, -1, -1, PromotionPiece::NONE); }
+
+    void update_for_cutoff(Move move, int depth, int ply, bool is_first_move)
+    {
+      _M_move_order.increase_history_for_cutoff(_M_root_board.side(), move.from(), move.to(), depth);
+      _M_move_order.add_cutoff_move(move, ply, _M_board, previous_move(ply));
+      _M_cutoff_count++;
+      if(is_first_move) _M_first_move_cutoff_count++;
+    }
+
+    void update_for_cutoff(Move move, int depth, int ply, const MovePicker &move_picker)
+    { update_for_cutoff(move, depth, ply, move_picker.is_first_move()); }
+
+    void clear_cutoff_counts()
+    {
+      _M_cutoff_count = 0;
+      _M_first_move_cutoff_count = 0;
+      publish_nodes();
+    }
+
+    bool is_quiet_move(Move move, int ply) const
+    {
+      // This method is called after making the move. An en passant capture is a diagonal pawn move without a captured piece.
+      return !_M_stack[ply].undo.captured_piece_pair.second && (move.piece() != Piece::PAWN || (move.from() & 7) == (move.to() & 7)) && move.promotion_piece() == PromotionPiece::NONE;
+    }
+
+    int late_move_reduction(Move move, int depth, int ply, bool in_check, std::size_t move_count) const
+    {
+      // Captures, promotions, check evasions, and checking moves aren't reduced.
+      int reduction = _M_late_move_reduction_table.reduction(depth, move_count);
+      if(reduction == 0 || in_check || !is_quiet_move(move, ply) || _M_board.in_check()) return 0;
+      return reduction;
+    }
+
+    int late_move_reduction(Move move, int depth, int ply, bool in_check, const MovePicker &move_picker) const
+    { return late_move_reduction(move, depth, ply, in_check, move_picker.move_count()); }
+
+    int static_evaluation(int ply)
+    { return (*_M_evaluation_function)(_M_board, _M_stack[ply].evaluation_accumulator, _M_pawn_table); }
+
+    bool can_prune_node(int alpha, int beta, int depth, int ply, bool in_check) const
+    { return ply > 0 && !in_check && depth <= MAX_PRUNING_DEPTH && alpha > MIN_VALUE + MAX_DEPTH && beta < MAX_VALUE - MAX_DEPTH; }
+
+    bool can_use_reverse_futility_pruning(int beta, int depth, int eval_value) const
+    { return _M_pruning_flags.reverse_futility_pruning && depth <= REVERSE_FUTILITY_PRUNING_MAX_DEPTH && eval_value - REVERSE_FUTILITY_PRUNING_MARGIN * depth >= beta; }
+
+    bool can_use_razoring(int alpha, int depth, int eval_value) const
+    { return _M_pruning_flags.razoring && depth <= RAZORING_MAX_DEPTH && eval_value + RAZORING_MARGIN * depth <= alpha; }
+
+    bool is_futile_move(Move move, int alpha, int depth, int ply, int eval_value) const
+    {
+      // Captures, promotions, and checking moves aren't pruned.
+      return _M_pruning_flags.futility_pruning && depth <= FUTILITY_PRUNING_MAX_DEPTH && eval_value + FUTILITY_PRUNING_MARGIN * depth <= alpha && is_quiet_move(move, ply) && !_M_board.in_check();
+    }
 
     int quiescence_search(int alpha, int beta, int depth, int ply);
   };
@@ -277,7 +597,17 @@ namespace peacockspider
     virtual void clear();
     
     virtual void clear_for_new_game();
+
+    virtual std::size_t transposition_table_entry_count() const;
+
+    virtual void set_transposition_table_entry_count(std::size_t count);
+
+    virtual bool save_transposition_table(const std::string &file_name) const;
+
+    virtual bool load_transposition_table(const std::string &file_name);
   protected:
+    virtual void prefetch();
+
     virtual bool before(int &alpha, int &beta, int depth, int ply, int &best_value, Move &best_move);
 
     virtual void after(int alpha, int beta, int depth, int ply, int best_value, Move best_move);
@@ -315,7 +645,17 @@ namespace peacockspider
     virtual void clear();
     
     virtual void clear_for_new_game();
+
+    virtual std::size_t transposition_table_entry_count() const;
+
+    virtual void set_transposition_table_entry_count(std::size_t count);
+
+    virtual bool save_transposition_table(const std::string &file_name) const;
+
+    virtual bool load_transposition_table(const std::string &file_name);
   protected:
+    virtual void prefetch();
+
     virtual bool before(int &alpha, int &beta, int depth, int ply, int &best_value, Move &best_move);
 
     virtual void after(int alpha, int beta, int depth, int ply, int best_value, Move best_move);
@@ -323,33 +663,24 @@ namespace peacockspider
     virtual void cutoff(int alpha, int beta, int depth, int ply, int best_value, Move best_move);
   };
 
-  enum class LazySMPCommand
-  {
-    NO_COMMAND,
-    SEARCH,
-    QUIT
-  };
-
-  enum class LazySMPResult
-  {
-    NO_RESULT,
-    STOP
-  };
-
   struct LazySMPThread
   {
-    std::thread thread;
     std::unique_ptr<Searcher> searcher;
-    std::mutex mutex;
-    std::condition_variable start_condition_variable;
-    LazySMPCommand command;
-    std::condition_variable stop_condition_variable;
-    LazySMPResult result;
+    std::atomic<bool> stop_flag;
+    std::mutex completed_mutex;
+    int completed_depth;
+    int completed_value;
+    Move completed_best_move;
+    PVLine completed_pv_line;
+    std::uint64_t start_nodes;
     
     LazySMPThread() {}
     
     LazySMPThread(LazySMPThread &&thread) :
-      thread(std::move(thread.thread)), searcher(std::move(thread.searcher)), command(thread.command), result(thread.result) {}
+      searcher(std::move(thread.searcher)), stop_flag(thread.stop_flag.load()), completed_depth(thread.completed_depth), completed_value(thread.completed_value), completed_best_move(thread.completed_best_move), completed_pv_line(std::move(thread.completed_pv_line)), start_nodes(thread.start_nodes) {}
+
+    std::uint64_t nodes() const
+    { return searcher->nodes() - start_nodes; }
   };
 
   class LazySMPSingleSearcher : public SingleSearcherWithTT
@@ -386,17 +717,24 @@ namespace peacockspider
 
   class LazySMPSearcherBase : public Searcher
   {
-    friend LazySMPStop;
   protected:
+    const EvaluationFunction *_M_evaluation_function;
     TranspositionTable *_M_transposition_table;
+    std::function<Searcher *(const EvaluationFunction *, TranspositionTable *, const Searcher *, const std::vector<LazySMPThread> &, int, int)> _M_searcher_function;
+    int _M_max_depth;
+    int _M_max_quiescence_depth;
+    std::size_t _M_pawn_table_entry_count;
     std::unique_ptr<Searcher> _M_main_searcher;
     std::vector<LazySMPThread> _M_threads;
-    int _M_alpha;
-    int _M_beta;
-    int _M_depth;
-    const std::vector<Move> *_M_search_moves;
-    const std::vector<Board> *_M_boards;
-    const Board *_M_last_board;
+    ThreadPool *_M_thread_pool;
+    TaskGroup _M_task_group;
+    bool _M_are_threads_searching;
+    std::vector<Move> _M_search_moves;
+    bool _M_has_search_moves;
+    std::vector<Board> _M_boards;
+    Board _M_last_board;
+    bool _M_has_last_board;
+    PVLine _M_pv_line;
 
     LazySMPSearcherBase(const EvaluationFunction *eval_fun, TranspositionTable *transpos_table, std::function<Searcher *(const EvaluationFunction *, TranspositionTable *, const Searcher *, const std::vector<LazySMPThread> &, int, int)> fun, unsigned thread_count, int max_depth, int max_quiescence_depth);
   public:
@@ -406,10 +744,6 @@ namespace peacockspider
 
     virtual void set_board(const Board &board);
     
-    virtual void set_stop_time(const std::chrono::high_resolution_clock::time_point &time);
-
-    virtual void unset_stop_time();
-    
     virtual void set_stop_nodes(std::uint64_t nodes);
 
     virtual void unset_stop_nodes();
@@ -422,6 +756,8 @@ namespace peacockspider
 
     virtual int search_from_root(int alpha, int beta, int depth, const std::vector<Move> *search_moves, Move &best_move, const std::vector<Board> &boards, const Board *last_board);
 
+    virtual void finish_thinking();
+
     virtual void set_pondering_flag(bool flag);
     
     virtual void clear_thinking_stop_flag();
@@ -445,19 +781,48 @@ namespace peacockspider
     virtual unsigned thread_count() const;
     
     virtual int max_quiescence_depth() const;
+
+    virtual void set_pawn_table_entry_count(std::size_t count);
+
+    virtual std::uint64_t pawn_table_probe_count() const;
+
+    virtual std::uint64_t pawn_table_hit_count() const;
+
+    virtual std::uint64_t cutoff_count() const;
+
+    virtual std::uint64_t first_move_cutoff_count() const;
+
+    virtual std::size_t transposition_table_entry_count() const;
+
+    virtual void set_transposition_table_entry_count(std::size_t count);
+
+    virtual bool can_set_thread_count() const;
+
+    virtual void set_thread_count(unsigned thread_count);
+
+    virtual bool save_transposition_table(const std::string &file_name) const;
+
+    virtual bool load_transposition_table(const std::string &file_name);
+
+    virtual const LateMoveReductionTable &late_move_reduction_table() const;
+
+    virtual void set_late_move_reduction_table(const LateMoveReductionTable &table);
+
+    virtual const PruningFlags &pruning_flags() const;
+
+    virtual void set_pruning_flags(const PruningFlags &flags);
   private:
-    void stop_threads();
-  };
+    void start_threads(unsigned thread_count);
 
-  class LazySMPStop
-  {
-    LazySMPSearcherBase *_M_searcher;
-  public:
-    LazySMPStop(LazySMPSearcherBase *searcher) :
-      _M_searcher(searcher) {}
+    void quit_threads();
+
+    void search_in_thread(unsigned i);
+
+    void search_in_threads(const std::vector<Move> *search_moves, const std::vector<Board> &boards, const Board *last_board);
+
+    void stop_threads();
 
-    ~LazySMPStop()
-    { _M_searcher->stop_threads(); }
+    int vote(int alpha, int beta, int depth, int value, Move &best_move);
   };
 
   class LazySMPSearcher : public LazySMPSearcherBase
@@ -476,13 +841,6 @@ namespace peacockspider
     virtual ~LazySMPPVSSearcher();
   };
 
-  enum class ABDADACommand
-  {
-    NO_COMMAND,
-    SEARCH,
-    QUIT
-  };
-  
   enum class ABDADAResult
   {
     NO_RESULT = 0,    
@@ -514,20 +872,16 @@ namespace peacockspider
   
   struct ABDADAThread
   {
-    std::thread thread;
     std::unique_ptr<Searcher> searcher;
-    std::mutex mutex;
-    std::condition_variable start_condition_variable;
-    ABDADACommand command;
-    std::condition_variable stop_condition_variable;
     ABDADAResult result;
     int value;
     Move best_move;
     
-    ABDADAThread() {}
+    ABDADAThread() :
+      result(ABDADAResult::NO_RESULT), value(0) {}
     
     ABDADAThread(ABDADAThread &&thread) :
-      thread(std::move(thread.thread)), searcher(std::move(thread.searcher)), command(thread.command), result(thread.result), value(thread.value) {}
+      searcher(std::move(thread.searcher)), result(thread.result), value(thread.value) {}
   };
 
   class ABDADASingleSearcherBase : public SingleSearcherBase
@@ -543,19 +897,21 @@ namespace peacockspider
 
     virtual std::uint64_t all_nodes() const;
   protected:
-    virtual void decrease_thread_count(int ply);
+    virtual void prefetch();
+
+    virtual void decrease_thread_count(HashKey hash_key);
   };
 
   class ABDADAThreadCountDecrement
   {
     ABDADASingleSearcherBase *_M_searcher;
-    int _M_ply;
+    HashKey _M_hash_key;
   public:
-    ABDADAThreadCountDecrement(ABDADASingleSearcherBase *searcher, int ply) :
-      _M_searcher(searcher), _M_ply(ply) {}
+    ABDADAThreadCountDecrement(ABDADASingleSearcherBase *searcher, HashKey hash_key) :
+      _M_searcher(searcher), _M_hash_key(hash_key) {}
 
     ~ABDADAThreadCountDecrement()
-    { _M_searcher->decrease_thread_count(_M_ply); }
+    { _M_searcher->decrease_thread_count(_M_hash_key); }
   };
   
   class ABDADASingleSearcher : public ABDADASingleSearcherBase
@@ -597,8 +953,15 @@ namespace peacockspider
   class ABDADASearcherBase : public Searcher
   {
   protected:
+    const EvaluationFunction *_M_evaluation_function;
     TranspositionTable *_M_transposition_table;
+    std::function<Searcher *(const EvaluationFunction *, TranspositionTable *, const std::vector<ABDADAThread> &, int, int)> _M_searcher_function;
+    int _M_max_depth;
+    int _M_max_quiescence_depth;
+    std::size_t _M_pawn_table_entry_count;
     std::vector<ABDADAThread> _M_threads;
+    ThreadPool *_M_thread_pool;
+    TaskGroup _M_task_group;
     ABDADAThread *_M_best_thread;
     int _M_alpha;
     int _M_beta;
@@ -615,10 +978,6 @@ namespace peacockspider
 
     virtual void set_board(const Board &board);
     
-    virtual void set_stop_time(const std::chrono::high_resolution_clock::time_point &time);
-
-    virtual void unset_stop_time();
-    
     virtual void set_stop_nodes(std::uint64_t nodes);
 
     virtual void unset_stop_nodes();
@@ -654,6 +1013,42 @@ namespace peacockspider
     virtual unsigned thread_count() const;
     
     virtual int max_quiescence_depth() const;
+
+    virtual void set_pawn_table_entry_count(std::size_t count);
+
+    virtual std::uint64_t pawn_table_probe_count() const;
+
+    virtual std::uint64_t pawn_table_hit_count() const;
+
+    virtual std::uint64_t cutoff_count() const;
+
+    virtual std::uint64_t first_move_cutoff_count() const;
+
+    virtual std::size_t transposition_table_entry_count() const;
+
+    virtual void set_transposition_table_entry_count(std::size_t count);
+
+    virtual bool can_set_thread_count() const;
+
+    virtual void set_thread_count(unsigned thread_count);
+
+    virtual bool save_transposition_table(const std::string &file_name) const;
+
+    virtual bool load_transposition_table(const std::string &file_name);
+
+    virtual const LateMoveReductionTable &late_move_reduction_table() const;
+
+    virtual void set_late_move_reduction_table(const LateMoveReductionTable &table);
+
+    virtual const PruningFlags &pruning_flags() const;
+
+    virtual void set_pruning_flags(const PruningFlags &flags);
+  private:
+    void start_threads(unsigned thread_count);
+
+    void quit_threads();
+
+    void search_in_thread(unsigned i);
   };
 
   class ABDADASearcher : public ABDADASearcherBase
@@ -672,15 +1067,257 @@ namespace peacockspider
     virtual ~ABDADAPVSSearcher();
   };
 
+  const int YBWC_MIN_SPLIT_DEPTH = 4;
+
+  class YBWCCutoffException
+  {
+    char _M_x;
+  };
+
+  struct YBWCSplitPoint
+  {
+    YBWCSplitPoint *parent;
+    Board board;
+    EvaluationAccumulator evaluation_accumulator;
+    const HashKeyHistory *hash_key_history;
+    Move previous_move;
+    int depth;
+    int ply;
+    int beta;
+    bool in_check;
+    bool can_make_null_move;
+    int eval_value;
+    Move moves[MAX_MOVE_COUNT];
+    std::size_t move_counts[MAX_MOVE_COUNT];
+    std::size_t move_count;
+    Spinlock spinlock;
+    std::size_t next_move_index;
+    int alpha;
+    int best_value;
+    Move best_move;
+    PVLine pv_line;
+    unsigned thread_count;
+    std::atomic<bool> cutoff_flag;
+
+    YBWCSplitPoint(const HashKeyHistory &hash_key_history, std::size_t max_pv_length) :
+      hash_key_history(&hash_key_history), move_count(0), next_move_index(0), pv_line(max_pv_length), thread_count(0), cutoff_flag(false) {}
+  };
+
+  struct YBWCSplitPointList
+  {
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+    std::vector<YBWCSplitPoint *> split_points;
+    std::atomic<unsigned> idle_thread_count;
+    bool quit_flag;
+  };
+
+  struct YBWCThread;
+
+  class YBWCSinglePVSSearcher : public SingleSearcherBase
+  {
+    TranspositionTable *_M_transposition_table;
+    const Searcher *_M_main_searcher;
+    const std::vector<YBWCThread> &_M_threads;
+    YBWCSplitPointList &_M_split_point_list;
+    int _M_max_depth;
+    YBWCSplitPoint *_M_split_point;
+    std::uint64_t _M_split_count;
+  public:
+    YBWCSinglePVSSearcher(const EvaluationFunction *eval_fun, TranspositionTable *transpos_table, const Searcher *main_searcher, const std::vector<YBWCThread> &threads, YBWCSplitPointList &split_point_list, int max_depth, int max_quiescence_depth);
+
+    virtual ~YBWCSinglePVSSearcher();
+
+    virtual void clear();
+
+    virtual void clear_for_new_game();
+
+    virtual int search_from_root(int alpha, int beta, int depth, const std::vector<Move> *search_moves, Move &best_move, const std::vector<Board> &boards, const Board *last_board);
+
+    virtual std::uint64_t all_nodes() const;
+
+    void clear_nodes()
+    { reset_nodes(); }
+
+    void set_root_hash_keys(const std::vector<Board> &boards, const Board *last_board)
+    { _M_hash_key_history.set_root(boards, last_board); }
+
+    std::uint64_t split_count() const
+    { return _M_split_count; }
+
+    void join_split_point(YBWCSplitPoint *split_point);
+  protected:
+    virtual void check_stop();
+
+    virtual void prefetch();
+
+    virtual bool before(int &alpha, int &beta, int depth, int ply, int &best_value, Move &best_move);
+
+    virtual void after(int alpha, int beta, int depth, int ply, int best_value, Move best_move);
+
+    virtual void cutoff(int alpha, int beta, int depth, int ply, int best_value, Move best_move);
+
+    int search(int alpha, int beta, int depth, int ply, bool can_make_null_move);
+
+    bool can_split(int depth) const
+    { return depth >= YBWC_MIN_SPLIT_DEPTH && _M_split_point_list.idle_thread_count.load(std::memory_order_relaxed) > 0; }
+
+    static bool is_cutoff(const YBWCSplitPoint *split_point)
+    {
+      for(; split_point != nullptr; split_point = split_point->parent) {
+        if(split_point->cutoff_flag.load(std::memory_order_relaxed)) return true;
+      }
+      return false;
+    }
+
+    void split(int &alpha, int beta, int depth, int ply, bool in_check, bool can_make_null_move, int eval_value, int &best_value, Move &best_move, MovePicker &move_picker);
+
+    void search_split_point(YBWCSplitPoint &split_point);
+
+    void wait_for_split_point(YBWCSplitPoint &split_point);
+  };
+
+  struct YBWCThread
+  {
+    std::unique_ptr<YBWCSinglePVSSearcher> searcher;
+
+    YBWCThread() {}
+
+    YBWCThread(YBWCThread &&thread) :
+      searcher(std::move(thread.searcher)) {}
+  };
+
+  class YBWCSearcher : public Searcher
+  {
+  protected:
+    const EvaluationFunction *_M_evaluation_function;
+    TranspositionTable *_M_transposition_table;
+    int _M_max_depth;
+    int _M_max_quiescence_depth;
+    std::size_t _M_pawn_table_entry_count;
+    std::unique_ptr<YBWCSinglePVSSearcher> _M_main_searcher;
+    std::vector<YBWCThread> _M_threads;
+    ThreadPool *_M_thread_pool;
+    TaskGroup _M_task_group;
+    YBWCSplitPointList _M_split_point_list;
+  public:
+    YBWCSearcher(const EvaluationFunction *eval_fun, TranspositionTable *transpos_table, unsigned thread_count, int max_depth = MAX_DEPTH, int max_quiescence_depth = MAX_QUIESCENCE_DEPTH);
+
+    virtual ~YBWCSearcher();
+
+    virtual const Board &board() const;
+
+    virtual void set_board(const Board &board);
+    
+    virtual void set_stop_nodes(std::uint64_t nodes);
+
+    virtual void unset_stop_nodes();
+
+    virtual void set_previous_pv_line(const PVLine &pv_line);
+
+    virtual void clear();
+
+    virtual void clear_for_new_game();
+
+    virtual int search_from_root(int alpha, int beta, int depth, const std::vector<Move> *search_moves, Move &best_move, const std::vector<Board> &boards, const Board *last_board);
+
+    virtual void set_pondering_flag(bool flag);
+    
+    virtual void clear_thinking_stop_flag();
+    
+    virtual void clear_pondering_stop_flag();
+
+    virtual void clear_searching_stop_flag();
+    
+    virtual void stop_thinking();
+
+    virtual void stop_pondering();
+    
+    virtual void stop_searching();
+
+    virtual void set_non_stop_flag(bool flag);
+    
+    virtual const PVLine &pv_line() const;
+    
+    virtual std::uint64_t nodes() const;
+
+    virtual unsigned thread_count() const;
+    
+    virtual int max_quiescence_depth() const;
+
+    virtual void set_pawn_table_entry_count(std::size_t count);
+
+    virtual std::uint64_t pawn_table_probe_count() const;
+
+    virtual std::uint64_t pawn_table_hit_count() const;
+
+    virtual std::uint64_t cutoff_count() const;
+
+    virtual std::uint64_t first_move_cutoff_count() const;
+
+    std::uint64_t split_count() const;
+
+    virtual std::size_t transposition_table_entry_count() const;
+
+    virtual void set_transposition_table_entry_count(std::size_t count);
+
+    virtual bool can_set_thread_count() const;
+
+    virtual void set_thread_count(unsigned thread_count);
+
+    virtual bool save_transposition_table(const std::string &file_name) const;
+
+    virtual bool load_transposition_table(const std::string &file_name);
+
+    virtual const LateMoveReductionTable &late_move_reduction_table() const;
+
+    virtual void set_late_move_reduction_table(const LateMoveReductionTable &table);
+
+    virtual const PruningFlags &pruning_flags() const;
+
+    virtual void set_pruning_flags(const PruningFlags &flags);
+  private:
+    void start_threads(unsigned thread_count);
+
+    void quit_threads();
+
+    void search_in_thread(unsigned i);
+
+    void stop_threads();
+
+    YBWCSplitPoint *find_split_point();
+  };
+
+  class Timekeeper
+  {
+    std::thread _M_thread;
+    std::mutex _M_mutex;
+    std::condition_variable _M_condition_variable;
+    bool _M_has_deadline;
+    std::chrono::high_resolution_clock::time_point _M_deadline;
+    std::function<void ()> _M_function;
+    bool _M_has_expired;
+    bool _M_quit_flag;
+  public:
+    Timekeeper();
+
+    ~Timekeeper();
+
+    void start(const std::chrono::high_resolution_clock::time_point &deadline, std::function<void ()> fun);
+
+    bool stop();
+  };
+
   class Thinker
   {
     Searcher *_M_searcher;
+    Timekeeper _M_timekeeper;
     std::unique_ptr<MovePair> _M_move_pairs;
     int _M_depth;
     int _M_alpha;
     int _M_beta;
     int _M_value;
-    bool _M_has_second_search;
+    int _M_delta;
     bool _M_must_continue;
     bool _M_has_pondering;
     bool _M_has_best_move;
@@ -691,6 +1328,8 @@ namespace peacockspider
     Move _M_next_hint_move;
     bool _M_has_pondering_move;
     Move _M_pondering_move;
+    bool _M_has_stop_latency;
+    unsigned _M_stop_latency;
   public:
     Thinker(Searcher *searcher);
 
@@ -712,6 +1351,42 @@ namespace peacockspider
 
     void clear();
 
+    void set_pawn_table_entry_count(std::size_t count)
+    { _M_searcher->set_pawn_table_entry_count(count); }
+
+    std::size_t transposition_table_entry_count() const
+    { return _M_searcher->transposition_table_entry_count(); }
+
+    void set_transposition_table_entry_count(std::size_t count)
+    { _M_searcher->set_transposition_table_entry_count(count); }
+
+    unsigned thread_count() const
+    { return _M_searcher->thread_count(); }
+
+    bool can_set_thread_count() const
+    { return _M_searcher->can_set_thread_count(); }
+
+    void set_thread_count(unsigned thread_count)
+    { _M_searcher->set_thread_count(thread_count); }
+
+    bool save_transposition_table(const std::string &file_name) const
+    { return _M_searcher->save_transposition_table(file_name); }
+
+    bool load_transposition_table(const std::string &file_name)
+    { return _M_searcher->load_transposition_table(file_name); }
+
+    const LateMoveReductionTable &late_move_reduction_table() const
+    { return _M_searcher->late_move_reduction_table(); }
+
+    void set_late_move_reduction_table(const LateMoveReductionTable &table)
+    { _M_searcher->set_late_move_reduction_table(table); }
+
+    const PruningFlags &pruning_flags() const
+    { return _M_searcher->pruning_flags(); }
+
+    void set_pruning_flags(const PruningFlags &flags)
+    { _M_searcher->set_pruning_flags(flags); }
+
     bool has_hint_move() const
     { return _M_has_hint_move; }
 
@@ -735,15 +1410,21 @@ namespace peacockspider
       _M_has_pondering_move = _M_has_hint_move;
       _M_pondering_move = _M_hint_move;
     }
+
+    bool has_stop_latency() const
+    { return _M_has_stop_latency; }
+
+    unsigned stop_latency() const
+    { return _M_stop_latency; }
   private:
-    bool think(int max_depth, unsigned ms, const std::vector<Move> *search_moves, std::uint64_t nodes, int checkmate_move_count, Move &best_move, const std::vector<Board> &boards, const Board *last_board, std::function<void (int, int, unsigned, const Searcher *)> fun);
+    bool think(int max_depth, unsigned ms, const std::vector<Move> *search_moves, std::uint64_t nodes, int checkmate_move_count, Move &best_move, const std::vector<Board> &boards, const Board *last_board, std::function<void (int, int, ValueType, unsigned, const Searcher *)> fun);
   public:
-    bool think(int max_depth, unsigned ms, const std::vector<Move> *search_moves, std::uint64_t nodes, int checkmate_move_count, Move &best_move, const std::vector<Board> &boards, std::function<void (int, int, unsigned, const Searcher *)> fun)
+    bool think(int max_depth, unsigned ms, const std::vector<Move> *search_moves, std::uint64_t nodes, int checkmate_move_count, Move &best_move, const std::vector<Board> &boards, std::function<void (int, int, ValueType, unsigned, const Searcher *)> fun)
     { return think(max_depth, ms, search_moves, nodes, checkmate_move_count, best_move, boards, nullptr, fun); }
 
-    bool ponder(int max_depth, const std::vector<Move> *search_moves, std::uint64_t nodes, int checkmate_move_count, const std::vector<Board> &boards, std::function<void (int, int, unsigned, const Searcher *)> fun, bool is_pondering_move = true);
+    bool ponder(int max_depth, const std::vector<Move> *search_moves, std::uint64_t nodes, int checkmate_move_count, const std::vector<Board> &boards, std::function<void (int, int, ValueType, unsigned, const Searcher *)> fun, bool is_pondering_move = true);
   private:
-    bool search(int alpha, int beta, const std::vector<Move> *search_moves, Move &best_move, const std::vector<Board> &boards, const Board *last_board, std::function<void (int, int, unsigned, const Searcher *)> fun);
+    bool search(int alpha, int beta, const std::vector<Move> *search_moves, Move &best_move, const std::vector<Board> &boards, const Board *last_board, std::function<void (int, int, ValueType, unsigned, const Searcher *)> fun);
   };
 }
 
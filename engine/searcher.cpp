@@ -23,12 +23,27 @@ namespace peacockspider
 {
   Searcher::~Searcher() {}
   
-  void Searcher::set_time(unsigned ms)
-  { set_stop_time(chrono::high_resolution_clock::now() + chrono::milliseconds(ms)); }
-
   void Searcher::clear_for_new_game()
   { clear(); }
+
+  void Searcher::finish_thinking() {}
   
   uint64_t Searcher::all_nodes() const
   { return nodes(); }
+
+  size_t Searcher::transposition_table_entry_count() const
+  { return 0; }
+
+  void Searcher::set_transposition_table_entry_count(size_t count) {}
+
+  bool Searcher::can_set_thread_count() const
+  { return false; }
+
+  void Searcher::set_thread_count(unsigned thread_count) {}
+
+  bool Searcher::save_transposition_table(const string &file_name) const
+  { return false; }
+
+  bool Searcher::load_transposition_table(const string &file_name)
+  { return false; }
 }
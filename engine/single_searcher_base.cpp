@@ -25,16 +25,19 @@ namespace peacockspider
     _M_evaluation_function(eval_fun),
     _M_move_pairs(new MovePair[MAX_MOVE_COUNT * (max_depth + max_quiescence_depth)]),
     _M_stack(new SearchStackElement[max_depth + max_quiescence_depth + 1]),
+    _M_hash_key_history(max_depth + max_quiescence_depth + 1),
     _M_max_quiescence_depth(max_quiescence_depth),
     _M_move_order(max_depth + max_quiescence_depth + 1),
     _M_nodes(0),
-    _M_has_stop_time(false),
+    _M_cutoff_count(0),
+    _M_first_move_cutoff_count(0),
     _M_has_stop_nodes(false),
     _M_pondering_flag(false),
     _M_thinking_stop_flag(false),
     _M_pondering_stop_flag(false),
     _M_searching_stop_flag(false),
-    _M_non_stop_flag(false)
+    _M_non_stop_flag(false),
+    _M_node_reset_flag(true)
   {
     for(int i = 0; i < max_depth + max_quiescence_depth; i++) {
       _M_stack[i].pv_line.set_moves(new Move[max_depth + max_quiescence_depth - i]);
@@ -44,20 +47,11 @@ namespace peacockspider
   SingleSearcherBase::~SingleSearcherBase() {}
   
   const Board &SingleSearcherBase::board() const
-  { return _M_stack[0].board; }
+  { return _M_root_board; }
   
   void SingleSearcherBase::set_board(const Board &board)
-  { _M_stack[0].board = board; }
+  { _M_root_board = board; }
 
-  void SingleSearcherBase::set_stop_time(const chrono::high_resolution_clock::time_point &time)
-  {
-    _M_has_stop_time = true;
-    _M_stop_time = time;
-  }
-
-  void SingleSearcherBase::unset_stop_time()
-  { _M_has_stop_time = false; }
-  
   void SingleSearcherBase::set_stop_nodes(uint64_t nodes)
   {
     _M_has_stop_nodes = true;
@@ -71,7 +65,18 @@ namespace peacockspider
   { _M_move_order.set_previous_pv_line(pv_line); }
   
   void SingleSearcherBase::clear()
-  { _M_move_order.clear(); }
+  {
+    _M_move_order.clear();
+    _M_pawn_table.clear_counts();
+    clear_cutoff_counts();
+  }
+
+  void SingleSearcherBase::clear_for_new_game()
+  {
+    // The pawn structure values depend on the evaluation parameters that can be changed between games.
+    clear();
+    _M_pawn_table.clear();
+  }
 
   void SingleSearcherBase::set_pondering_flag(bool flag)
   { _M_pondering_flag = flag; }
@@ -101,7 +106,7 @@ namespace peacockspider
   { return _M_stack[0].pv_line; }
 
   uint64_t SingleSearcherBase::nodes() const
-  { return _M_nodes.load(); }
+  { return _M_node_counter_slot.nodes.load(memory_order_relaxed); }
 
   unsigned SingleSearcherBase::thread_count() const
   { return 1; }
@@ -109,16 +114,36 @@ namespace peacockspider
   int SingleSearcherBase::max_quiescence_depth() const
   { return _M_max_quiescence_depth; }
 
+  void SingleSearcherBase::set_pawn_table_entry_count(size_t count)
+  { _M_pawn_table.resize(count); }
+
+  uint64_t SingleSearcherBase::pawn_table_probe_count() const
+  { return _M_pawn_table.probe_count(); }
+
+  uint64_t SingleSearcherBase::pawn_table_hit_count() const
+  { return _M_pawn_table.hit_count(); }
+
+  uint64_t SingleSearcherBase::cutoff_count() const
+  { return _M_node_counter_slot.cutoff_count.load(memory_order_relaxed); }
+
+  uint64_t SingleSearcherBase::first_move_cutoff_count() const
+  { return _M_node_counter_slot.first_move_cutoff_count.load(memory_order_relaxed); }
+
+  const LateMoveReductionTable &SingleSearcherBase::late_move_reduction_table() const
+  { return _M_late_move_reduction_table; }
+
+  void SingleSearcherBase::set_late_move_reduction_table(const LateMoveReductionTable &table)
+  { _M_late_move_reduction_table = table; }
+
+  const PruningFlags &SingleSearcherBase::pruning_flags() const
+  { return _M_pruning_flags; }
+
+  void SingleSearcherBase::set_pruning_flags(const PruningFlags &flags)
+  { _M_pruning_flags = flags; }
+
   void SingleSearcherBase::check_stop()
   {
     if(!_M_non_stop_flag) {
-      auto now = chrono::high_resolution_clock::now();
-      if(_M_has_stop_time && now >= _M_stop_time) {
-        if(!_M_pondering_flag)
-          throw ThinkingStopException();
-        else
-          throw PonderingStopException();
-      }
       if(_M_has_stop_nodes && all_nodes() >= _M_stop_nodes) {
         if(!_M_pondering_flag)
           throw ThinkingStopException();
@@ -126,45 +151,52 @@ namespace peacockspider
           throw PonderingStopException();
       }
       if(!_M_pondering_flag) {
-        if(_M_thinking_stop_flag.load()) throw ThinkingStopException();
+        if(_M_thinking_stop_flag.load(memory_order_relaxed)) throw ThinkingStopException();
       } else {
-        if(_M_pondering_stop_flag.load()) throw PonderingStopException();
+        if(_M_pondering_stop_flag.load(memory_order_relaxed)) throw PonderingStopException();
       }
     }
-    if(_M_searching_stop_flag) throw SearchingStopException();
+    if(_M_searching_stop_flag.load(memory_order_relaxed)) throw SearchingStopException();
   }
 
+  void SingleSearcherBase::prefetch() {}
+
   int SingleSearcherBase::quiescence_search(int alpha, int beta, int depth, int ply)
   {
     _M_stack[ply].pv_line.clear();
     _M_nodes++;
     check_stop_for_nodes();
-    if(_M_stack[ply].board.halfmove_clock() >= 100) return 0;
+    if(_M_board.halfmove_clock() >= 100) return 0;
     if(depth <= 0) {
-      return (*_M_evaluation_function)(_M_stack[ply].board);
+      return (*_M_evaluation_function)(_M_board, _M_stack[ply].evaluation_accumulator, _M_pawn_table);
     } else {
-      int eval_value = (*_M_evaluation_function)(_M_stack[ply].board);
+      int eval_value = (*_M_evaluation_function)(_M_board, _M_stack[ply].evaluation_accumulator, _M_pawn_table);
       if(eval_value >= beta) return eval_value;
       if(eval_value > alpha) alpha = eval_value;
       if(ply == 0)
         _M_stack[ply].move_pairs = MovePairList(_M_move_pairs.get(), 0);
       else
         _M_stack[ply].move_pairs = _M_stack[ply - 1].move_pairs.to_next_list();
-      _M_stack[ply].board.generate_pseudolegal_good_moves(_M_stack[ply].move_pairs);
-      _M_move_order.set_move_scores(_M_stack[ply].move_pairs, ply, _M_stack[ply].board, _M_evaluation_function, nullptr);
+      MovePicker move_picker(_M_stack[ply].move_pairs, ply, _M_board, _M_move_order, _M_evaluation_function);
       int best_value = eval_value;
-      for(size_t i = 0; i < _M_stack[ply].move_pairs.length(); i++) {
-        _M_stack[ply].move_pairs.select_sort_move(i);
-        Move move = _M_stack[ply].move_pairs[i].move;
-        if(_M_stack[ply].board.make_move(move, _M_stack[ply + 1].board)) {
-          int value = -quiescence_search(-beta, -alpha, depth - 1, ply + 1);
-          if(value > best_value) {
-            best_value = value;
-            _M_stack[ply].pv_line.update(move, _M_stack[ply + 1].pv_line);
-            if(best_value > alpha) {
-              alpha = best_value;
-              if(best_value >= beta) return best_value;
-            }
+      Move move;
+      while(move_picker.next(move)) {
+        // Bad captures are sorted after other moves, so the rest of moves are also bad.
+        if(_M_pruning_flags.see_pruning && move_picker.is_bad_move()) break;
+        // Captures that can't raise alpha even with the margin are skipped.
+        if(_M_pruning_flags.delta_pruning && move.promotion_piece() == PromotionPiece::NONE) {
+          int captured_piece_value = (_M_board.has_color(~_M_board.side(), move.to()) ? _M_evaluation_function->piece_material_value(_M_board.piece(move.to())) : _M_evaluation_function->piece_material_value(Piece::PAWN));
+          if(eval_value + captured_piece_value + DELTA_PRUNING_MARGIN <= alpha) continue;
+        }
+        do_move(move, ply);
+        int value = -quiescence_search(-beta, -alpha, depth - 1, ply + 1);
+        undo_move(move, ply);
+        if(value > best_value) {
+          best_value = value;
+          _M_stack[ply].pv_line.update(move, _M_stack[ply + 1].pv_line);
+          if(best_value > alpha) {
+            alpha = best_value;
+            if(best_value >= beta) return best_value;
           }
         }
       }
@@ -29,21 +29,39 @@ namespace peacockspider
   void SingleSearcherWithTT::clear()
   {
     _M_move_order.clear();
+    _M_pawn_table.clear_counts();
+    clear_cutoff_counts();
     _M_transposition_table->increase_age_or_clear();
   }
 
   void SingleSearcherWithTT::clear_for_new_game()
   {
     _M_move_order.clear();
+    _M_pawn_table.clear();
     _M_transposition_table->clear();
   }
+
+  size_t SingleSearcherWithTT::transposition_table_entry_count() const
+  { return _M_transposition_table->entry_count(); }
+
+  void SingleSearcherWithTT::set_transposition_table_entry_count(size_t count)
+  { _M_transposition_table->resize(count); }
+
+  bool SingleSearcherWithTT::save_transposition_table(const string &file_name) const
+  { return _M_transposition_table->save(file_name); }
+
+  bool SingleSearcherWithTT::load_transposition_table(const string &file_name)
+  { return _M_transposition_table->load(file_name); }
   
+  void SingleSearcherWithTT::prefetch()
+  { _M_transposition_table->prefetch(_M_board.hash_key()); }
+
   bool SingleSearcherWithTT::before(int &alpha, int &beta, int depth, int ply, int &best_value, Move &best_move)
-  { return _M_transposition_table->retrieve(_M_stack[ply].board.hash_key(), alpha, beta, depth, best_value, best_move); }
+  { return _M_transposition_table->retrieve(_M_board.hash_key(), alpha, beta, depth, best_value, best_move); }
 
   void SingleSearcherWithTT::after(int alpha, int beta, int depth, int ply, int best_value, Move best_move)
-  { _M_transposition_table->store(_M_stack[ply].board.hash_key(), alpha, beta, depth, best_value, best_move); }
+  { _M_transposition_table->store(_M_board.hash_key(), alpha, beta, depth, best_value, best_move); }
 
   void SingleSearcherWithTT::cutoff(int alpha, int beta, int depth, int ply, int best_value, Move best_move)
-  { _M_transposition_table->store(_M_stack[ply].board.hash_key(), alpha, beta, depth, best_value, best_move); }
+  { _M_transposition_table->store(_M_board.hash_key(), alpha, beta, depth, best_value, best_move); }
 }
@@ -15,8 +15,11 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <random>
 #include "tables.hpp"
 
+using namespace std;
+
 namespace peacockspider
 {
   Square mailbox[120] = {
@@ -96,7 +99,112 @@ namespace peacockspider
   Bitboard tab_column_bitboards[8];
   Bitboard tab_neighbour_column_bitboards[8];
 
-  void initialize_tables()
+  Bitboard tab_between_bitboards[64][64];
+  Bitboard tab_line_bitboards[64][64];
+
+  bool tab_has_pext;
+  Bitboard tab_bishop_mask_bitboards[64];
+  Bitboard tab_bishop_magics[64];
+  int tab_bishop_shifts[64];
+  Bitboard *tab_bishop_attack_bitboards[64];
+  Bitboard tab_rook_mask_bitboards[64];
+  Bitboard tab_rook_magics[64];
+  int tab_rook_shifts[64];
+  Bitboard *tab_rook_attack_bitboards[64];
+
+  namespace
+  {
+    Bitboard bishop_attack_table[5248];
+    Bitboard rook_attack_table[102400];
+
+    bool has_pext()
+    {
+#if defined(__GNUC__) && defined(__x86_64__)
+      return __builtin_cpu_supports("bmi2");
+#else
+      return false;
+#endif
+    }
+
+    int bit_count(Bitboard bbd)
+    {
+      int count = 0;
+      for(; bbd != 0; bbd &= bbd - 1) count++;
+      return count;
+    }
+
+    template<typename _Fun>
+    Bitboard slide_attack_bitboard(Square squ, Bitboard occupied, int dir_count, _Fun fun)
+    {
+      Bitboard bbd = 0;
+      for(int i = 0; i < dir_count; i++) {
+        int count = fun(squ, i, -1);
+        for(int j = 0; j < count; j++) {
+          Square to = fun(squ, i, j);
+          bbd |= static_cast<Bitboard>(1) << to;
+          if((occupied & (static_cast<Bitboard>(1) << to)) != 0) break;
+        }
+      }
+      return bbd;
+    }
+
+    template<typename _Fun>
+    void initialize_slide_attack_bitboards(Bitboard *table, Bitboard *mask_bbds, Bitboard *magics, int *shifts, Bitboard **attack_bbds, int dir_count, bool is_pext, _Fun fun)
+    {
+      mt19937_64 generator(0x5053504944455221ULL);
+      Bitboard occupieds[4096];
+      Bitboard attacks[4096];
+      int epochs[4096];
+      Bitboard *attack_bbd = table;
+      for(Square squ = 0; squ < 64; squ++) {
+        // Edge squares of the rays don't affect attacks so they are excluded from the mask.
+        Bitboard mask_bbd = 0;
+        for(int i = 0; i < dir_count; i++) {
+          int count = fun(squ, i, -1);
+          for(int j = 0; j + 1 < count; j++) mask_bbd |= static_cast<Bitboard>(1) << fun(squ, i, j);
+        }
+        int bits = bit_count(mask_bbd);
+        int count = 1 << bits;
+        Bitboard occupied = 0;
+        for(int i = 0; i < count; i++) {
+          occupieds[i] = occupied;
+          attacks[i] = slide_attack_bitboard(squ, occupied, dir_count, fun);
+          occupied = (occupied - mask_bbd) & mask_bbd;
+        }
+        mask_bbds[squ] = mask_bbd;
+        shifts[squ] = 64 - bits;
+        attack_bbds[squ] = attack_bbd;
+        if(is_pext) {
+          magics[squ] = 0;
+          for(int i = 0; i < count; i++) attack_bbd[pext_bitboard(occupieds[i], mask_bbd)] = attacks[i];
+        } else {
+          for(int i = 0; i < count; i++) epochs[i] = 0;
+          for(int epoch = 1; true; epoch++) {
+            Bitboard magic = generator() & generator() & generator();
+            if(bit_count((mask_bbd * magic) & 0xff00000000000000ULL) < 6) continue;
+            bool is_magic = true;
+            for(int i = 0; i < count; i++) {
+              size_t idx = ((occupieds[i] & mask_bbd) * magic) >> shifts[squ];
+              if(epochs[idx] != epoch) {
+                epochs[idx] = epoch;
+                attack_bbd[idx] = attacks[i];
+              } else if(attack_bbd[idx] != attacks[i]) {
+                is_magic = false;
+                break;
+              }
+            }
+            if(is_magic) {
+              magics[squ] = magic;
+              break;
+            }
+          }
+        }
+        attack_bbd += count;
+      }
+    }
+  }
+
+  void initialize_tables(bool is_pext_enabled)
   {
     // Initializes pawn capture bitboards.
     for(int side = 0; side < 2; side++) {
@@ -277,5 +385,38 @@ namespace peacockspider
       if(col - 1 >= 0) tab_neighbour_column_bitboards[col] |= tab_column_bitboards[col - 1];
       if(col + 1 < 8) tab_neighbour_column_bitboards[col] |= tab_column_bitboards[col + 1];
     }
+    // Initializes between bitboards and line bitboards.
+    for(Square from = 0; from < 64; from++) {
+      for(Square to = 0; to < 64; to++) {
+        tab_between_bitboards[from][to] = 0;
+        tab_line_bitboards[from][to] = 0;
+      }
+      for(int i = 0; i < 8; i++) {
+        Bitboard line_bbd = static_cast<Bitboard>(1) << from;
+        for(int j = 0; j < 8; j++) {
+          if(tab_queen_steps120[j] == tab_queen_steps120[i] || tab_queen_steps120[j] == -tab_queen_steps120[i]) {
+            for(int k = 0; k < tab_queen_square_counts[from][j]; k++) {
+              line_bbd |= static_cast<Bitboard>(1) << tab_queen_squares[from][j][k];
+            }
+          }
+        }
+        Bitboard between_bbd = 0;
+        for(int k = 0; k < tab_queen_square_counts[from][i]; k++) {
+          Square to = tab_queen_squares[from][i][k];
+          tab_between_bitboards[from][to] = between_bbd;
+          tab_line_bitboards[from][to] = line_bbd;
+          between_bbd |= static_cast<Bitboard>(1) << to;
+        }
+      }
+    }
+
+    // Initializes slide attack bitboards.
+    tab_has_pext = is_pext_enabled && has_pext();
+    initialize_slide_attack_bitboards(bishop_attack_table, tab_bishop_mask_bitboards, tab_bishop_magics, tab_bishop_shifts, tab_bishop_attack_bitboards, 4, tab_has_pext, [](Square squ, int i, int j) {
+      return j != -1 ? tab_bishop_squares[squ][i][j] : tab_bishop_square_counts[squ][i];
+    });
+    initialize_slide_attack_bitboards(rook_attack_table, tab_rook_mask_bitboards, tab_rook_magics, tab_rook_shifts, tab_rook_attack_bitboards, 4, tab_has_pext, [](Square squ, int i, int j) {
+      return j != -1 ? tab_rook_squares[squ][i][j] : tab_rook_square_counts[squ][i];
+    });
   }
 }
@@ -58,7 +58,55 @@ namespace peacockspider
   extern Bitboard tab_column_bitboards[8];
   extern Bitboard tab_neighbour_column_bitboards[8];
 
-  void initialize_tables();
+  extern Bitboard tab_between_bitboards[64][64];
+  extern Bitboard tab_line_bitboards[64][64];
+
+  extern bool tab_has_pext;
+  extern Bitboard tab_bishop_mask_bitboards[64];
+  extern Bitboard tab_bishop_magics[64];
+  extern int tab_bishop_shifts[64];
+  extern Bitboard *tab_bishop_attack_bitboards[64];
+  extern Bitboard tab_rook_mask_bitboards[64];
+  extern Bitboard tab_rook_magics[64];
+  extern int tab_rook_shifts[64];
+  extern Bitboard *tab_rook_attack_bitboards[64];
+
+  void initialize_tables(bool is_pext_enabled = true);
+
+  inline Bitboard pext_bitboard(Bitboard bbd, Bitboard mask)
+  {
+#if defined(__GNUC__) && defined(__x86_64__)
+    Bitboard res;
+    __asm__("pextq %2, %1, %0" : "=r" (res) : "r" (bbd), "rm" (mask));
+    return res;
+#else
+    Bitboard res = 0;
+    for(Bitboard bit = 1; mask != 0; bit <<= 1) {
+      if((bbd & mask & -mask) != 0) res |= bit;
+      mask &= mask - 1;
+    }
+    return res;
+#endif
+  }
+
+  inline Bitboard bishop_attack_bitboard(Square squ, Bitboard occupied)
+  {
+    if(tab_has_pext)
+      return tab_bishop_attack_bitboards[squ][pext_bitboard(occupied, tab_bishop_mask_bitboards[squ])];
+    else
+      return tab_bishop_attack_bitboards[squ][((occupied & tab_bishop_mask_bitboards[squ]) * tab_bishop_magics[squ]) >> tab_bishop_shifts[squ]];
+  }
+
+  inline Bitboard rook_attack_bitboard(Square squ, Bitboard occupied)
+  {
+    if(tab_has_pext)
+      return tab_rook_attack_bitboards[squ][pext_bitboard(occupied, tab_rook_mask_bitboards[squ])];
+    else
+      return tab_rook_attack_bitboards[squ][((occupied & tab_rook_mask_bitboards[squ]) * tab_rook_magics[squ]) >> tab_rook_shifts[squ]];
+  }
+
+  inline Bitboard queen_attack_bitboard(Square squ, Bitboard occupied)
+  { return bishop_attack_bitboard(squ, occupied) | rook_attack_bitboard(squ, occupied); }
 }
 
 #endif
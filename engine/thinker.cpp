@@ -34,6 +34,7 @@ namespace peacockspider
     clear();
     unset_hint_move();
     unset_next_hint_move();
+    _M_has_stop_latency = false;
   }
 
   void Thinker::clear()
@@ -48,7 +49,7 @@ namespace peacockspider
     _M_has_pondering_move = false;
   }
 
-  bool Thinker::think(int max_depth, unsigned ms, const vector<Move> *search_moves, uint64_t nodes, int checkmate_move_count, Move &best_move, const vector<Board> &boards, const Board *last_board, function<void (int, int, unsigned, const Searcher *)> fun)
+  bool Thinker::think(int max_depth, unsigned ms, const vector<Move> *search_moves, uint64_t nodes, int checkmate_move_count, Move &best_move, const vector<Board> &boards, const Board *last_board, function<void (int, int, ValueType, unsigned, const Searcher *)> fun)
   {
     if(!_M_must_continue) {
       _M_searcher->clear();
@@ -64,7 +65,7 @@ namespace peacockspider
       _M_alpha = MIN_VALUE;
       _M_beta = MAX_VALUE;
       _M_value = 0;
-      _M_has_second_search = false;
+      _M_delta = VALUE_WINDOW;
     } else {
       if(_M_has_best_move)
         best_move = _M_best_move;
@@ -74,21 +75,30 @@ namespace peacockspider
       _M_hint_move = _M_next_hint_move;
     }
     _M_searcher->set_pondering_flag(_M_has_pondering);
-    if(ms != numeric_limits<unsigned>::max())
-      _M_searcher->set_time(ms);
-    else
-      _M_searcher->unset_stop_time();
+    _M_has_stop_latency = false;
+    bool is_timekeeping = (ms != numeric_limits<unsigned>::max());
+    auto stop_time = chrono::high_resolution_clock::now() + chrono::milliseconds(ms);
+    if(is_timekeeping) {
+      // The timekeeper raises the stop flag at the deadline, so the searcher doesn't read the clock.
+      bool has_pondering = _M_has_pondering;
+      _M_timekeeper.start(stop_time, [this, has_pondering]() {
+        if(!has_pondering)
+          _M_searcher->stop_thinking();
+        else
+          _M_searcher->stop_pondering();
+      });
+    }
     if(nodes != numeric_limits<int64_t>::max())
       _M_searcher->set_stop_nodes(nodes);
     else
       _M_searcher->unset_stop_nodes();
     for(; _M_depth <= max_depth; _M_depth++) {
-      Move tmp_best_move;
       if(checkmate_move_count > 0 ? _M_value >= MAX_VALUE - MAX_DEPTH && MAX_VALUE - _M_value <= checkmate_move_count * 2 : false) break;
-      bool is_tmp_hint_move = false;
-      Move tmp_hint_move;
-      if(!_M_has_second_search) {
-        _M_has_second_search = false;
+      bool is_stop = false;
+      while(true) {
+        Move tmp_best_move;
+        bool is_tmp_hint_move;
+        Move tmp_hint_move;
         if(!_M_has_pondering) {
           is_tmp_hint_move = _M_has_hint_move;
           tmp_hint_move = _M_hint_move;
@@ -96,28 +106,15 @@ namespace peacockspider
           is_tmp_hint_move = _M_has_next_hint_move;
           tmp_hint_move = _M_next_hint_move;
         }
-        if(!search(_M_alpha, _M_beta, search_moves, tmp_best_move, boards, last_board, fun)) break;
-        if(!_M_has_pondering) {
-          bool is_tmp_hint_move2 = _M_has_hint_move;
-          Move tmp_hint_move2 = _M_hint_move;
-          _M_has_hint_move = is_tmp_hint_move;
-          _M_hint_move = tmp_hint_move;
-          is_tmp_hint_move = is_tmp_hint_move2;
-          tmp_hint_move = tmp_hint_move2;
-        } else {
-          bool is_tmp_hint_move2 = _M_has_next_hint_move;
-          Move tmp_hint_move2 = _M_next_hint_move;
-          _M_has_next_hint_move = is_tmp_hint_move;
-          _M_next_hint_move = tmp_hint_move;
-          is_tmp_hint_move = is_tmp_hint_move2;
-          tmp_hint_move = tmp_hint_move2;
+        if(!search(_M_alpha, _M_beta, search_moves, tmp_best_move, boards, last_board, fun)) {
+          is_stop = true;
+          break;
         }
-      }
-      if(_M_value <= _M_alpha || _M_value >= _M_beta) {
-        _M_has_second_search = true;
-        if(!search(MIN_VALUE, MAX_VALUE, search_moves, best_move, boards, last_board, fun)) break;
-      } else {
-        best_move = tmp_best_move;
+        if((_M_value > _M_alpha || _M_alpha == MIN_VALUE) && (_M_value < _M_beta || _M_beta == MAX_VALUE)) {
+          best_move = tmp_best_move;
+          break;
+        }
+        // The hint move from the failed search is discarded.
         if(!_M_has_pondering) {
           _M_has_hint_move = is_tmp_hint_move;
           _M_hint_move = tmp_hint_move;
@@ -125,16 +122,34 @@ namespace peacockspider
           _M_has_next_hint_move = is_tmp_hint_move;
           _M_next_hint_move = tmp_hint_move;
         }
+        // Only the failing side of the window is widened by the growing delta.
+        if(_M_value <= _M_alpha)
+          _M_alpha = (_M_value > MIN_VALUE + MAX_DEPTH ? max(_M_value - _M_delta, MIN_VALUE) : MIN_VALUE);
+        else
+          _M_beta = (_M_value < MAX_VALUE - MAX_DEPTH ? min(_M_value + _M_delta, MAX_VALUE) : MAX_VALUE);
+        _M_delta += _M_delta / 2;
       }
-      _M_has_second_search = false;
-      _M_alpha = max(_M_value - VALUE_WINDOW, MIN_VALUE);
-      _M_beta = min(_M_value + VALUE_WINDOW, MAX_VALUE);
+      if(is_stop) break;
+      _M_delta = VALUE_WINDOW;
+      _M_alpha = max(_M_value - _M_delta, MIN_VALUE);
+      _M_beta = min(_M_value + _M_delta, MAX_VALUE);
+    }
+    _M_searcher->finish_thinking();
+    if(is_timekeeping && _M_timekeeper.stop()) {
+      auto latency = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - stop_time);
+      _M_has_stop_latency = true;
+      _M_stop_latency = latency.count();
+      // The stop flag from the timekeeper mustn't stop the next thinking.
+      if(!_M_has_pondering)
+        _M_searcher->clear_thinking_stop_flag();
+      else
+        _M_searcher->clear_pondering_stop_flag();
     }
     _M_must_continue = false;
     return true;
   }
 
-  bool Thinker::ponder(int max_depth, const vector<Move> *search_moves, uint64_t nodes, int checkmate_move_count, const vector<Board> &boards, function<void (int, int, unsigned, const Searcher *)> fun, bool is_pondering_move)
+  bool Thinker::ponder(int max_depth, const vector<Move> *search_moves, uint64_t nodes, int checkmate_move_count, const vector<Board> &boards, function<void (int, int, ValueType, unsigned, const Searcher *)> fun, bool is_pondering_move)
   {
     _M_must_continue = false;
     _M_has_pondering = true;
@@ -175,7 +190,7 @@ namespace peacockspider
     return true;
   }
 
-  bool Thinker::search(int alpha, int beta, const vector<Move> *search_moves, Move &best_move, const vector<Board> &boards, const Board *last_board, function<void (int, int, unsigned, const Searcher *)> fun)
+  bool Thinker::search(int alpha, int beta, const vector<Move> *search_moves, Move &best_move, const vector<Board> &boards, const Board *last_board, function<void (int, int, ValueType, unsigned, const Searcher *)> fun)
   {
     auto start_search_time = chrono::high_resolution_clock::now();
     _M_searcher->set_non_stop_flag(_M_depth == 1);
@@ -189,7 +204,12 @@ namespace peacockspider
     auto end_search_time = chrono::high_resolution_clock::now();
     auto diff = end_search_time - start_search_time;
     auto diff_ms = chrono::duration_cast<chrono::milliseconds>(diff);
-    fun(_M_depth, _M_value, diff_ms.count(), _M_searcher);
+    ValueType value_type = ValueType::EXACT;
+    if(_M_value <= alpha && alpha != MIN_VALUE)
+      value_type = ValueType::UPPER_BOUND;
+    else if(_M_value >= beta && beta != MAX_VALUE)
+      value_type = ValueType::LOWER_BOUND;
+    fun(_M_depth, _M_value, value_type, diff_ms.count(), _M_searcher);
     _M_searcher->set_previous_pv_line(_M_searcher->pv_line());
     if(_M_searcher->pv_line().length() >= 2) {
       if(!_M_has_pondering) {
@@ -0,0 +1,287 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "thread_pool.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  namespace
+  {
+    thread_local ThreadPool *current_thread_pool = nullptr;
+    thread_local unsigned current_worker_index = 0;
+  }
+
+  ThreadPool::ThreadPool(unsigned worker_count) :
+    _M_workers(new ThreadPoolWorker[MAX_THREAD_POOL_WORKER_COUNT]), _M_worker_count(0), _M_started_worker_count(0), _M_next_worker_index(0), _M_task_count(0), _M_sleeping_worker_count(0), _M_reserved_worker_count(0), _M_quit_flag(false)
+  { reserve(worker_count); }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      lock_guard<mutex> lock(_M_mutex);
+      _M_quit_flag = true;
+    }
+    _M_condition_variable.notify_all();
+    unsigned started_worker_count = _M_started_worker_count.load();
+    for(unsigned i = 0; i < started_worker_count; i++) {
+      if(_M_workers[i].thread.joinable()) _M_workers[i].thread.join();
+    }
+  }
+
+  void ThreadPool::reserve(unsigned worker_count)
+  {
+    lock_guard<mutex> lock(_M_mutex);
+    unsafely_reserve(worker_count);
+  }
+
+  unsigned ThreadPool::ensure(unsigned worker_count)
+  {
+    // Only the missing workers are reserved, and their number is returned for releasing them.
+    lock_guard<mutex> lock(_M_mutex);
+    unsigned missing_worker_count = worker_count - min(worker_count, _M_reserved_worker_count);
+    unsafely_reserve(missing_worker_count);
+    return missing_worker_count;
+  }
+
+  void ThreadPool::release(unsigned worker_count)
+  {
+    unique_lock<mutex> lock(_M_mutex);
+    _M_reserved_worker_count -= min(worker_count, _M_reserved_worker_count);
+    unsigned new_worker_count = min(_M_reserved_worker_count, MAX_THREAD_POOL_WORKER_COUNT);
+    if(new_worker_count < _M_worker_count.load()) retire_workers(lock, new_worker_count);
+    join_retired_workers();
+  }
+
+  void ThreadPool::submit(function<void ()> task)
+  {
+    // A task from a worker is pushed to the deque of this worker, so other workers can steal it.
+    while(true) {
+      unsigned i;
+      if(current_thread_pool == this) {
+        i = current_worker_index;
+      } else {
+        unsigned worker_count = _M_worker_count.load();
+        if(worker_count == 0) {
+          task();
+          return;
+        }
+        i = _M_next_worker_index.fetch_add(1) % worker_count;
+      }
+      lock_guard<Spinlock> lock(_M_workers[i].spinlock);
+      // The task isn't pushed to the deque of a worker that has left the pool.
+      if(_M_workers[i].is_retired) continue;
+      _M_workers[i].tasks.push_back(task);
+      break;
+    }
+    _M_task_count.fetch_add(1);
+    if(_M_sleeping_worker_count.load() > 0) {
+      lock_guard<mutex> lock(_M_mutex);
+      _M_condition_variable.notify_one();
+    }
+  }
+
+  void ThreadPool::unsafely_reserve(unsigned worker_count)
+  {
+    _M_reserved_worker_count += worker_count;
+    unsigned new_worker_count = min(_M_reserved_worker_count, MAX_THREAD_POOL_WORKER_COUNT);
+    if(new_worker_count > _M_worker_count.load()) start_workers(new_worker_count);
+  }
+
+  void ThreadPool::start_workers(unsigned worker_count)
+  {
+    for(unsigned i = _M_worker_count.load(); i < worker_count; i++) {
+      if(_M_workers[i].thread.joinable()) {
+        // A retiring worker that hasn't left yet stays in the pool, because it checks the worker
+        // count under the lock.
+        if(!_M_workers[i].is_retired) continue;
+        _M_workers[i].thread.join();
+      }
+      {
+        lock_guard<Spinlock> lock(_M_workers[i].spinlock);
+        _M_workers[i].is_retired = false;
+      }
+      _M_workers[i].thread = thread([this, i]() { run_worker(i); });
+    }
+    _M_worker_count.store(worker_count);
+    if(worker_count > _M_started_worker_count.load()) _M_started_worker_count.store(worker_count);
+  }
+
+  void ThreadPool::retire_workers(unique_lock<mutex> &lock, unsigned worker_count)
+  {
+    // The surplus workers leave after running the tasks from their deques. The idle workers are
+    // waited for, and the workers that run tasks are joined later.
+    unsigned old_worker_count = _M_worker_count.load();
+    _M_worker_count.store(worker_count);
+    _M_condition_variable.notify_all();
+    _M_retiring_condition_variable.wait(lock, [this, worker_count, old_worker_count]() {
+      for(unsigned i = worker_count; i < old_worker_count; i++) {
+        if(!_M_workers[i].is_retired && !_M_workers[i].is_running_task.load()) return false;
+      }
+      return true;
+    });
+  }
+
+  void ThreadPool::join_retired_workers()
+  {
+    // A retired worker has released the lock before it leaves, so it can be joined under the lock.
+    unsigned started_worker_count = _M_started_worker_count.load();
+    for(unsigned i = _M_worker_count.load(); i < started_worker_count; i++) {
+      if(_M_workers[i].is_retired && _M_workers[i].thread.joinable()) _M_workers[i].thread.join();
+    }
+  }
+
+  void ThreadPool::run_worker(unsigned i)
+  {
+    current_thread_pool = this;
+    current_worker_index = i;
+    ThreadPoolWorker &worker = _M_workers[i];
+    while(true) {
+      function<void ()> task;
+      bool has_task = false;
+      // The worker spins for a while before sleeping. The flag of a running task is set before
+      // checking the worker count, so that a release doesn't wait for a worker that takes a task.
+      for(unsigned j = 0; j < THREAD_POOL_SPIN_COUNT && !has_task; j++) {
+        worker.is_running_task.store(true);
+        bool is_retiring = (i >= _M_worker_count.load());
+        has_task = pop_task(i, task, !is_retiring);
+        if(has_task) break;
+        worker.is_running_task.store(false);
+        if(is_retiring) break;
+        this_thread::yield();
+      }
+      if(has_task) {
+        task();
+        worker.is_running_task.store(false);
+        continue;
+      }
+      unique_lock<mutex> lock(_M_mutex);
+      if(i >= _M_worker_count.load()) {
+        // A retiring worker leaves only with an empty deque, so that no task is lost.
+        {
+          lock_guard<Spinlock> spinlock_lock(worker.spinlock);
+          worker.is_retired = worker.tasks.empty();
+        }
+        if(worker.is_retired) {
+          _M_retiring_condition_variable.notify_all();
+          break;
+        }
+        continue;
+      }
+      _M_sleeping_worker_count.fetch_add(1);
+      while(!_M_quit_flag && _M_task_count.load() == 0 && i < _M_worker_count.load()) {
+        _M_condition_variable.wait(lock);
+      }
+      _M_sleeping_worker_count.fetch_sub(1);
+      if(_M_quit_flag && _M_task_count.load() == 0) break;
+    }
+  }
+
+  bool ThreadPool::pop_task(unsigned i, function<void ()> &task, bool can_steal)
+  {
+    if(_M_task_count.load() == 0) return false;
+    {
+      lock_guard<Spinlock> lock(_M_workers[i].spinlock);
+      if(!_M_workers[i].tasks.empty()) {
+        task = move(_M_workers[i].tasks.back());
+        _M_workers[i].tasks.pop_back();
+        _M_task_count.fetch_sub(1);
+        return true;
+      }
+    }
+    if(!can_steal) return false;
+    // The tasks are also stolen from the retiring workers.
+    unsigned started_worker_count = _M_started_worker_count.load();
+    for(unsigned j = 1; j < started_worker_count; j++) {
+      unsigned k = (i + j) % started_worker_count;
+      lock_guard<Spinlock> lock(_M_workers[k].spinlock);
+      if(!_M_workers[k].tasks.empty()) {
+        task = move(_M_workers[k].tasks.front());
+        _M_workers[k].tasks.pop_front();
+        _M_task_count.fetch_sub(1);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void TaskGroup::run(ThreadPool &pool, function<void ()> task)
+  {
+    shared_ptr<TaskGroupTask> group_task(new TaskGroupTask(task));
+    {
+      lock_guard<mutex> lock(_M_mutex);
+      _M_tasks.push_back(group_task);
+      _M_task_count++;
+      _M_condition_variable.notify_all();
+    }
+    // The task is run by a worker or by the waiting thread, whichever takes it first. The group
+    // isn't touched by a taken task, because the group can be destroyed after waiting.
+    pool.submit([this, group_task]() {
+      if(!group_task->is_taken.exchange(true)) run_task(*group_task);
+    });
+  }
+
+  void TaskGroup::wait()
+  {
+    // The waiting thread runs only the tasks of this group, so a group that is waited for by a
+    // task doesn't deadlock when all workers wait, and the waiting thread doesn't run unrelated
+    // long tasks.
+    unique_lock<mutex> lock(_M_mutex);
+    while(_M_task_count > 0) {
+      shared_ptr<TaskGroupTask> task;
+      while(!_M_tasks.empty() && task == nullptr) {
+        if(!_M_tasks.front()->is_taken.exchange(true)) task = _M_tasks.front();
+        _M_tasks.pop_front();
+      }
+      if(task != nullptr) {
+        lock.unlock();
+        run_task(*task);
+        lock.lock();
+      } else
+        _M_condition_variable.wait(lock);
+    }
+    _M_tasks.clear();
+    if(_M_exception != nullptr) {
+      exception_ptr exception = _M_exception;
+      _M_exception = nullptr;
+      rethrow_exception(exception);
+    }
+  }
+
+  void TaskGroup::run_task(TaskGroupTask &task)
+  {
+    // An exception from the task is rethrown by the waiting thread, so the task is always
+    // counted as finished.
+    exception_ptr exception;
+    try {
+      task.fun();
+    } catch(...) {
+      exception = current_exception();
+    }
+    lock_guard<mutex> lock(_M_mutex);
+    if(exception != nullptr && _M_exception == nullptr) _M_exception = exception;
+    _M_task_count--;
+    if(_M_task_count == 0) _M_condition_variable.notify_all();
+  }
+
+  ThreadPool &shared_thread_pool()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+}
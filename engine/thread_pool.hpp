@@ -0,0 +1,121 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _THREAD_POOL_HPP
+#define _THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "spinlock.hpp"
+
+namespace peacockspider
+{
+  const unsigned MAX_THREAD_POOL_WORKER_COUNT = 1024;
+  const unsigned THREAD_POOL_SPIN_COUNT = 1024;
+
+  struct ThreadPoolWorker
+  {
+    std::thread thread;
+    Spinlock spinlock;
+    std::deque<std::function<void ()>> tasks;
+    std::atomic<bool> is_running_task;
+    bool is_retired;
+
+    ThreadPoolWorker() :
+      is_running_task(false), is_retired(false) {}
+  };
+
+  class ThreadPool
+  {
+    std::unique_ptr<ThreadPoolWorker []> _M_workers;
+    std::atomic<unsigned> _M_worker_count;
+    std::atomic<unsigned> _M_started_worker_count;
+    std::atomic<unsigned> _M_next_worker_index;
+    std::atomic<std::size_t> _M_task_count;
+    std::atomic<unsigned> _M_sleeping_worker_count;
+    std::mutex _M_mutex;
+    std::condition_variable _M_condition_variable;
+    std::condition_variable _M_retiring_condition_variable;
+    unsigned _M_reserved_worker_count;
+    bool _M_quit_flag;
+  public:
+    ThreadPool(unsigned worker_count = 0);
+
+    ~ThreadPool();
+
+    unsigned worker_count() const
+    { return _M_worker_count.load(); }
+
+    void reserve(unsigned worker_count);
+
+    unsigned ensure(unsigned worker_count);
+
+    void release(unsigned worker_count);
+
+    void submit(std::function<void ()> task);
+  private:
+    void unsafely_reserve(unsigned worker_count);
+
+    void start_workers(unsigned worker_count);
+
+    void retire_workers(std::unique_lock<std::mutex> &lock, unsigned worker_count);
+
+    void join_retired_workers();
+
+    void run_worker(unsigned i);
+
+    bool pop_task(unsigned i, std::function<void ()> &task, bool can_steal);
+  };
+
+  struct TaskGroupTask
+  {
+    std::function<void ()> fun;
+    std::atomic<bool> is_taken;
+
+    TaskGroupTask(std::function<void ()> fun) :
+      fun(fun), is_taken(false) {}
+  };
+
+  class TaskGroup
+  {
+    std::mutex _M_mutex;
+    std::condition_variable _M_condition_variable;
+    std::deque<std::shared_ptr<TaskGroupTask>> _M_tasks;
+    unsigned _M_task_count;
+    std::exception_ptr _M_exception;
+  public:
+    TaskGroup() :
+      _M_task_count(0) {}
+
+    void run(ThreadPool &pool, std::function<void ()> task);
+
+    void wait();
+  private:
+    void run_task(TaskGroupTask &task);
+  };
+
+  ThreadPool &shared_thread_pool();
+}
+
+#endif
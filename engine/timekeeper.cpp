@@ -0,0 +1,73 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "search.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  Timekeeper::Timekeeper() :
+    _M_has_deadline(false), _M_has_expired(false), _M_quit_flag(false)
+  {
+    _M_thread = thread([this]() {
+      unique_lock<mutex> lock(_M_mutex);
+      while(!_M_quit_flag) {
+        if(!_M_has_deadline) {
+          _M_condition_variable.wait(lock);
+          continue;
+        }
+        _M_condition_variable.wait_until(lock, _M_deadline);
+        // The function is called with the locked mutex, so it isn't called after stopping.
+        if(_M_has_deadline && chrono::high_resolution_clock::now() >= _M_deadline) {
+          _M_has_deadline = false;
+          _M_has_expired = true;
+          _M_function();
+        }
+      }
+    });
+  }
+
+  Timekeeper::~Timekeeper()
+  {
+    {
+      lock_guard<mutex> lock(_M_mutex);
+      _M_quit_flag = true;
+    }
+    _M_condition_variable.notify_one();
+    _M_thread.join();
+  }
+
+  void Timekeeper::start(const chrono::high_resolution_clock::time_point &deadline, function<void ()> fun)
+  {
+    {
+      lock_guard<mutex> lock(_M_mutex);
+      _M_has_deadline = true;
+      _M_deadline = deadline;
+      _M_function = fun;
+      _M_has_expired = false;
+    }
+    _M_condition_variable.notify_one();
+  }
+
+  bool Timekeeper::stop()
+  {
+    lock_guard<mutex> lock(_M_mutex);
+    _M_has_deadline = false;
+    return _M_has_expired;
+  }
+}
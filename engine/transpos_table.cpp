@@ -15,32 +15,181 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <mutex>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <new>
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 #include "search.hpp"
+#include "thread_pool.hpp"
 #include "transpos_table.hpp"
+#include "zobrist.hpp"
 
 using namespace std;
 
 namespace peacockspider
 {
-  TranspositionTable::TranspositionTable(size_t count) :
-    _M_entries(new TranspositionTableEntry[count]), _M_entry_count(count), _M_age(0) {}
+  ABDADATable::ABDADATable(size_t count) :
+    _M_entries(new atomic<uint64_t>[count]), _M_entry_mask(count - 1)
+  { clear(); }
 
-  TranspositionTable::~TranspositionTable() {}
+  ABDADATable::~ABDADATable() {}
 
-  void TranspositionTable::clear()
+  void ABDADATable::clear()
+  {
+    for(size_t i = 0; i <= _M_entry_mask; i++) {
+      _M_entries[i].store(0, memory_order_relaxed);
+    }
+  }
+
+  bool ABDADATable::try_increase_thread_count(HashKey hash_key, bool is_exclusive)
+  {
+    // An entry has the high bits of the hash key and the thread count in the low 16 bits. If
+    // the entry is used by other node, the node isn't marked.
+    atomic<uint64_t> &entry = _M_entries[hash_key & _M_entry_mask];
+    uint64_t tag = hash_key & ~static_cast<uint64_t>(0xffff);
+    uint64_t old_entry = entry.load(memory_order_relaxed);
+    while(true) {
+      uint64_t thread_count = old_entry & 0xffff;
+      uint64_t new_entry;
+      if(thread_count == 0)
+        new_entry = tag | 1;
+      else if((old_entry & ~static_cast<uint64_t>(0xffff)) == tag) {
+        if(is_exclusive) return false;
+        if(thread_count == 0xffff) return true;
+        new_entry = old_entry + 1;
+      } else
+        return true;
+      if(entry.compare_exchange_weak(old_entry, new_entry, memory_order_relaxed)) return true;
+    }
+  }
+
+  void ABDADATable::decrease_thread_count(HashKey hash_key)
   {
-    for(size_t i = 0; i < _M_entry_count; i++) {
-      _M_entries[i].set_hash_key(0);
-      _M_entries[i].set_value_type(ValueType::NONE);
-      _M_entries[i].set_thread_count(0);
-      _M_entries[i].set_age(0);
+    atomic<uint64_t> &entry = _M_entries[hash_key & _M_entry_mask];
+    uint64_t tag = hash_key & ~static_cast<uint64_t>(0xffff);
+    uint64_t old_entry = entry.load(memory_order_relaxed);
+    while((old_entry & ~static_cast<uint64_t>(0xffff)) == tag && (old_entry & 0xffff) != 0) {
+      if(entry.compare_exchange_weak(old_entry, old_entry - 1, memory_order_relaxed)) break;
     }
+  }
+
+  TranspositionTable::TranspositionTable(size_t count, unsigned thread_count) :
+    _M_memory(nullptr), _M_memory_size(0), _M_has_mapped_memory(false), _M_is_loaded(false), _M_thread_count(thread_count > 0 ? thread_count : 1)
+  { resize(count); }
+
+  TranspositionTable::~TranspositionTable()
+  { deallocate(); }
+
+  void TranspositionTable::resize(size_t count)
+  {
+    // The bucket count is rounded down to a power of two.
+    size_t bucket_count = 1;
+    while(bucket_count * 2 * TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT <= count) bucket_count *= 2;
+    deallocate();
+    allocate(bucket_count);
+    clear_buckets(true);
     _M_age = 0;
+    _M_is_loaded = false;
+    _M_abdada_table.clear();
+  }
+
+  void TranspositionTable::allocate(size_t bucket_count)
+  {
+    size_t size = bucket_count * sizeof(TranspositionTableBucket);
+    _M_bucket_mask = bucket_count - 1;
+#ifdef __unix__
+    // Huge pages are tried first, then transparent huge pages and then normal pages.
+    size_t huge_page_size = 2 * 1024 * 1024;
+    size_t mapped_size = (size + huge_page_size - 1) & ~(huge_page_size - 1);
+    void *ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    ptr = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if(ptr == MAP_FAILED) {
+      ptr = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+      if(ptr != MAP_FAILED) madvise(ptr, mapped_size, MADV_HUGEPAGE);
+#endif
+    }
+    if(ptr != MAP_FAILED) {
+      _M_memory = ptr;
+      _M_memory_size = mapped_size;
+      _M_has_mapped_memory = true;
+      _M_buckets = reinterpret_cast<TranspositionTableBucket *>(ptr);
+      return;
+    }
+#endif
+    _M_memory = new char[size + alignof(TranspositionTableBucket)];
+    _M_memory_size = size + alignof(TranspositionTableBucket);
+    _M_has_mapped_memory = false;
+    uintptr_t address = reinterpret_cast<uintptr_t>(_M_memory);
+    address = (address + alignof(TranspositionTableBucket) - 1) & ~static_cast<uintptr_t>(alignof(TranspositionTableBucket) - 1);
+    _M_buckets = reinterpret_cast<TranspositionTableBucket *>(address);
+  }
+
+  void TranspositionTable::deallocate()
+  {
+#ifdef __unix__
+    if(_M_has_mapped_memory) {
+      munmap(_M_memory, _M_memory_size);
+      _M_memory = nullptr;
+      _M_has_mapped_memory = false;
+      return;
+    }
+#endif
+    delete [] static_cast<char *>(_M_memory);
+    _M_memory = nullptr;
+  }
+
+  void TranspositionTable::clear_buckets(bool must_construct)
+  {
+    // The buckets are split between the workers of the shared thread pool. The table isn't
+    // placed on NUMA nodes, because the searcher threads are run by any worker of the pool.
+    auto fun = [this, must_construct](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++) {
+        if(must_construct) new(&_M_buckets[i]) TranspositionTableBucket();
+        for(atomic<uint64_t> &word : _M_buckets[i].words) {
+          word.store(0, memory_order_relaxed);
+        }
+      }
+    };
+    size_t bucket_count = _M_bucket_mask + 1;
+    size_t thread_count = min(static_cast<size_t>(_M_thread_count), max(bucket_count / MIN_TRANSPOSITION_TABLE_BUCKET_COUNT_PER_THREAD, static_cast<size_t>(1)));
+    ThreadPool &pool = shared_thread_pool();
+    // The workers that are reserved by the searcher are used if there are enough of them.
+    unsigned reserved_worker_count = pool.ensure(thread_count - 1);
+    TaskGroup task_group;
+    for(size_t i = 1; i < thread_count; i++) {
+      size_t begin = (bucket_count * i) / thread_count;
+      size_t end = (bucket_count * (i + 1)) / thread_count;
+      task_group.run(pool, [fun, begin, end]() { fun(begin, end); });
+    }
+    fun(0, bucket_count / thread_count);
+    task_group.wait();
+    pool.release(reserved_worker_count);
+  }
+
+  void TranspositionTable::clear()
+  {
+    // A loaded table is kept by the first clearing, because the engine clears the table for a
+    // new game before the first search.
+    if(!_M_is_loaded) {
+      clear_buckets(false);
+      _M_age = 0;
+    }
+    _M_is_loaded = false;
+    _M_abdada_table.clear();
   }
  
   void TranspositionTable::increase_age_or_clear()
   {
+    _M_is_loaded = false;
     _M_age++;
     if(_M_age == 0) {
       clear();
@@ -48,109 +197,241 @@ namespace peacockspider
     }
   }
 
-  bool TranspositionTable::retrieve(HashKey hash_key, int &alpha, int &beta, int depth, int &best_value, Move &best_move)
+  bool TranspositionTable::save(const string &file_name) const
   {
-    size_t i = hash_key % _M_entry_count;
-    lock_guard<Spinlock> guard(_M_entries[i].spinlock());
-    return unsafely_retrieve(hash_key, i, alpha, beta, depth, best_value, best_move) == RetrieveResult::SUCCESS;
+    // The table is written to a temporary file which replaces the file, because the old file
+    // can be mapped by other table.
+    string tmp_file_name = file_name + ".tmp";
+    ofstream ofs(tmp_file_name, ios_base::out | ios_base::binary | ios_base::trunc);
+    if(!ofs.good()) return false;
+    TranspositionTableFileHeader header;
+    header.magic = TRANSPOSITION_TABLE_FILE_MAGIC;
+    header.version = TRANSPOSITION_TABLE_FILE_VERSION;
+    header.entry_size = sizeof(TranspositionTableEntry);
+    header.bucket_size = sizeof(TranspositionTableBucket);
+    header.bucket_entry_count = TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT;
+    header.bucket_count = _M_bucket_mask + 1;
+    header.zobrist_seed = current_zobrist_seed;
+    header.age = TRANSPOSITION_TABLE_FILE_AGE;
+    header.reserved = 0;
+    unique_ptr<char []> header_data(new char[TRANSPOSITION_TABLE_FILE_HEADER_SIZE]());
+    memcpy(header_data.get(), &header, sizeof(TranspositionTableFileHeader));
+    ofs.write(header_data.get(), TRANSPOSITION_TABLE_FILE_HEADER_SIZE);
+    // The entries of the current age are saved with the age of the file and the other entries
+    // are saved as empty entries, so that the saved ages don't depend on the age of the table.
+    // The buckets are written from plain words, because an array of aligned buckets would need
+    // the aligned new of C++17.
+    size_t bucket_count = _M_bucket_mask + 1;
+    size_t bucket_word_count = TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT * 2;
+    unique_ptr<uint64_t []> tmp_words(new uint64_t[TRANSPOSITION_TABLE_FILE_BUCKET_COUNT_PER_WRITE * bucket_word_count]);
+    for(size_t i = 0; i < bucket_count && ofs.good(); i += TRANSPOSITION_TABLE_FILE_BUCKET_COUNT_PER_WRITE) {
+      size_t tmp_bucket_count = min(bucket_count - i, TRANSPOSITION_TABLE_FILE_BUCKET_COUNT_PER_WRITE);
+      for(size_t j = 0; j < tmp_bucket_count; j++) {
+        for(size_t k = 0; k < TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT; k++) {
+          TranspositionTableEntry entry;
+          uint64_t *entry_words = &tmp_words[j * bucket_word_count + k * 2];
+          _M_buckets[i + j].load(k, entry);
+          if(entry.age() == _M_age && entry.value_type() != ValueType::NONE) {
+            entry.set_age(TRANSPOSITION_TABLE_FILE_AGE);
+            TranspositionTableBucket::entry_to_words(entry, entry_words);
+          } else {
+            entry_words[0] = 0;
+            entry_words[1] = 0;
+          }
+        }
+      }
+      ofs.write(reinterpret_cast<const char *>(tmp_words.get()), tmp_bucket_count * sizeof(TranspositionTableBucket));
+    }
+    ofs.close();
+    if(ofs.fail() || rename(tmp_file_name.c_str(), file_name.c_str()) != 0) {
+      remove(tmp_file_name.c_str());
+      return false;
+    }
+    return true;
   }
-  
-  bool TranspositionTable::retrieve_for_abdada(HashKey hash_key, int &alpha, int &beta, int depth, int &best_value, Move &best_move, bool is_exclusive)
+
+  bool TranspositionTable::load(const string &file_name)
   {
-    size_t i = hash_key % _M_entry_count;
-    lock_guard<Spinlock> guard(_M_entries[i].spinlock());
-    switch(unsafely_retrieve(hash_key, i, alpha, beta, depth, best_value, best_move)) {
-      case RetrieveResult::SUCCESS:
+    TranspositionTableFileHeader header;
+    if(!read_file_header(file_name, header)) return false;
+    if(header.zobrist_seed != current_zobrist_seed) return false;
+    size_t size = header.bucket_count * sizeof(TranspositionTableBucket);
+    ifstream ifs(file_name, ios_base::in | ios_base::binary);
+    if(!ifs.good()) return false;
+    ifs.seekg(0, ios_base::end);
+    if(ifs.fail() || static_cast<uint64_t>(ifs.tellg()) < TRANSPOSITION_TABLE_FILE_HEADER_SIZE + size) return false;
+#ifdef __unix__
+    // The file is privately mapped, so pages are lazily read from the page cache and changes of
+    // the table aren't written to the file.
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if(fd != -1) {
+      void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, TRANSPOSITION_TABLE_FILE_HEADER_SIZE);
+      close(fd);
+      if(ptr != MAP_FAILED) {
+        deallocate();
+        _M_memory = ptr;
+        _M_memory_size = size;
+        _M_has_mapped_memory = true;
+        _M_buckets = reinterpret_cast<TranspositionTableBucket *>(ptr);
+        _M_bucket_mask = header.bucket_count - 1;
+        set_age_for_loaded_entries(header.age);
+        _M_is_loaded = true;
+        _M_abdada_table.clear();
         return true;
-      case RetrieveResult::FULL_FAILURE:
-        _M_entries[i].set_value_type(ValueType::UNSET);
-        _M_entries[i].set_age(_M_age);
-      case RetrieveResult::PARTIAL_FAILURE:
-        if(!(is_exclusive && _M_entries[i].thread_count() > 0)) {
-          _M_entries[i].increase_thread_count();
-          return false;
-        } else {
-          best_value = VALUE_ON_EVALUATION;
-          return true;
-        }
-        break;
+      }
     }
-    return false;
+#endif
+    resize(header.bucket_count * TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT);
+    ifs.seekg(TRANSPOSITION_TABLE_FILE_HEADER_SIZE);
+    ifs.read(reinterpret_cast<char *>(_M_buckets), size);
+    if(ifs.fail()) {
+      clear();
+      return false;
+    }
+    set_age_for_loaded_entries(header.age);
+    _M_is_loaded = true;
+    return true;
+  }
+
+  bool TranspositionTable::read_file_header(const string &file_name, TranspositionTableFileHeader &header)
+  {
+    ifstream ifs(file_name, ios_base::in | ios_base::binary);
+    if(!ifs.good()) return false;
+    ifs.read(reinterpret_cast<char *>(&header), sizeof(TranspositionTableFileHeader));
+    if(ifs.fail()) return false;
+    // The magic number also checks the byte order.
+    if(header.magic != TRANSPOSITION_TABLE_FILE_MAGIC) return false;
+    if(header.version != TRANSPOSITION_TABLE_FILE_VERSION) return false;
+    if(header.entry_size != sizeof(TranspositionTableEntry)) return false;
+    if(header.bucket_size != sizeof(TranspositionTableBucket)) return false;
+    if(header.bucket_entry_count != TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT) return false;
+    if(header.bucket_count == 0 || (header.bucket_count & (header.bucket_count - 1)) != 0) return false;
+    if(header.age == 0 || header.age > 0xffff) return false;
+    return true;
   }
 
-  RetrieveResult TranspositionTable::unsafely_retrieve(HashKey hash_key, size_t i, int &alpha, int &beta, int depth, int &best_value, Move &best_move)
+  void TranspositionTable::set_age_for_loaded_entries(uint16_t age)
+  {
+    // The age is set before the age of the saved entries, so that the entries are used by the
+    // next search after increasing the age.
+    _M_age = age - 1;
+  }
+
+  bool TranspositionTable::retrieve(HashKey hash_key, int &alpha, int &beta, int depth, int &best_value, Move &best_move)
   {
+    size_t i;
+    TranspositionTableEntry entry;
     best_move = Move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
-    if(_M_entries[i].age() == _M_age && _M_entries[i].value_type() != ValueType::NONE && _M_entries[i].value_type() != ValueType::UNSET && _M_entries[i].hash_key() == hash_key) {
-      best_move = _M_entries[i].best_move();
-      if(_M_entries[i].depth() >= depth) {
-        switch(_M_entries[i].value_type()) {
-          case ValueType::EXACT:
-            best_value = unsafe_value_for_checkmate(i, depth);
-            return RetrieveResult::SUCCESS;
-          case ValueType::UPPER_BOUND:
-          {
-            int value = unsafe_value_for_checkmate(i, depth);
-            if(value <= alpha) {
-              best_value = value;
-              return RetrieveResult::SUCCESS;
-            }
-            if(value < beta) beta = value;
-            break;
+    if(!find_entry(bucket(hash_key), hash_key, i, entry)) return false;
+    best_move = entry.best_move();
+    if(entry.depth() >= depth) {
+      switch(entry.value_type()) {
+        case ValueType::EXACT:
+          best_value = value_for_checkmate(entry, depth);
+          return true;
+        case ValueType::UPPER_BOUND:
+        {
+          int value = value_for_checkmate(entry, depth);
+          if(value <= alpha) {
+            best_value = value;
+            return true;
           }
-          case ValueType::LOWER_BOUND:
-          {
-            int value = unsafe_value_for_checkmate(i, depth);
-            if(value >= beta) {
-              best_value = value;
-              return RetrieveResult::SUCCESS;
-            }
-            if(value > alpha) alpha = value;
-            break;
+          if(value < beta) beta = value;
+          break;
+        }
+        case ValueType::LOWER_BOUND:
+        {
+          int value = value_for_checkmate(entry, depth);
+          if(value >= beta) {
+            best_value = value;
+            return true;
           }
-          default:
-            break;
+          if(value > alpha) alpha = value;
+          break;
         }
+        default:
+          break;
       }
-      return RetrieveResult::PARTIAL_FAILURE;
     }
-    return (_M_entries[i].age() == _M_age && _M_entries[i].value_type() == ValueType::UNSET) ? RetrieveResult::PARTIAL_FAILURE : RetrieveResult::FULL_FAILURE;
+    return false;
+  }
+  
+  bool TranspositionTable::retrieve_for_abdada(HashKey hash_key, int &alpha, int &beta, int depth, int &best_value, Move &best_move, bool is_exclusive)
+  {
+    if(retrieve(hash_key, alpha, beta, depth, best_value, best_move)) return true;
+    if(!_M_abdada_table.try_increase_thread_count(hash_key, is_exclusive)) {
+      best_value = VALUE_ON_EVALUATION;
+      return true;
+    }
+    return false;
   }
 
   bool TranspositionTable::store(HashKey hash_key, int alpha, int beta, int depth, int best_value, Move best_move)
   {
-    size_t i = hash_key % _M_entry_count;
-    lock_guard<Spinlock> guard(_M_entries[i].spinlock());
-    _M_entries[i].set_hash_key(hash_key);
-    _M_entries[i].set_depth(depth);
-    _M_entries[i].set_value(best_value);
-    _M_entries[i].set_best_move(best_move);
+    TranspositionTableBucket &bucket = this->bucket(hash_key);
+    size_t i;
+    TranspositionTableEntry entry;
+    if(!find_entry(bucket, hash_key, i, entry)) {
+      i = find_entry_to_replace(bucket);
+      entry.set_partial_hash_key(partial_hash_key(hash_key));
+    }
+    entry.set_depth(depth);
+    entry.set_value(best_value);
+    entry.set_best_move(best_move);
     if(best_value > alpha && best_value < beta)
-      _M_entries[i].set_value_type(ValueType::EXACT);
+      entry.set_value_type(ValueType::EXACT);
     else if(best_value <= alpha)
-      _M_entries[i].set_value_type(ValueType::UPPER_BOUND);
+      entry.set_value_type(ValueType::UPPER_BOUND);
     else if(best_value >= beta)
-      _M_entries[i].set_value_type(ValueType::LOWER_BOUND);
+      entry.set_value_type(ValueType::LOWER_BOUND);
     else
-      _M_entries[i].set_value_type(ValueType::NONE);
-    _M_entries[i].set_age(_M_age);
+      entry.set_value_type(ValueType::NONE);
+    entry.set_age(_M_age);
+    bucket.store(i, entry);
     return true;
   }
-  
-  void TranspositionTable::decrease_thread_count(HashKey hash_key)
+
+  bool TranspositionTable::find_entry(const TranspositionTableBucket &bucket, HashKey hash_key, size_t &i, TranspositionTableEntry &entry)
+  {
+    uint32_t tmp_partial_hash_key = partial_hash_key(hash_key);
+    for(i = 0; i < TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT; i++) {
+      bucket.load(i, entry);
+      if(entry.age() == _M_age && entry.value_type() != ValueType::NONE && entry.partial_hash_key() == tmp_partial_hash_key)
+        return true;
+    }
+    return false;
+  }
+
+  size_t TranspositionTable::find_entry_to_replace(const TranspositionTableBucket &bucket)
   {
-    size_t i = hash_key % _M_entry_count;
-    lock_guard<Spinlock> guard(_M_entries[i].spinlock());
-    _M_entries[i].decrease_thread_count();
+    // An empty entry or an entry from an old search is replaced first, then the entry with the
+    // least depth, where exact values outweigh lower bounds and lower bounds outweigh upper bounds.
+    size_t entry_index = 0;
+    int min_priority = 0;
+    for(size_t i = 0; i < TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT; i++) {
+      TranspositionTableEntry entry;
+      bucket.load(i, entry);
+      if(entry.age() != _M_age || entry.value_type() == ValueType::NONE) return i;
+      int priority = entry.depth() * 4;
+      if(entry.value_type() == ValueType::EXACT)
+        priority += 2;
+      else if(entry.value_type() == ValueType::LOWER_BOUND)
+        priority += 1;
+      if(i == 0 || priority < min_priority) {
+        entry_index = i;
+        min_priority = priority;
+      }
+    }
+    return entry_index;
   }
   
-  int TranspositionTable::unsafe_value_for_checkmate(size_t i, int depth)
+  int TranspositionTable::value_for_checkmate(const TranspositionTableEntry &entry, int depth)
   {
-    int value = _M_entries[i].value();
+    int value = entry.value();
     if(value >= MAX_VALUE - MAX_DEPTH)
-      return value - (_M_entries[i].depth() - depth);
+      return value - (entry.depth() - depth);
     else if(value <= MIN_VALUE + MAX_DEPTH)
-      return value + (_M_entries[i].depth() - depth);
+      return value + (entry.depth() - depth);
     else
       return value;
   }
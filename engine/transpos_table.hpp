@@ -18,9 +18,13 @@
 #ifndef _TRANSPOS_TABLE_HPP
 #define _TRANSPOS_TABLE_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <string>
 #include "chess.hpp"
-#include "spinlock.hpp"
 
 namespace peacockspider
 {
@@ -29,42 +33,43 @@ namespace peacockspider
     NONE = 0,
     EXACT = 1,
     UPPER_BOUND = 2,
-    LOWER_BOUND = 3,
-    UNSET = 4
-  };
-  
-  enum class RetrieveResult
-  {
-    FULL_FAILURE,
-    PARTIAL_FAILURE,
-    SUCCESS
+    LOWER_BOUND = 3
   };
 
   const int VALUE_ON_EVALUATION = 32000;
+
+  inline void prefetch_for_read(const void *ptr)
+  {
+#if defined(__GNUC__)
+    __builtin_prefetch(ptr, 0, 3);
+#endif
+  }
+
+  inline void prefetch_for_write(const void *ptr)
+  {
+#if defined(__GNUC__)
+    __builtin_prefetch(ptr, 1, 3);
+#endif
+  }
   
   class TranspositionTableEntry
   {
-    HashKey _M_hash_key;
-    Spinlock _M_spinlock;
-    std::uint8_t _M_depth;
-    std::int16_t _M_value;
+    std::uint32_t _M_partial_hash_key;
     Move _M_best_move;
+    std::int16_t _M_value;
+    std::uint16_t _M_age;
+    std::uint8_t _M_depth;
     std::int8_t _M_value_type;
-    std::uint8_t _M_thread_count;
-    std::int16_t _M_age;
-    std::uint32_t _M_pad;
+    std::uint16_t _M_pad;
   public:
     TranspositionTableEntry() :
-      _M_hash_key(0), _M_value_type(0), _M_thread_count(0), _M_age(0) {}
-
-    HashKey hash_key() const
-    { return _M_hash_key; }
+      _M_partial_hash_key(0), _M_best_move(Piece::PAWN, -1, -1, PromotionPiece::NONE), _M_value(0), _M_age(0), _M_depth(0), _M_value_type(0), _M_pad(0) {}
 
-    void set_hash_key(HashKey hash_key)
-    { _M_hash_key = hash_key; }
+    std::uint32_t partial_hash_key() const
+    { return _M_partial_hash_key; }
 
-    Spinlock &spinlock()
-    { return _M_spinlock; }
+    void set_partial_hash_key(std::uint32_t partial_hash_key)
+    { _M_partial_hash_key = partial_hash_key; }
 
     int depth() const
     { return static_cast<int>(_M_depth); }
@@ -90,18 +95,6 @@ namespace peacockspider
     void set_value_type(ValueType value_type)
     { _M_value_type = static_cast<std::int8_t>(value_type); }
 
-    unsigned thread_count() const
-    { return _M_thread_count; }
-
-    void set_thread_count(unsigned thread_count)
-    { _M_thread_count = thread_count; }
-    
-    void increase_thread_count()
-    { _M_thread_count++; }
-
-    void decrease_thread_count()
-    { _M_thread_count--; }
-
     unsigned age() const
     { return _M_age; }
     
@@ -109,16 +102,126 @@ namespace peacockspider
     { _M_age = age; }
   };
 
+  const std::size_t TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT = 4;
+
+  struct alignas(64) TranspositionTableBucket
+  {
+    // Each entry is two words where the first word is XORed with the mixed second word, so an
+    // entry that is torn by concurrent stores has a wrong partial hash key whichever bits of the
+    // second word differ.
+    std::atomic<std::uint64_t> words[TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT * 2];
+
+    static std::uint64_t mix_word(std::uint64_t word)
+    {
+      word ^= word >> 33;
+      word *= 0xff51afd7ed558ccdULL;
+      word ^= word >> 33;
+      word *= 0xc4ceb9fe1a85ec53ULL;
+      word ^= word >> 33;
+      return word;
+    }
+
+    void load(std::size_t i, TranspositionTableEntry &entry) const
+    {
+      std::uint64_t tmp_words[2];
+      tmp_words[1] = words[i * 2 + 1].load(std::memory_order_relaxed);
+      tmp_words[0] = words[i * 2].load(std::memory_order_relaxed) ^ mix_word(tmp_words[1]);
+      std::memcpy(&entry, tmp_words, sizeof(TranspositionTableEntry));
+    }
+
+    void store(std::size_t i, const TranspositionTableEntry &entry)
+    {
+      std::uint64_t tmp_words[2];
+      entry_to_words(entry, tmp_words);
+      words[i * 2].store(tmp_words[0], std::memory_order_relaxed);
+      words[i * 2 + 1].store(tmp_words[1], std::memory_order_relaxed);
+    }
+
+    static void entry_to_words(const TranspositionTableEntry &entry, std::uint64_t *tmp_words)
+    {
+      std::memcpy(tmp_words, &entry, sizeof(TranspositionTableEntry));
+      tmp_words[0] ^= mix_word(tmp_words[1]);
+    }
+  };
+
+  const std::size_t DEFAULT_ABDADA_TABLE_ENTRY_COUNT = 65536;
+
+  class ABDADATable
+  {
+    std::unique_ptr<std::atomic<std::uint64_t> []> _M_entries;
+    std::size_t _M_entry_mask;
+  public:
+    ABDADATable(std::size_t count = DEFAULT_ABDADA_TABLE_ENTRY_COUNT);
+
+    ~ABDADATable();
+
+    void clear();
+
+    bool try_increase_thread_count(HashKey hash_key, bool is_exclusive);
+
+    void decrease_thread_count(HashKey hash_key);
+
+    void prefetch(HashKey hash_key) const
+    { prefetch_for_write(&_M_entries[hash_key & _M_entry_mask]); }
+  };
+
+  const std::size_t MIN_TRANSPOSITION_TABLE_BUCKET_COUNT_PER_THREAD = 4096;
+
+  const std::uint64_t TRANSPOSITION_TABLE_FILE_MAGIC = 0x31454c4254545350ULL;
+  const std::uint32_t TRANSPOSITION_TABLE_FILE_VERSION = 3;
+  const std::size_t TRANSPOSITION_TABLE_FILE_HEADER_SIZE = 4096;
+  const std::uint16_t TRANSPOSITION_TABLE_FILE_AGE = 1;
+  const std::size_t TRANSPOSITION_TABLE_FILE_BUCKET_COUNT_PER_WRITE = 1024;
+
+  struct TranspositionTableFileHeader
+  {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t entry_size;
+    std::uint32_t bucket_size;
+    std::uint32_t bucket_entry_count;
+    std::uint64_t bucket_count;
+    std::uint64_t zobrist_seed;
+    std::uint32_t age;
+    std::uint32_t reserved;
+  };
+
+  inline std::size_t transposition_table_entry_count_for_size(std::size_t size)
+  { return ((size * 1024 * 1024) / sizeof(TranspositionTableBucket)) * TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT; }
+
+  inline std::size_t transposition_table_size_for_entry_count(std::size_t count)
+  { return ((count / TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT) * sizeof(TranspositionTableBucket)) / (1024 * 1024); }
+
   class TranspositionTable
   {
-    std::unique_ptr<TranspositionTableEntry []> _M_entries;
-    std::size_t _M_entry_count;
+    void *_M_memory;
+    std::size_t _M_memory_size;
+    bool _M_has_mapped_memory;
+    TranspositionTableBucket *_M_buckets;
+    std::size_t _M_bucket_mask;
     std::uint16_t _M_age;
+    bool _M_is_loaded;
+    unsigned _M_thread_count;
+    ABDADATable _M_abdada_table;
   public:
-    TranspositionTable(std::size_t count);
+    TranspositionTable(std::size_t count, unsigned thread_count = 1);
 
     ~TranspositionTable();
 
+    std::size_t entry_count() const
+    { return (_M_bucket_mask + 1) * TRANSPOSITION_TABLE_BUCKET_ENTRY_COUNT; }
+
+    bool has_mapped_memory() const
+    { return _M_has_mapped_memory; }
+
+    unsigned thread_count() const
+    { return _M_thread_count; }
+
+    void set_thread_count(unsigned thread_count)
+    { _M_thread_count = (thread_count > 0 ? thread_count : 1); }
+
+    void resize(std::size_t count);
+
     void clear();
 
     void increase_age_or_clear();
@@ -126,14 +229,46 @@ namespace peacockspider
     bool retrieve(HashKey hash_key, int &alpha, int &beta, int depth, int &best_value, Move &best_move);
 
     bool retrieve_for_abdada(HashKey hash_key, int &alpha, int &beta, int depth, int &best_value, Move &best_move, bool is_exclusive);
-  private:
-    RetrieveResult unsafely_retrieve(HashKey hash_key, std::size_t i, int &alpha, int &beta, int depth, int &best_value, Move &best_move);
-  public:    
+
     bool store(HashKey hash_key, int alpha, int beta, int depth, int best_value, Move best_move);
 
-    void decrease_thread_count(HashKey hash_key);
+    void decrease_thread_count(HashKey hash_key)
+    { _M_abdada_table.decrease_thread_count(hash_key); }
+
+    void prefetch(HashKey hash_key) const
+    { prefetch_for_read(&_M_buckets[hash_key & _M_bucket_mask]); }
+
+    void prefetch_for_abdada(HashKey hash_key) const
+    {
+      prefetch(hash_key);
+      _M_abdada_table.prefetch(hash_key);
+    }
+
+    bool save(const std::string &file_name) const;
+
+    bool load(const std::string &file_name);
+
+    static bool read_file_header(const std::string &file_name, TranspositionTableFileHeader &header);
   private:
-    int unsafe_value_for_checkmate(std::size_t i, int depth);
+    void allocate(std::size_t bucket_count);
+
+    void deallocate();
+
+    void clear_buckets(bool must_construct);
+
+    void set_age_for_loaded_entries(std::uint16_t age);
+
+    TranspositionTableBucket &bucket(HashKey hash_key)
+    { return _M_buckets[hash_key & _M_bucket_mask]; }
+
+    static std::uint32_t partial_hash_key(HashKey hash_key)
+    { return static_cast<std::uint32_t>(hash_key ^ (hash_key >> 32)); }
+
+    bool find_entry(const TranspositionTableBucket &bucket, HashKey hash_key, std::size_t &i, TranspositionTableEntry &entry);
+
+    std::size_t find_entry_to_replace(const TranspositionTableBucket &bucket);
+
+    int value_for_checkmate(const TranspositionTableEntry &entry, int depth);
   };
 }
 
@@ -15,6 +15,7 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <sstream>
@@ -28,11 +29,30 @@ namespace peacockspider
 {
   namespace
   {
-    void print_for_uci_command(ostream *ols)
+    void print_for_uci_command(Engine *engine, ostream *ols)
     {
       print_line(ols, "");
       print_line(ols, "id name Peacock Spider");
       print_line(ols, "id author Lukasz Szpakowski");
+      // The defaults are the values which are set by the command line options and the options of
+      // the unsupported settings aren't printed.
+      size_t tt_entry_count;
+      if(engine->get_transposition_table_entry_count(tt_entry_count)) {
+        size_t tt_size = max(transposition_table_size_for_entry_count(tt_entry_count), static_cast<size_t>(1));
+        print_line(ols, "option name Hash type spin default " + to_string(tt_size) + " min 1 max 65536");
+      }
+      unsigned thread_count;
+      if(engine->get_thread_count(thread_count))
+        print_line(ols, "option name Threads type spin default " + to_string(thread_count) + " min 1 max " + to_string(MAX_THREAD_COUNT));
+      print_line(ols, "option name PawnHash type spin default 1 min 1 max 1024");
+      print_line(ols, "option name LMR type check default true");
+      print_line(ols, "option name LMRBase type spin default " + to_string(DEFAULT_LATE_MOVE_REDUCTION_BASE) + " min 0 max 400");
+      print_line(ols, "option name LMRDivisor type spin default " + to_string(DEFAULT_LATE_MOVE_REDUCTION_DIVISOR) + " min 50 max 1000");
+      print_line(ols, "option name ReverseFutilityPruning type check default true");
+      print_line(ols, "option name FutilityPruning type check default true");
+      print_line(ols, "option name Razoring type check default true");
+      print_line(ols, "option name DeltaPruning type check default true");
+      print_line(ols, "option name SEEPruning type check default true");
       print_line(ols, "uciok");
     }
 
@@ -40,7 +60,7 @@ namespace peacockspider
       {
         "uci",
         [](Engine *engine, const vector<string> &args, ostream *ols, MovePairList &move_pairs) {
-          print_for_uci_command(ols);
+          print_for_uci_command(engine, ols);
           return true;
         }
       },
@@ -60,6 +80,66 @@ namespace peacockspider
       {
         "setoption",
         [](Engine *engine, const vector<string> &args, ostream *ols, MovePairList &move_pairs) {
+          if(args.size() >= 4 && args[0] == "name" && args[2] == "value") {
+            istringstream iss(args[3]);
+            if(args[1] == "Hash") {
+              size_t tt_size = 0;
+              iss >> tt_size;
+              if(tt_size < 1) tt_size = 1;
+              if(tt_size > 65536) tt_size = 65536;
+              engine->set_transposition_table_entry_count(transposition_table_entry_count_for_size(tt_size));
+            } else if(args[1] == "Threads") {
+              unsigned thread_count = 0;
+              if(!engine->get_thread_count(thread_count)) {
+                print_line(ols, "info string searcher doesn't support threads");
+                return true;
+              }
+              iss >> thread_count;
+              if(thread_count < 1) thread_count = 1;
+              if(thread_count > MAX_THREAD_COUNT) thread_count = MAX_THREAD_COUNT;
+              engine->set_thread_count(thread_count);
+            } else if(args[1] == "PawnHash") {
+              size_t pawn_table_size = 0;
+              iss >> pawn_table_size;
+              if(pawn_table_size < 1) pawn_table_size = 1;
+              if(pawn_table_size > 1024) pawn_table_size = 1024;
+              engine->set_pawn_table_entry_count((pawn_table_size * 1024 * 1024) / sizeof(PawnTableEntry));
+            } else if(args[1] == "LMR" || args[1] == "LMRBase" || args[1] == "LMRDivisor") {
+              LateMoveReductionTable table;
+              engine->get_late_move_reduction_table(table);
+              bool flag = table.flag();
+              int base = table.base();
+              int divisor = table.divisor();
+              if(args[1] == "LMR") {
+                flag = (args[3] == "true");
+              } else if(args[1] == "LMRBase") {
+                iss >> base;
+                if(base < 0) base = 0;
+                if(base > 400) base = 400;
+              } else {
+                iss >> divisor;
+                if(divisor < 50) divisor = 50;
+                if(divisor > 1000) divisor = 1000;
+              }
+              table.set(flag, base, divisor);
+              engine->set_late_move_reduction_table(table);
+            } else if(args[1] == "ReverseFutilityPruning" || args[1] == "FutilityPruning" || args[1] == "Razoring" || args[1] == "DeltaPruning" || args[1] == "SEEPruning") {
+              PruningFlags flags;
+              engine->get_pruning_flags(flags);
+              bool flag = (args[3] == "true");
+              if(args[1] == "ReverseFutilityPruning")
+                flags.reverse_futility_pruning = flag;
+              else if(args[1] == "FutilityPruning")
+                flags.futility_pruning = flag;
+              else if(args[1] == "Razoring")
+                flags.razoring = flag;
+              else if(args[1] == "DeltaPruning")
+                flags.delta_pruning = flag;
+              else
+                flags.see_pruning = flag;
+              engine->set_pruning_flags(flags);
+            }
+          }
           return true;
         }
       },
@@ -196,6 +276,50 @@ namespace peacockspider
           return true;
         }
       },
+      {
+        "perft",
+        [](Engine *engine, const vector<string> &args, ostream *ols, MovePairList &move_pairs) {
+          if(args.size() < 1) {
+            print_line(ols, "info string too few arguments");
+            return true;
+          }
+          istringstream iss(args[0]);
+          int depth;
+          iss >> depth;
+          if(iss.fail() || !iss.eof()) {
+            print_line(ols, "info string incorrect number");
+            return true;
+          }
+          if(depth < 1) depth = 1;
+          if(depth > MAX_DEPTH) depth = MAX_DEPTH;
+          print_perft(engine, depth, ols);
+          return true;
+        }
+      },
+      {
+        "savehash",
+        [](Engine *engine, const vector<string> &args, ostream *ols, MovePairList &move_pairs) {
+          if(args.size() >= 1) {
+            string file_name = args[0];
+            for(size_t i = 1; i < args.size(); i++) file_name += " " + args[i];
+            if(!engine->save_transposition_table(file_name))
+              print_line(ols, "info string can't save transposition table");
+          }
+          return true;
+        }
+      },
+      {
+        "loadhash",
+        [](Engine *engine, const vector<string> &args, ostream *ols, MovePairList &move_pairs) {
+          if(args.size() >= 1) {
+            string file_name = args[0];
+            for(size_t i = 1; i < args.size(); i++) file_name += " " + args[i];
+            if(!engine->load_transposition_table(file_name))
+              print_line(ols, "info string can't load transposition table");
+          }
+          return true;
+        }
+      },
       {
         "quit",
         [](Engine *engine, const vector<string> &args, ostream *ols, MovePairList &move_pairs) {
@@ -210,7 +334,7 @@ namespace peacockspider
     string first_cmd_name, first_arg_str;
     split_command_line(first_cmd_line, first_cmd_name, first_arg_str);
     if(first_cmd_name == "uci")
-      print_for_uci_command(ols);
+      print_for_uci_command(engine, ols);
     else
       return make_pair(false, true);
     engine->stop_thinking();
@@ -221,7 +345,7 @@ namespace peacockspider
     unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
     MovePairList move_pairs(tmp_move_pairs.get(), 0);
     OutputFunctionSettings settings(engine,
-      [ols](int depth, int value, unsigned ms, const Searcher *searcher, const Board *pondering_board, const Move *pondering_move) {
+      [ols](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher, const Board *pondering_board, const Move *pondering_move) {
         unique_lock<mutex> output_lock(output_mutex);
         int selective_depth = depth + searcher->max_quiescence_depth();
         int64_t nps = searcher->nodes() * 1000 / (ms > 0 ? ms : 1);
@@ -232,6 +356,11 @@ namespace peacockspider
         }
         cout << " score cp " << value;
         if(ols != nullptr) *ols << " score cp " << value;
+        if(value_type == ValueType::LOWER_BOUND || value_type == ValueType::UPPER_BOUND) {
+          string bound_str = (value_type == ValueType::LOWER_BOUND ? " lowerbound" : " upperbound");
+          cout << bound_str;
+          if(ols != nullptr) *ols << bound_str;
+        }
         cout << " time " << ms;
         if(ols != nullptr) *ols << " time " << ms;
         cout << " nodes " << searcher->nodes();
@@ -247,9 +376,26 @@ namespace peacockspider
         }
         cout << endl;
         if(ols != nullptr) *ols << endl;
+        uint64_t pawn_table_probe_count = searcher->pawn_table_probe_count();
+        if(pawn_table_probe_count > 0) {
+          uint64_t permille = searcher->pawn_table_hit_count() * 1000 / pawn_table_probe_count;
+          cout << "info string pawn table hit rate " << (permille / 10) << "." << (permille % 10) << "%" << endl;
+          if(ols != nullptr) {
+            *ols << output_prefix;
+            *ols << "info string pawn table hit rate " << (permille / 10) << "." << (permille % 10) << "%" << endl;
+          }
+        }
       },
-      [ols](const Board &board, Move move, const Move *pondering_move) {
+      [engine, ols](const Board &board, Move move, const Move *pondering_move) {
         unique_lock<mutex> output_lock(output_mutex);
+        unsigned stop_latency;
+        if(engine->get_stop_latency(stop_latency)) {
+          cout << "info string stop latency " << stop_latency << " us" << endl;
+          if(ols != nullptr) {
+            *ols << output_prefix;
+            *ols << "info string stop latency " << stop_latency << " us" << endl;
+          }
+        }
         string move_str = move.to_can_string();
         cout << "bestmove " << move_str;
         if(ols != nullptr) {
@@ -49,6 +49,8 @@ namespace peacockspider
       "veriants=\"normal\"",
       "colors=0",
       "name=1",
+      "memory=1",
+      "smp=1",
       "done=1",
       nullptr
     };
@@ -705,6 +707,37 @@ namespace peacockspider
           return make_pair(true, true);
         }
       },
+      {
+        "memory",
+        [](Engine *engine, bool &is_prompt, const string &arg_str, ostream *ols, const string &cmd_line, MovePairList &move_pairs) {
+          istringstream iss(arg_str);
+          size_t tt_size;
+          iss >> tt_size;
+          if(iss.fail() || !iss.eof()) {
+            print_error(ols, "incorrect number", cmd_line);
+            return make_pair(true, true);
+          }
+          if(tt_size < 1) tt_size = 1;
+          engine->set_transposition_table_entry_count(transposition_table_entry_count_for_size(tt_size));
+          return make_pair(true, true);
+        }
+      },
+      {
+        "cores",
+        [](Engine *engine, bool &is_prompt, const string &arg_str, ostream *ols, const string &cmd_line, MovePairList &move_pairs) {
+          istringstream iss(arg_str);
+          unsigned thread_count;
+          iss >> thread_count;
+          if(iss.fail() || !iss.eof()) {
+            print_error(ols, "incorrect number", cmd_line);
+            return make_pair(true, true);
+          }
+          if(thread_count < 1) thread_count = 1;
+          if(thread_count > MAX_THREAD_COUNT) thread_count = MAX_THREAD_COUNT;
+          engine->set_thread_count(thread_count);
+          return make_pair(true, true);
+        }
+      },
       {
         "computer",
         [](Engine *engine, bool &is_prompt, const string &arg_str, ostream *ols, const string &cmd_line, MovePairList &move_pairs) {
@@ -721,6 +754,44 @@ namespace peacockspider
           if(ols != nullptr) *ols << prefix_and_board(output_prefix, board) << endl;
           return make_pair(true, true);
         }
+      },
+      {
+        "perft",
+        [](Engine *engine, bool &is_prompt, const string &arg_str, ostream *ols, const string &cmd_line, MovePairList &move_pairs) {
+          istringstream iss(arg_str);
+          int depth;
+          iss >> depth;
+          if(iss.fail() || !iss.eof()) {
+            print_error(ols, "incorrect number", cmd_line);
+            return make_pair(true, true);
+          }
+          if(depth < 1) depth = 1;
+          if(depth > MAX_DEPTH) depth = MAX_DEPTH;
+          print_perft(engine, depth, ols);
+          return make_pair(true, true);
+        }
+      },
+      {
+        "savehash",
+        [](Engine *engine, bool &is_prompt, const string &arg_str, ostream *ols, const string &cmd_line, MovePairList &move_pairs) {
+          if(arg_str.empty()) {
+            print_error(ols, "too few arguments", cmd_line);
+            return make_pair(true, true);
+          }
+          if(!engine->save_transposition_table(arg_str)) print_error(ols, "can't save transposition table", cmd_line);
+          return make_pair(true, true);
+        }
+      },
+      {
+        "loadhash",
+        [](Engine *engine, bool &is_prompt, const string &arg_str, ostream *ols, const string &cmd_line, MovePairList &move_pairs) {
+          if(arg_str.empty()) {
+            print_error(ols, "too few arguments", cmd_line);
+            return make_pair(true, true);
+          }
+          if(!engine->load_transposition_table(arg_str)) print_error(ols, "can't load transposition table", cmd_line);
+          return make_pair(true, true);
+        }
       }
     };
   }
@@ -732,7 +803,7 @@ namespace peacockspider
     unique_ptr<MovePair []> tmp_thread_move_pairs(new MovePair[MAX_MOVE_COUNT]);
     MovePairList thread_move_pairs(tmp_thread_move_pairs.get(), 0);
     OutputFunctionSettings settings(engine,
-      [ols, &thread_move_pairs](int depth, int value, unsigned ms, const Searcher *searcher, const Board *pondering_board, const Move *pondering_move) {
+      [ols, &thread_move_pairs](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher, const Board *pondering_board, const Move *pondering_move) {
         unique_lock<mutex> output_lock(output_mutex);
         if(is_prompt_newline) cout << endl;
         cout << depth << " " << value << " " << ((ms + 9) / 10) << " " << searcher->nodes();
@@ -760,14 +831,24 @@ namespace peacockspider
           if(!board.make_move(searcher->pv_line()[i], new_board)) break;
           board = new_board;
         }
+        if(value_type == ValueType::LOWER_BOUND || value_type == ValueType::UPPER_BOUND) {
+          // A fail high or a fail low of an aspiration window is marked like in other engines.
+          string bound_str = (value_type == ValueType::LOWER_BOUND ? " ++" : " --");
+          cout << bound_str;
+          if(ols != nullptr) *ols << bound_str;
+        }
         cout << endl;
         if(ols != nullptr) *ols << endl;
         if(is_prompt_newline) must_write_prompt = true;
         is_prompt_newline = false;
       },
-      [ols](const Board &board, Move move, const Move *pondering_move) {
+      [engine, ols](const Board &board, Move move, const Move *pondering_move) {
         unique_lock<mutex> output_lock(output_mutex);
         if(is_prompt_newline) cout << endl;
+        unsigned stop_latency;
+        // XBoard ignores lines that begin with the # character.
+        if(engine->get_stop_latency(stop_latency))
+          unsafely_print_line(ols, string("# stop latency ") + to_string(stop_latency) + " us");
         unsafely_print_line(ols, string("move ") + move.to_can_string());
         if(is_prompt_newline || must_write_prompt) {
           cout << prompt;
@@ -0,0 +1,302 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "search.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  YBWCSearcher::YBWCSearcher(const EvaluationFunction *eval_fun, TranspositionTable *transpos_table, unsigned thread_count, int max_depth, int max_quiescence_depth) :
+    _M_evaluation_function(eval_fun), _M_transposition_table(transpos_table), _M_max_depth(max_depth), _M_max_quiescence_depth(max_quiescence_depth), _M_pawn_table_entry_count(DEFAULT_PAWN_TABLE_ENTRY_COUNT), _M_thread_pool(&shared_thread_pool())
+  {
+    _M_main_searcher = unique_ptr<YBWCSinglePVSSearcher>(new YBWCSinglePVSSearcher(eval_fun, transpos_table, nullptr, _M_threads, _M_split_point_list, max_depth, max_quiescence_depth));
+    start_threads(thread_count);
+  }
+
+  YBWCSearcher::~YBWCSearcher()
+  { quit_threads(); }
+
+  void YBWCSearcher::start_threads(unsigned thread_count)
+  {
+    for(unsigned i = 0; i < thread_count - 1; i++) {
+      _M_threads.push_back(YBWCThread());
+      _M_threads.back().searcher = unique_ptr<YBWCSinglePVSSearcher>(new YBWCSinglePVSSearcher(_M_evaluation_function, _M_transposition_table, _M_main_searcher.get(), _M_threads, _M_split_point_list, _M_max_depth, _M_max_quiescence_depth));
+    }
+    _M_split_point_list.idle_thread_count.store(0);
+    _M_split_point_list.quit_flag = true;
+    _M_thread_pool->reserve(thread_count - 1);
+  }
+
+  void YBWCSearcher::quit_threads()
+  { _M_thread_pool->release(_M_threads.size()); }
+
+  void YBWCSearcher::search_in_thread(unsigned i)
+  {
+    unique_lock<mutex> lock(_M_split_point_list.mutex);
+    _M_split_point_list.idle_thread_count++;
+    while(true) {
+      YBWCSplitPoint *split_point = nullptr;
+      while(!_M_split_point_list.quit_flag && (split_point = find_split_point()) == nullptr) {
+        _M_split_point_list.condition_variable.wait(lock);
+      }
+      if(_M_split_point_list.quit_flag) break;
+      split_point->thread_count++;
+      _M_split_point_list.idle_thread_count--;
+      lock.unlock();
+      _M_threads[i].searcher->join_split_point(split_point);
+      lock.lock();
+      split_point->thread_count--;
+      _M_split_point_list.idle_thread_count++;
+      _M_split_point_list.condition_variable.notify_all();
+    }
+    _M_split_point_list.idle_thread_count--;
+  }
+
+  YBWCSplitPoint *YBWCSearcher::find_split_point()
+  {
+    // The idle thread joins the deepest split point that has moves to search.
+    YBWCSplitPoint *best_split_point = nullptr;
+    for(YBWCSplitPoint *split_point : _M_split_point_list.split_points) {
+      bool has_moves;
+      {
+        lock_guard<Spinlock> lock(split_point->spinlock);
+        has_moves = !split_point->cutoff_flag.load() && split_point->next_move_index < split_point->move_count;
+      }
+      if(has_moves && (best_split_point == nullptr || split_point->depth > best_split_point->depth))
+        best_split_point = split_point;
+    }
+    return best_split_point;
+  }
+
+  const Board &YBWCSearcher::board() const
+  { return _M_main_searcher->board(); }
+
+  void YBWCSearcher::set_board(const Board &board)
+  {
+    _M_main_searcher->set_board(board);
+    for(YBWCThread &thread : _M_threads) {
+      thread.searcher->set_board(board);
+    }
+  }
+
+  void YBWCSearcher::set_stop_nodes(uint64_t nodes)
+  { _M_main_searcher->set_stop_nodes(nodes); }
+
+  void YBWCSearcher::unset_stop_nodes()
+  { _M_main_searcher->unset_stop_nodes(); }
+
+  void YBWCSearcher::set_previous_pv_line(const PVLine &pv_line)
+  {
+    _M_main_searcher->set_previous_pv_line(pv_line);
+    for(YBWCThread &thread : _M_threads) {
+      thread.searcher->set_previous_pv_line(pv_line);
+    }
+  }
+
+  void YBWCSearcher::clear()
+  {
+    _M_transposition_table->increase_age_or_clear();
+    _M_main_searcher->clear();
+    for(YBWCThread &thread : _M_threads) {
+      thread.searcher->clear();
+    }
+  }
+
+  void YBWCSearcher::clear_for_new_game()
+  {
+    _M_transposition_table->clear();
+    _M_main_searcher->clear_for_new_game();
+    for(YBWCThread &thread : _M_threads) {
+      thread.searcher->clear_for_new_game();
+    }
+  }
+
+  int YBWCSearcher::search_from_root(int alpha, int beta, int depth, const vector<Move> *search_moves, Move &best_move, const vector<Board> &boards, const Board *last_board)
+  {
+    // The helper threads only search in split points of the main searcher, so they wait for the split
+    // points in the thread pool while the main searcher searches.
+    for(YBWCThread &thread : _M_threads) {
+      thread.searcher->clear_nodes();
+      thread.searcher->set_root_hash_keys(boards, last_board);
+    }
+    _M_split_point_list.quit_flag = false;
+    for(unsigned i = 0; i < _M_threads.size(); i++) {
+      _M_task_group.run(*_M_thread_pool, [this, i]() { search_in_thread(i); });
+    }
+    int value;
+    try {
+      value = _M_main_searcher->search_from_root(alpha, beta, depth, search_moves, best_move, boards, last_board);
+    } catch(...) {
+      stop_threads();
+      throw;
+    }
+    stop_threads();
+    return value;
+  }
+
+  void YBWCSearcher::stop_threads()
+  {
+    {
+      lock_guard<mutex> lock(_M_split_point_list.mutex);
+      _M_split_point_list.quit_flag = true;
+    }
+    _M_split_point_list.condition_variable.notify_all();
+    _M_task_group.wait();
+  }
+
+  void YBWCSearcher::set_pondering_flag(bool flag)
+  { _M_main_searcher->set_pondering_flag(flag); }
+
+  void YBWCSearcher::clear_thinking_stop_flag()
+  { _M_main_searcher->clear_thinking_stop_flag(); }
+
+  void YBWCSearcher::clear_pondering_stop_flag()
+  { _M_main_searcher->clear_pondering_stop_flag(); }
+
+  void YBWCSearcher::clear_searching_stop_flag()
+  { _M_main_searcher->clear_searching_stop_flag(); }
+
+  void YBWCSearcher::stop_thinking()
+  { _M_main_searcher->stop_thinking(); }
+
+  void YBWCSearcher::stop_pondering()
+  { _M_main_searcher->stop_pondering(); }
+
+  void YBWCSearcher::stop_searching()
+  { _M_main_searcher->stop_searching(); }
+
+  void YBWCSearcher::set_non_stop_flag(bool flag)
+  { _M_main_searcher->set_non_stop_flag(flag); }
+
+  const PVLine &YBWCSearcher::pv_line() const
+  { return _M_main_searcher->pv_line(); }
+
+  uint64_t YBWCSearcher::nodes() const
+  { return _M_main_searcher->all_nodes(); }
+
+  unsigned YBWCSearcher::thread_count() const
+  { return _M_threads.size() + 1; }
+
+  int YBWCSearcher::max_quiescence_depth() const
+  { return _M_main_searcher->max_quiescence_depth(); }
+
+  void YBWCSearcher::set_pawn_table_entry_count(size_t count)
+  {
+    _M_pawn_table_entry_count = count;
+    _M_main_searcher->set_pawn_table_entry_count(count);
+    for(YBWCThread &thread : _M_threads) {
+      thread.searcher->set_pawn_table_entry_count(count);
+    }
+  }
+
+  uint64_t YBWCSearcher::pawn_table_probe_count() const
+  {
+    uint64_t count = _M_main_searcher->pawn_table_probe_count();
+    for(const YBWCThread &thread : _M_threads) {
+      count += thread.searcher->pawn_table_probe_count();
+    }
+    return count;
+  }
+
+  uint64_t YBWCSearcher::pawn_table_hit_count() const
+  {
+    uint64_t count = _M_main_searcher->pawn_table_hit_count();
+    for(const YBWCThread &thread : _M_threads) {
+      count += thread.searcher->pawn_table_hit_count();
+    }
+    return count;
+  }
+
+  uint64_t YBWCSearcher::cutoff_count() const
+  {
+    uint64_t count = _M_main_searcher->cutoff_count();
+    for(const YBWCThread &thread : _M_threads) {
+      count += thread.searcher->cutoff_count();
+    }
+    return count;
+  }
+
+  uint64_t YBWCSearcher::first_move_cutoff_count() const
+  {
+    uint64_t count = _M_main_searcher->first_move_cutoff_count();
+    for(const YBWCThread &thread : _M_threads) {
+      count += thread.searcher->first_move_cutoff_count();
+    }
+    return count;
+  }
+
+  uint64_t YBWCSearcher::split_count() const
+  {
+    uint64_t count = _M_main_searcher->split_count();
+    for(const YBWCThread &thread : _M_threads) {
+      count += thread.searcher->split_count();
+    }
+    return count;
+  }
+
+  size_t YBWCSearcher::transposition_table_entry_count() const
+  { return _M_transposition_table->entry_count(); }
+
+  void YBWCSearcher::set_transposition_table_entry_count(size_t count)
+  { _M_transposition_table->resize(count); }
+
+  bool YBWCSearcher::save_transposition_table(const string &file_name) const
+  { return _M_transposition_table->save(file_name); }
+
+  bool YBWCSearcher::load_transposition_table(const string &file_name)
+  { return _M_transposition_table->load(file_name); }
+
+  const LateMoveReductionTable &YBWCSearcher::late_move_reduction_table() const
+  { return _M_main_searcher->late_move_reduction_table(); }
+
+  void YBWCSearcher::set_late_move_reduction_table(const LateMoveReductionTable &table)
+  {
+    _M_main_searcher->set_late_move_reduction_table(table);
+    for(YBWCThread &thread : _M_threads) {
+      thread.searcher->set_late_move_reduction_table(table);
+    }
+  }
+
+  const PruningFlags &YBWCSearcher::pruning_flags() const
+  { return _M_main_searcher->pruning_flags(); }
+
+  void YBWCSearcher::set_pruning_flags(const PruningFlags &flags)
+  {
+    _M_main_searcher->set_pruning_flags(flags);
+    for(YBWCThread &thread : _M_threads) {
+      thread.searcher->set_pruning_flags(flags);
+    }
+  }
+
+  bool YBWCSearcher::can_set_thread_count() const
+  { return true; }
+
+  void YBWCSearcher::set_thread_count(unsigned thread_count)
+  {
+    quit_threads();
+    _M_threads.clear();
+    start_threads(thread_count);
+    for(YBWCThread &thread : _M_threads) {
+      thread.searcher->set_board(_M_main_searcher->board());
+      thread.searcher->set_pawn_table_entry_count(_M_pawn_table_entry_count);
+      thread.searcher->set_late_move_reduction_table(_M_main_searcher->late_move_reduction_table());
+      thread.searcher->set_pruning_flags(_M_main_searcher->pruning_flags());
+    }
+    _M_transposition_table->set_thread_count(thread_count);
+  }
+}
@@ -0,0 +1,399 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include "search.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  namespace
+  {
+    const int R = 3;
+  }
+
+  YBWCSinglePVSSearcher::YBWCSinglePVSSearcher(const EvaluationFunction *eval_fun, TranspositionTable *transpos_table, const Searcher *main_searcher, const vector<YBWCThread> &threads, YBWCSplitPointList &split_point_list, int max_depth, int max_quiescence_depth) :
+    SingleSearcherBase(eval_fun, max_depth, max_quiescence_depth), _M_transposition_table(transpos_table), _M_main_searcher(main_searcher), _M_threads(threads), _M_split_point_list(split_point_list), _M_max_depth(max_depth), _M_split_point(nullptr), _M_split_count(0) {}
+
+  YBWCSinglePVSSearcher::~YBWCSinglePVSSearcher() {}
+
+  void YBWCSinglePVSSearcher::clear()
+  {
+    _M_move_order.clear();
+    _M_pawn_table.clear_counts();
+    clear_cutoff_counts();
+    reset_nodes();
+    _M_split_count = 0;
+  }
+
+  void YBWCSinglePVSSearcher::clear_for_new_game()
+  {
+    clear();
+    _M_pawn_table.clear();
+  }
+
+  int YBWCSinglePVSSearcher::search_from_root(int alpha, int beta, int depth, const vector<Move> *search_moves, Move &best_move, const vector<Board> &boards, const Board *last_board)
+  {
+    _M_board = _M_root_board;
+    set_root_evaluation_accumulator();
+    _M_hash_key_history.set_root(boards, last_board);
+    _M_stack[0].pv_line.clear();
+    reset_nodes();
+    NodePublisher node_publisher(this);
+    try {
+      check_stop_for_nodes();
+    } catch(SearchingStopException &e) {
+      return 0;
+    }
+    _M_nodes++;
+    _M_stack[0].move_pairs = MovePairList(_M_move_pairs.get(), 0);
+    MovePicker move_picker(_M_stack[0].move_pairs, 0, _M_board, _M_move_order, _M_evaluation_function, nullptr);
+    int best_value = MIN_VALUE;
+    Move tmp_best_move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+    bool is_first = true;
+    try {
+      Move move;
+      while(move_picker.next(move)) {
+        if(search_moves != nullptr ? find(search_moves->begin(), search_moves->end(), move) != search_moves->end() : true) {
+          do_move(move, 0);
+          if(depth > 1) prefetch();
+          int value;
+          _M_hash_key_history.set_hash_key(1, _M_board.hash_key());
+          if(_M_hash_key_history.has_repetition(1, _M_board.halfmove_clock())) {
+            _M_stack[1].pv_line.clear();
+            value = 0;
+          } else {
+            if(is_first) {
+              value = -search(-beta, -alpha, depth - 1, 1, true);
+            } else {
+              value = -search(-(alpha + 1), -alpha, depth - 1, 1, true);
+              if(value > alpha && value < beta)
+                value = -search(-beta, -alpha, depth - 1, 1, true);
+            }
+          }
+          undo_move(move, 0);
+          if(value > best_value) {
+            _M_stack[0].pv_line.update(move, _M_stack[1].pv_line);
+            tmp_best_move = move;
+            best_value = value;
+            if(best_value > alpha) {
+              alpha = value;
+              if(best_value >= beta) {
+                update_for_cutoff(move, depth, 0, move_picker);
+                best_move = tmp_best_move;
+                return best_value;
+              }
+              _M_move_order.increase_history_for_alpha(_M_root_board.side(), move.from(), move.to(), depth);
+            }
+          }
+          is_first = false;
+        }
+      }
+    } catch(SearchingStopException &e) {
+      return 0;
+    }
+    best_move = tmp_best_move;
+    return best_value;
+  }
+
+  uint64_t YBWCSinglePVSSearcher::all_nodes() const
+  {
+    const Searcher *main_searcher = (_M_main_searcher != nullptr ? _M_main_searcher : this);
+    uint64_t nodes = main_searcher->nodes();
+    for(const YBWCThread &thread : _M_threads) {
+      nodes += thread.searcher->nodes();
+    }
+    return nodes;
+  }
+
+  void YBWCSinglePVSSearcher::join_split_point(YBWCSplitPoint *split_point)
+  {
+    // The helper thread takes the position of the node from the split point.
+    _M_board = split_point->board;
+    _M_hash_key_history.copy_plies(*(split_point->hash_key_history), split_point->ply);
+    _M_stack[split_point->ply].evaluation_accumulator = split_point->evaluation_accumulator;
+    if(split_point->ply > 0) _M_stack[split_point->ply - 1].move = split_point->previous_move;
+    _M_stack[split_point->ply].move_pairs = MovePairList(_M_move_pairs.get(), 0);
+    _M_split_point = split_point;
+    NodePublisher node_publisher(this);
+    try {
+      search_split_point(*split_point);
+    } catch(YBWCCutoffException &e) {
+    } catch(SearchingStopException &e) {
+    }
+    _M_split_point = nullptr;
+  }
+
+  void YBWCSinglePVSSearcher::check_stop()
+  {
+    SingleSearcherBase::check_stop();
+    if(is_cutoff(_M_split_point)) throw YBWCCutoffException();
+  }
+
+  void YBWCSinglePVSSearcher::prefetch()
+  { _M_transposition_table->prefetch(_M_board.hash_key()); }
+
+  bool YBWCSinglePVSSearcher::before(int &alpha, int &beta, int depth, int ply, int &best_value, Move &best_move)
+  { return _M_transposition_table->retrieve(_M_board.hash_key(), alpha, beta, depth, best_value, best_move); }
+
+  void YBWCSinglePVSSearcher::after(int alpha, int beta, int depth, int ply, int best_value, Move best_move)
+  { _M_transposition_table->store(_M_board.hash_key(), alpha, beta, depth, best_value, best_move); }
+
+  void YBWCSinglePVSSearcher::cutoff(int alpha, int beta, int depth, int ply, int best_value, Move best_move)
+  { _M_transposition_table->store(_M_board.hash_key(), alpha, beta, depth, best_value, best_move); }
+
+  int YBWCSinglePVSSearcher::search(int alpha, int beta, int depth, int ply, bool can_make_null_move)
+  {
+    if(depth <= 0) {
+      return quiescence_search(alpha, beta, _M_max_quiescence_depth, ply);
+    } else {
+      _M_stack[ply].pv_line.clear();
+      _M_nodes++;
+      check_stop_for_nodes();
+      if(is_cutoff(_M_split_point)) throw YBWCCutoffException();
+      if(_M_board.halfmove_clock() >= 100) return 0;
+      _M_hash_key_history.set_hash_key(ply, _M_board.hash_key());
+      if(ply > 0 && _M_hash_key_history.has_repetition(ply, _M_board.halfmove_clock())) return 0;
+      int tt_best_value;
+      Move tt_best_move;
+      if(before(alpha, beta, depth, ply, tt_best_value, tt_best_move)) {
+        if(tt_best_move.to() != -1) {
+          if(_M_board.has_legal_move_for_tt(tt_best_move)) {
+            _M_stack[ply + 1].pv_line.clear();
+            _M_stack[ply].pv_line.update(tt_best_move, _M_stack[ply + 1].pv_line);
+          } else
+            _M_stack[ply].pv_line.clear();
+        }
+        return tt_best_value;
+      }
+      if(ply == 0)
+        _M_stack[ply].move_pairs = MovePairList(_M_move_pairs.get(), 0);
+      else
+        _M_stack[ply].move_pairs = _M_stack[ply - 1].move_pairs.to_next_list();
+      bool in_check = _M_board.in_check();
+      int eval_value = MAX_VALUE;
+      if(beta - alpha == 1 && can_prune_node(alpha, beta, depth, ply, in_check)) {
+        eval_value = static_evaluation(ply);
+        if(can_use_reverse_futility_pruning(beta, depth, eval_value)) {
+          cutoff(alpha, beta, depth, ply, eval_value, Move(Piece::PAWN, -1, -1, PromotionPiece::NONE));
+          return eval_value;
+        }
+        if(can_use_razoring(alpha, depth, eval_value)) {
+          int value = quiescence_search(alpha, beta, _M_max_quiescence_depth, ply);
+          if(value <= alpha) {
+            after(alpha, beta, depth, ply, value, Move(Piece::PAWN, -1, -1, PromotionPiece::NONE));
+            return value;
+          }
+        }
+      }
+      if(!in_check && can_make_null_move && ply >= 2) {
+        do_null_move(ply);
+        if(depth - R > 1) prefetch();
+        int value = -search(-beta, -(beta - 1), depth - R - 1, ply + 1, false);
+        undo_null_move(ply);
+        if(value >= beta) {
+          cutoff(alpha, beta, depth, ply, value, Move(Piece::PAWN, -1, -1, PromotionPiece::NONE));
+          return value;
+        }
+      }
+      MovePicker move_picker(_M_stack[ply].move_pairs, ply, _M_board, _M_move_order, _M_evaluation_function, &tt_best_move, previous_move(ply));
+      int best_value = MIN_VALUE;
+      int old_alpha = alpha;
+      Move best_move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+      bool is_legal_move = false;
+      bool is_first = true;
+      Move move;
+      while(move_picker.next(move)) {
+        do_move(move, ply);
+        if(depth > 1) prefetch();
+        is_legal_move = true;
+        if(best_value > MIN_VALUE && is_futile_move(move, alpha, depth, ply, eval_value)) {
+          undo_move(move, ply);
+          if(eval_value + FUTILITY_PRUNING_MARGIN * depth > best_value) best_value = eval_value + FUTILITY_PRUNING_MARGIN * depth;
+          continue;
+        }
+        int value;
+        if(is_first) {
+          value = -search(-beta, -alpha, depth - 1, ply + 1, can_make_null_move);
+        } else {
+          int reduction = late_move_reduction(move, depth, ply, in_check, move_picker);
+          value = -search(-(alpha + 1), -alpha, depth - reduction - 1, ply + 1, can_make_null_move);
+          if(reduction > 0 && value > alpha)
+            value = -search(-(alpha + 1), -alpha, depth - 1, ply + 1, can_make_null_move);
+          if(value > alpha && value < beta)
+            value = -search(-beta, -alpha, depth - 1, ply + 1, can_make_null_move);
+        }
+        undo_move(move, ply);
+        if(value > best_value) {
+          _M_stack[ply].pv_line.update(move, _M_stack[ply + 1].pv_line);
+          best_move = move;
+          best_value = value;
+          if(best_value > alpha) {
+            alpha = best_value;
+            if(best_value >= beta) {
+              update_for_cutoff(move, depth, ply, move_picker);
+              cutoff(old_alpha, beta, depth, ply, best_value, best_move);
+              return best_value;
+            }
+            _M_move_order.increase_history_for_alpha(_M_root_board.side(), move.from(), move.to(), depth);
+          }
+        }
+        is_first = false;
+        // The young brothers are searched in parallel after the eldest brother.
+        if(can_split(depth)) {
+          split(alpha, beta, depth, ply, in_check, can_make_null_move, eval_value, best_value, best_move, move_picker);
+          if(best_value >= beta) {
+            cutoff(old_alpha, beta, depth, ply, best_value, best_move);
+            return best_value;
+          }
+          break;
+        }
+      }
+      if(!is_legal_move) {
+        best_value = in_check ? MIN_VALUE + ply : 0;
+      }
+      after(old_alpha, beta, depth, ply, best_value, best_move);
+      return best_value;
+    }
+  }
+
+  void YBWCSinglePVSSearcher::split(int &alpha, int beta, int depth, int ply, bool in_check, bool can_make_null_move, int eval_value, int &best_value, Move &best_move, MovePicker &move_picker)
+  {
+    YBWCSplitPoint split_point(_M_hash_key_history, _M_max_depth + _M_max_quiescence_depth - ply);
+    Move move;
+    while(move_picker.next(move)) {
+      split_point.moves[split_point.move_count] = move;
+      split_point.move_counts[split_point.move_count] = move_picker.move_count();
+      split_point.move_count++;
+    }
+    if(split_point.move_count == 0) return;
+    _M_split_count++;
+    split_point.parent = _M_split_point;
+    split_point.board = _M_board;
+    split_point.evaluation_accumulator = _M_stack[ply].evaluation_accumulator;
+    split_point.previous_move = previous_move(ply);
+    split_point.depth = depth;
+    split_point.ply = ply;
+    split_point.beta = beta;
+    split_point.in_check = in_check;
+    split_point.can_make_null_move = can_make_null_move;
+    split_point.eval_value = eval_value;
+    split_point.alpha = alpha;
+    split_point.best_value = best_value;
+    split_point.best_move = best_move;
+    split_point.pv_line = _M_stack[ply].pv_line;
+    {
+      lock_guard<mutex> lock(_M_split_point_list.mutex);
+      split_point.thread_count = 1;
+      _M_split_point_list.split_points.push_back(&split_point);
+    }
+    _M_split_point_list.condition_variable.notify_all();
+    _M_split_point = &split_point;
+    try {
+      search_split_point(split_point);
+    } catch(...) {
+      // The helper threads are stopped before leaving the split point.
+      split_point.cutoff_flag.store(true);
+      wait_for_split_point(split_point);
+      _M_split_point = split_point.parent;
+      throw;
+    }
+    wait_for_split_point(split_point);
+    _M_split_point = split_point.parent;
+    if(split_point.best_move != best_move) _M_stack[ply].pv_line = split_point.pv_line;
+    alpha = split_point.alpha;
+    best_value = split_point.best_value;
+    best_move = split_point.best_move;
+  }
+
+  void YBWCSinglePVSSearcher::search_split_point(YBWCSplitPoint &split_point)
+  {
+    int depth = split_point.depth;
+    int ply = split_point.ply;
+    try {
+      while(true) {
+        Move move;
+        size_t move_count;
+        int alpha;
+        {
+          lock_guard<Spinlock> lock(split_point.spinlock);
+          if(split_point.cutoff_flag.load() || split_point.next_move_index >= split_point.move_count) break;
+          move = split_point.moves[split_point.next_move_index];
+          move_count = split_point.move_counts[split_point.next_move_index];
+          split_point.next_move_index++;
+          alpha = split_point.alpha;
+        }
+        do_move(move, ply);
+        if(depth > 1) prefetch();
+        int value;
+        if(is_futile_move(move, alpha, depth, ply, split_point.eval_value)) {
+          undo_move(move, ply);
+          value = split_point.eval_value + FUTILITY_PRUNING_MARGIN * depth;
+          lock_guard<Spinlock> lock(split_point.spinlock);
+          if(value > split_point.best_value) split_point.best_value = value;
+          continue;
+        }
+        int reduction = late_move_reduction(move, depth, ply, split_point.in_check, move_count);
+        value = -search(-(alpha + 1), -alpha, depth - reduction - 1, ply + 1, split_point.can_make_null_move);
+        if(reduction > 0 && value > alpha)
+          value = -search(-(alpha + 1), -alpha, depth - 1, ply + 1, split_point.can_make_null_move);
+        if(value > alpha && value < split_point.beta)
+          value = -search(-split_point.beta, -alpha, depth - 1, ply + 1, split_point.can_make_null_move);
+        undo_move(move, ply);
+        bool is_alpha_move = false;
+        bool is_cutoff_move = false;
+        {
+          lock_guard<Spinlock> lock(split_point.spinlock);
+          if(split_point.cutoff_flag.load()) break;
+          if(value > split_point.best_value) {
+            split_point.pv_line.update(move, _M_stack[ply + 1].pv_line);
+            split_point.best_move = move;
+            split_point.best_value = value;
+            if(value > split_point.alpha) {
+              split_point.alpha = value;
+              is_alpha_move = true;
+              if(value >= split_point.beta) {
+                split_point.cutoff_flag.store(true);
+                is_cutoff_move = true;
+              }
+            }
+          }
+        }
+        if(is_cutoff_move) {
+          update_for_cutoff(move, depth, ply, false);
+          break;
+        }
+        if(is_alpha_move) _M_move_order.increase_history_for_alpha(_M_root_board.side(), move.from(), move.to(), depth);
+      }
+    } catch(YBWCCutoffException &e) {
+      // A cutoff in an ancestor split point is handled by the ancestor split point.
+      if(is_cutoff(split_point.parent)) throw;
+      _M_board = split_point.board;
+    }
+  }
+
+  void YBWCSinglePVSSearcher::wait_for_split_point(YBWCSplitPoint &split_point)
+  {
+    unique_lock<mutex> lock(_M_split_point_list.mutex);
+    _M_split_point_list.split_points.erase(find(_M_split_point_list.split_points.begin(), _M_split_point_list.split_points.end(), &split_point));
+    split_point.thread_count--;
+    while(split_point.thread_count > 0) {
+      _M_split_point_list.condition_variable.wait(lock);
+    }
+  }
+}
@@ -26,9 +26,11 @@ namespace peacockspider
   HashKey zobrist_white_side;
   HashKey zobrist_castlings[2][4];
   HashKey zobrist_en_passant_column[9];
+  uint64_t current_zobrist_seed;
 
   void initialize_zobrist(uint64_t seed)
   {
+    current_zobrist_seed = seed;
     mt19937_64 generator(seed);
     for(int side = 0; side < 2; side++) {
       for(int piece = 0; piece < 6; piece++) {
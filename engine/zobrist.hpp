@@ -26,6 +26,7 @@ namespace peacockspider
   extern HashKey zobrist_white_side;
   extern HashKey zobrist_castlings[2][4];
   extern HashKey zobrist_en_passant_column[9];
+  extern std::uint64_t current_zobrist_seed;
 
   void initialize_zobrist(std::uint64_t seed);
 }
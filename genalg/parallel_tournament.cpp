@@ -26,107 +26,46 @@ namespace peacockspider
   namespace genalg
   {
     ParallelTournament::ParallelTournament(int player_count, function<Table *()> fun, unsigned thread_count) :
-      Tournament(player_count), _M_has_error(false), _M_iter(0), _M_param_arrays(nullptr)
+      Tournament(player_count), _M_thread_pool(&shared_thread_pool()), _M_has_error(false), _M_iter(0), _M_param_arrays(nullptr)
     {
       for(unsigned i = 0; i < thread_count; i++) {
-        _M_threads.push_back(ParallelThread());
-        _M_threads.back().table = unique_ptr<Table>(fun());
-        _M_threads.back().command = ParallelCommand::NO_COMMAND;
-        _M_threads.back().result = ParallelResult::NO_RESULT;        
-      }
-      for(unsigned i = 0; i < thread_count; i++) {
-        _M_threads[i].thread = thread([this, i]() {
-          try {
-            unique_lock<mutex> lock(_M_threads[i].mutex);
-            while(true) {
-              while(_M_threads[i].command == ParallelCommand::NO_COMMAND) {
-                _M_threads[i].start_condition_variable.wait(lock);
-              }
-              if(_M_threads[i].command == ParallelCommand::QUIT) break;
-              if(_M_threads[i].command == ParallelCommand::PLAY) {
-                while(true) {
-                  QueueElement elem;
-                  {
-                    unique_lock<mutex> lock2(_M_mutex);
-                    if(_M_queue.empty()) break;
-                    elem = _M_queue.front();
-                    _M_queue.pop();
-                    if(_M_has_error) break;
-                  }
-                  pair<Result, bool> result_pair;
-                  if(elem.match_game_index == 0)
-                    result_pair = _M_threads[i].table->play(_M_iter, elem.round, elem.player1, (*_M_param_arrays)[elem.player1].get(), elem.player2, (*_M_param_arrays)[elem.player2].get());
-                  else
-                    result_pair = _M_threads[i].table->play(_M_iter, elem.round, elem.player2, (*_M_param_arrays)[elem.player2].get(), elem.player1, (*_M_param_arrays)[elem.player1].get());
-                  if(!result_pair.second) {
-                    unique_lock<mutex> lock2(_M_mutex);
-                    _M_has_error = true;
-                    break;
-                  }
-                  {
-                    unique_lock<mutex> lock2(_M_mutex);
-                    _M_result.set_game_result(elem.player1, elem.player2, elem.match_game_index, result_pair.first);
-                  }
-                  _M_tournament_output_function(_M_iter, elem.player1, elem.player2, elem.match_game_index, result_pair.first);
-                }
-              }
-              _M_threads[i].command = ParallelCommand::NO_COMMAND;
-              _M_threads[i].result = ParallelResult::STOP;
-              _M_threads[i].stop_condition_variable.notify_one();
-            }
-          } catch(bad_alloc &e) {
-            cerr << "Can't allocate memory" << endl;
-          }
-        });
+        _M_tables.push_back(unique_ptr<Table>(fun()));
       }
+      // The waiting thread also plays the games.
+      _M_thread_pool->reserve(thread_count - 1);
     }
     
     ParallelTournament::~ParallelTournament()
-    {
-      for(ParallelThread &thread : _M_threads) {
-        unique_lock<mutex> lock(thread.mutex);
-        thread.command = ParallelCommand::QUIT;
-        thread.start_condition_variable.notify_one();
-      }
-      for(ParallelThread &thread : _M_threads) {
-        thread.thread.join();
-      }
-    }
+    { _M_thread_pool->release(_M_tables.size() - 1); }
     
     bool ParallelTournament::play(int iter, const vector<shared_ptr<int []>> &param_arrays)
     {
-      if(!_M_threads[0].table->start_tournament(iter)) return false;
+      if(!_M_tables[0]->start_tournament(iter)) return false;
       _M_iter = iter;
       _M_param_arrays = &param_arrays;
       _M_result.clear();
       {
         unique_lock<mutex> lock(_M_mutex);
-        while(!_M_queue.empty()) {
-          _M_queue.pop();
-        }
         _M_has_error = false;
-        int round = 1;
-        for(int player1 = 0; player1 < _M_result.player_count(); player1++) {
-          for(int player2 = player1 + 1; player2 < _M_result.player_count(); player2++) {
-            for(int match_game_index = 0; match_game_index < 2; match_game_index++) {
-              _M_queue.push(QueueElement(round, player1, player2, match_game_index));
-              round++;
-            }
-          }
+        _M_free_table_indices.clear();
+        for(unsigned i = 0; i < _M_tables.size(); i++) {
+          _M_free_table_indices.push_back(i);
         }
       }
-      for(ParallelThread &thread : _M_threads) {
-        unique_lock<mutex> lock(thread.mutex);
-        thread.command = ParallelCommand::PLAY;
-        thread.start_condition_variable.notify_all();
-      }
-      for(ParallelThread &thread : _M_threads) {
-        unique_lock<mutex> lock(thread.mutex);
-        while(thread.result == ParallelResult::NO_RESULT) {
-          thread.stop_condition_variable.wait(lock);
+      // Each game is a task that plays on a free table, so the games are balanced between the
+      // threads by the thread pool.
+      int round = 1;
+      for(int player1 = 0; player1 < _M_result.player_count(); player1++) {
+        for(int player2 = player1 + 1; player2 < _M_result.player_count(); player2++) {
+          for(int match_game_index = 0; match_game_index < 2; match_game_index++) {
+            _M_task_group.run(*_M_thread_pool, [this, round, player1, player2, match_game_index]() {
+              play_game(round, player1, player2, match_game_index);
+            });
+            round++;
+          }
         }
-        thread.result = ParallelResult::NO_RESULT;
       }
+      _M_task_group.wait();
       {
         unique_lock<mutex> lock(_M_mutex);
         if(_M_has_error) return false;
@@ -134,5 +73,43 @@ namespace peacockspider
       _M_result.sort_player_indices();
       return true;
     }
+
+    void ParallelTournament::play_game(int round, int player1, int player2, int match_game_index)
+    {
+      unsigned i;
+      {
+        unique_lock<mutex> lock(_M_mutex);
+        while(_M_free_table_indices.empty()) {
+          _M_condition_variable.wait(lock);
+        }
+        if(_M_has_error) return;
+        i = _M_free_table_indices.back();
+        _M_free_table_indices.pop_back();
+      }
+      try {
+        pair<Result, bool> result_pair;
+        if(match_game_index == 0)
+          result_pair = _M_tables[i]->play(_M_iter, round, player1, (*_M_param_arrays)[player1].get(), player2, (*_M_param_arrays)[player2].get());
+        else
+          result_pair = _M_tables[i]->play(_M_iter, round, player2, (*_M_param_arrays)[player2].get(), player1, (*_M_param_arrays)[player1].get());
+        if(result_pair.second) {
+          {
+            unique_lock<mutex> lock(_M_mutex);
+            _M_result.set_game_result(player1, player2, match_game_index, result_pair.first);
+          }
+          _M_tournament_output_function(_M_iter, player1, player2, match_game_index, result_pair.first);
+        } else {
+          unique_lock<mutex> lock(_M_mutex);
+          _M_has_error = true;
+        }
+      } catch(bad_alloc &e) {
+        cerr << "Can't allocate memory" << endl;
+        unique_lock<mutex> lock(_M_mutex);
+        _M_has_error = true;
+      }
+      unique_lock<mutex> lock(_M_mutex);
+      _M_free_table_indices.push_back(i);
+      _M_condition_variable.notify_one();
+    }
   }
 }
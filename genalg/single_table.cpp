@@ -132,7 +132,7 @@ namespace peacockspider
           cerr << "Stopped" << endl;
           return make_pair(result, false);
         }
-        _M_white_thinker->think(_M_max_depth, _M_time, nullptr, numeric_limits<uint64_t>::max(), 0, move, boards, [](int depth, int value, unsigned ms, const Searcher *searcher) {});
+        _M_white_thinker->think(_M_max_depth, _M_time, nullptr, numeric_limits<uint64_t>::max(), 0, move, boards, [](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {});
         if(!boards.back().make_move(move, tmp_board)) {
           game.set_result(result);
           break;
@@ -151,7 +151,7 @@ namespace peacockspider
           cerr << "Stopped" << endl;
           return make_pair(result, false);
         }
-        _M_black_thinker->think(_M_max_depth, _M_time, nullptr, numeric_limits<uint64_t>::max(), 0, move, boards, [](int depth, int value, unsigned ms, const Searcher *searcher) {});
+        _M_black_thinker->think(_M_max_depth, _M_time, nullptr, numeric_limits<uint64_t>::max(), 0, move, boards, [](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {});
         if(!boards.back().make_move(move, tmp_board)) {
           game.set_result(result);
           break;
@@ -23,13 +23,12 @@
 #include <memory>
 #include <mutex>
 #include <ostream>
-#include <queue>
-#include <thread>
 #include <utility>
 #include <vector>
 #include "chess.hpp"
 #include "game.hpp"
 #include "search.hpp"
+#include "thread_pool.hpp"
 
 namespace peacockspider
 {
@@ -134,53 +133,14 @@ namespace peacockspider
       virtual bool play(int iter, const std::vector<std::shared_ptr<int []>> &param_arrays);
     };
     
-    struct QueueElement
-    {
-      int round;
-      int player1;
-      int player2;
-      int match_game_index;
-      
-      QueueElement() {}
-      
-      QueueElement(int round, int player1, int player2, int match_game_index) :
-        round(round), player1(player1), player2(player2), match_game_index(match_game_index) {}
-    };
-
-    enum class ParallelCommand
-    {
-      NO_COMMAND,
-      PLAY,
-      QUIT
-    };
-    
-    enum class ParallelResult
-    {
-      NO_RESULT,
-      STOP
-    };
-
-    struct ParallelThread
-    {
-      std::thread thread;
-      std::unique_ptr<Table> table;
-      std::mutex mutex;
-      std::condition_variable start_condition_variable;
-      ParallelCommand command;
-      std::condition_variable stop_condition_variable;
-      ParallelResult result;
-
-      ParallelThread() {}
-
-      ParallelThread(ParallelThread &&thread) :
-        thread(move(thread.thread)), table(move(thread.table)), command(thread.command), result(thread.result) {}
-    };
-    
     class ParallelTournament : public Tournament
     {
-      std::vector<ParallelThread> _M_threads;
+      std::vector<std::unique_ptr<Table>> _M_tables;
+      ThreadPool *_M_thread_pool;
+      TaskGroup _M_task_group;
       std::mutex _M_mutex;
-      std::queue<QueueElement> _M_queue;
+      std::condition_variable _M_condition_variable;
+      std::vector<unsigned> _M_free_table_indices;
       bool _M_has_error;
       int _M_iter;
       const std::vector<std::shared_ptr<int []>> *_M_param_arrays;
@@ -190,6 +150,8 @@ namespace peacockspider
       virtual ~ParallelTournament();
 
       virtual bool play(int iter, const std::vector<std::shared_ptr<int []>> &param_arrays);
+    private:
+      void play_game(int round, int player1, int player2, int match_game_index);
     };
 
     std::ostream &operator<<(std::ostream &os, const TournamentResult &result);
@@ -28,6 +28,7 @@
 #include "consts.hpp"
 #include "engine.hpp"
 #include "eval.hpp"
+#include "pawn_table.hpp"
 #include "protocols.hpp"
 #include "search.hpp"
 #include "tables.hpp"
@@ -49,7 +50,7 @@ namespace
     {
       "singlewithtt",
       [](const EvaluationFunction *eval_fun, unique_ptr<TranspositionTable> &transpos_table,  size_t tt_entry_count, unsigned thread_count) {
-        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count));
+        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count, thread_count));
         return new SingleSearcherWithTT(eval_fun, transpos_table.get());
       }
     },
@@ -62,37 +63,44 @@ namespace
     {
       "singlepvswithtt",
       [](const EvaluationFunction *eval_fun, unique_ptr<TranspositionTable> &transpos_table,  size_t tt_entry_count, unsigned thread_count) {
-        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count));
+        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count, thread_count));
         return new SinglePVSSearcherWithTT(eval_fun, transpos_table.get());
       }
     },
     {
       "lazysmp",
       [](const EvaluationFunction *eval_fun, unique_ptr<TranspositionTable> &transpos_table,  size_t tt_entry_count, unsigned thread_count) {
-        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count));
+        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count, thread_count));
         return new LazySMPSearcher(eval_fun, transpos_table.get(), thread_count);
       }
     },
     {
       "lazysmppvs",
       [](const EvaluationFunction *eval_fun, unique_ptr<TranspositionTable> &transpos_table,  size_t tt_entry_count, unsigned thread_count) {
-        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count));
+        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count, thread_count));
         return new LazySMPPVSSearcher(eval_fun, transpos_table.get(), thread_count);
       }
     },
     {
       "abdada",
       [](const EvaluationFunction *eval_fun, unique_ptr<TranspositionTable> &transpos_table,  size_t tt_entry_count, unsigned thread_count) {
-        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count));
+        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count, thread_count));
         return new ABDADASearcher(eval_fun, transpos_table.get(), thread_count);
       }
     },
     {
       "abdadapvs",
       [](const EvaluationFunction *eval_fun, unique_ptr<TranspositionTable> &transpos_table,  size_t tt_entry_count, unsigned thread_count) {
-        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count));
+        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count, thread_count));
         return new ABDADAPVSSearcher(eval_fun, transpos_table.get(), thread_count);
       }
+    },
+    {
+      "ybwc",
+      [](const EvaluationFunction *eval_fun, unique_ptr<TranspositionTable> &transpos_table,  size_t tt_entry_count, unsigned thread_count) {
+        transpos_table = unique_ptr<TranspositionTable>(new TranspositionTable(tt_entry_count, thread_count));
+        return new YBWCSearcher(eval_fun, transpos_table.get(), thread_count);
+      }
     }
   };
 
@@ -104,14 +112,16 @@ int main(int argc, char **argv)
   try {
     const char *log_file_name = nullptr;
     const char *searcher_name = "abdadapvs";
-    size_t tt_entry_count = (32 * 1024 * 1024) / sizeof(TranspositionTableEntry);
+    size_t tt_entry_count = transposition_table_entry_count_for_size(32);
     unsigned thread_count = 1;
+    size_t pawn_table_entry_count = DEFAULT_PAWN_TABLE_ENTRY_COUNT;
     int *eval_params = default_evaluation_parameters;
     const char *eval_file_name = nullptr;
+    const char *tt_file_name = nullptr;
     streamoff eval_skipping_count = 0;
     int c;
     opterr = 0;
-    while((c = getopt(argc, argv, "e:g:hl:np:s:t:")) != -1) {
+    while((c = getopt(argc, argv, "e:g:hl:np:P:s:t:T:")) != -1) {
       switch(c) {
         case 'e':
           eval_file_name = optarg;
@@ -137,8 +147,10 @@ int main(int argc, char **argv)
           cout << "  -l <log file name>    write to log file" << endl;
           cout << "  -n                    set number of threads as number of all processors" << endl;
           cout << "  -p <number>           set number of threads" << endl;
+          cout << "  -P <size>             set pawn hash table size in megabytes per thread" << endl;
           cout << "  -s <searcher name>    set searcher" << endl;
           cout << "  -t <size>             set transposition table size in megabytes" << endl;
+          cout << "  -T <tt file name>     load transposition table from file" << endl;
           cout << endl;
           cout << "Searchers:" << endl;
           cout << "  single                single searcher for Alpha-Beta" << endl;
@@ -149,6 +161,7 @@ int main(int argc, char **argv)
           cout << "  lazysmppvs            Lazy SMP searcher for PVS" << endl;
           cout << "  abdada                ABDADA searcher for Alpha-Beta" << endl;
           cout << "  abdadapvs             ABDADA searcher for PVS (default)" << endl;
+          cout << "  ybwc                  YBWC searcher for PVS" << endl;
           return 0;
         case 'l':
           log_file_name = optarg;
@@ -177,6 +190,23 @@ int main(int argc, char **argv)
           }
           break;
         }
+        case 'P':
+        {
+          string str(optarg);
+          istringstream iss(str);
+          size_t pawn_table_size;
+          iss >> pawn_table_size;
+          if(iss.fail() || !iss.eof()) {
+            cerr << "Incorrect number" << endl;
+            return  1;
+          }
+          if(pawn_table_size <= 0) {
+            cerr << "Too small number" << endl;
+            return 1;
+          }
+          pawn_table_entry_count = (pawn_table_size * 1024 * 1024) / sizeof(PawnTableEntry);
+          break;
+        }
         case 's':
           searcher_name = optarg;
           break;
@@ -194,9 +224,12 @@ int main(int argc, char **argv)
             cerr << "Too small number" << endl;
             return 1;
           }
-          tt_entry_count = (tt_size * 1024 * 1024) / sizeof(TranspositionTableEntry);
+          tt_entry_count = transposition_table_entry_count_for_size(tt_size);
           break;
         }
+        case 'T':
+          tt_file_name = optarg;
+          break;
         default:
           cerr << "Incorrect option" << endl;
           return 1;
@@ -237,12 +270,29 @@ int main(int argc, char **argv)
       return 1;
     }
     uint64_t zobrist_seed = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+    if(tt_file_name != nullptr) {
+      // The hash keys of the transposition table file must be generated from the same seed.
+      TranspositionTableFileHeader tt_file_header;
+      if(!TranspositionTable::read_file_header(tt_file_name, tt_file_header)) {
+        cerr << "Can't read transposition table file" << endl;
+        return 1;
+      }
+      zobrist_seed = tt_file_header.zobrist_seed;
+    }
     initialize_tables();
     initialize_zobrist(zobrist_seed);
     unique_ptr<EvaluationFunction> eval_fun(new EvaluationFunction(eval_params));
     unique_ptr<TranspositionTable> transpos_table;
     unique_ptr<Searcher> searcher(searcher_fun(eval_fun.get(), transpos_table, tt_entry_count, thread_count));
+    searcher->set_pawn_table_entry_count(pawn_table_entry_count);
     unique_ptr<Thinker> thinker(new Thinker(searcher.get()));
+    if(tt_file_name != nullptr) {
+      // The table is loaded after the thinker, because the thinker clears it for a new game.
+      if(!searcher->load_transposition_table(tt_file_name)) {
+        cerr << "Can't load transposition table" << endl;
+        return 1;
+      }
+    }
     unique_ptr<Engine> engine(new Engine(thinker.get()));
     return xboard_loop(engine.get(), ols.get(), uci_loop) ? 0 : 1;
   } catch(bad_alloc &e) {
@@ -0,0 +1,206 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+#include "consts.hpp"
+#include "eval.hpp"
+#include "perft.hpp"
+#include "search.hpp"
+#include "tables.hpp"
+#include "transpos_table.hpp"
+#include "zobrist.hpp"
+
+using namespace std;
+using namespace peacockspider;
+
+static const int SEARCH_BENCH_DEPTH = 7;
+
+int main(int argc, char **argv)
+{
+  try {
+    int max_depth = MAX_DEPTH;
+    bool has_max_depth = false;
+    bool is_undo = false;
+    bool is_search = false;
+    bool has_late_move_reductions = true;
+    PruningFlags pruning_flags;
+    vector<size_t> tt_sizes;
+    int c;
+    opterr = 0;
+    while((c = getopt(argc, argv, "d:hp:rst:u")) != -1) {
+      switch(c) {
+        case 'd':
+        {
+          string str(optarg);
+          istringstream iss(str);
+          iss >> max_depth;
+          if(iss.fail() || !iss.eof()) {
+            cerr << "Incorrect number" << endl;
+            return  1;
+          }
+          if(max_depth <= 0) {
+            cerr << "Too small number" << endl;
+            return 1;
+          }
+          has_max_depth = true;
+          break;
+        }
+        case 'h':
+          cout << "Usage: " << argv[0] << " [<option> ...]" << endl;
+          cout << endl;
+          cout << "Options:" << endl;
+          cout << "  -d <depth>            set maximal perft depth or search depth" << endl;
+          cout << "  -h                    display this text" << endl;
+          cout << "  -p <technique>        disable pruning technique for search" << endl;
+          cout << "                        (rfp, futility, razoring, delta, see)" << endl;
+          cout << "  -r                    disable late move reductions for search" << endl;
+          cout << "  -s                    search positions instead of perft" << endl;
+          cout << "  -t <size>             add transposition table size in megabytes for search" << endl;
+          cout << "  -u                    make and unmake moves instead of copying boards" << endl;
+          return 0;
+        case 'p':
+        {
+          string str(optarg);
+          if(str == "rfp") {
+            pruning_flags.reverse_futility_pruning = false;
+          } else if(str == "futility") {
+            pruning_flags.futility_pruning = false;
+          } else if(str == "razoring") {
+            pruning_flags.razoring = false;
+          } else if(str == "delta") {
+            pruning_flags.delta_pruning = false;
+          } else if(str == "see") {
+            pruning_flags.see_pruning = false;
+          } else {
+            cerr << "Unknown pruning technique" << endl;
+            return 1;
+          }
+          break;
+        }
+        case 'r':
+          has_late_move_reductions = false;
+          break;
+        case 's':
+          is_search = true;
+          break;
+        case 't':
+        {
+          string str(optarg);
+          istringstream iss(str);
+          size_t tt_size;
+          iss >> tt_size;
+          if(iss.fail() || !iss.eof()) {
+            cerr << "Incorrect number" << endl;
+            return  1;
+          }
+          if(tt_size <= 0) {
+            cerr << "Too small number" << endl;
+            return 1;
+          }
+          tt_sizes.push_back(tt_size);
+          break;
+        }
+        case 'u':
+          is_undo = true;
+          break;
+        default:
+          cerr << "Incorrect option" << endl;
+          return 1;
+      }
+    }
+    uint64_t zobrist_seed = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+    initialize_tables();
+    initialize_zobrist(zobrist_seed);
+    if(is_search) {
+      // Searches each position by iterative deepening for every transposition table size.
+      if(tt_sizes.empty()) tt_sizes.push_back(32);
+      int search_depth = (has_max_depth ? max_depth : SEARCH_BENCH_DEPTH);
+      EvaluationFunction eval_fun;
+      for(size_t tt_size : tt_sizes) {
+        TranspositionTable transpos_table(transposition_table_entry_count_for_size(tt_size));
+        SinglePVSSearcherWithTT searcher(&eval_fun, &transpos_table);
+        searcher.set_late_move_reduction_table(LateMoveReductionTable(has_late_move_reductions, DEFAULT_LATE_MOVE_REDUCTION_BASE, DEFAULT_LATE_MOVE_REDUCTION_DIVISOR));
+        searcher.set_pruning_flags(pruning_flags);
+        uint64_t all_nodes = 0;
+        unsigned all_ms = 0;
+        cout << "tt size " << tt_size << "MB" << endl;
+        for(size_t i = 0; i < perft_position_count; i++) {
+          const PerftPosition &position = perft_positions[i];
+          Board board(position.fen);
+          vector<Board> boards;
+          boards.push_back(board);
+          searcher.clear_for_new_game();
+          searcher.clear();
+          searcher.set_board(board);
+          uint64_t nodes = 0;
+          auto start_time = chrono::high_resolution_clock::now();
+          for(int depth = 1; depth <= search_depth; depth++) {
+            Move best_move;
+            searcher.search_from_root(MIN_VALUE, MAX_VALUE, depth, nullptr, best_move, boards, nullptr);
+            nodes += searcher.nodes();
+          }
+          auto end_time = chrono::high_resolution_clock::now();
+          unsigned ms = chrono::duration_cast<chrono::milliseconds>(end_time - start_time).count();
+          uint64_t nps = nodes * 1000 / (ms > 0 ? ms : 1);
+          cout << position.fen << endl;
+          cout << "  depth " << search_depth << " nodes " << nodes << " time " << ms << " nps " << nps << endl;
+          all_nodes += nodes;
+          all_ms += ms;
+        }
+        uint64_t all_nps = all_nodes * 1000 / (all_ms > 0 ? all_ms : 1);
+        cout << "nodes " << all_nodes << " time " << all_ms << " nps " << all_nps << endl;
+      }
+      return 0;
+    }
+    bool is_success = true;
+    uint64_t all_nodes = 0;
+    unsigned all_ms = 0;
+    for(size_t i = 0; i < perft_position_count; i++) {
+      const PerftPosition &position = perft_positions[i];
+      int depth = min(position.depth, max_depth);
+      Board board(position.fen);
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT * depth]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      auto start_time = chrono::high_resolution_clock::now();
+      uint64_t nodes = (is_undo ? perft_with_undo(board, depth, move_pairs) : perft(board, depth, move_pairs));
+      auto end_time = chrono::high_resolution_clock::now();
+      unsigned ms = chrono::duration_cast<chrono::milliseconds>(end_time - start_time).count();
+      uint64_t nps = nodes * 1000 / (ms > 0 ? ms : 1);
+      cout << position.fen << endl;
+      cout << "  depth " << depth << " nodes " << nodes << " time " << ms << " nps " << nps;
+      if(depth == position.depth && nodes != position.nodes) {
+        cout << " (expected " << position.nodes << ")";
+        is_success = false;
+      }
+      cout << endl;
+      all_nodes += nodes;
+      all_ms += ms;
+    }
+    uint64_t all_nps = all_nodes * 1000 / (all_ms > 0 ? all_ms : 1);
+    cout << "nodes " << all_nodes << " time " << all_ms << " nps " << all_nps << endl;
+    return is_success ? 0 : 1;
+  } catch(bad_alloc &e) {
+    cerr << "Can't allocate memory" << endl;
+    return 1;
+  }
+}
@@ -38,5 +38,29 @@ namespace peacockspider
       delete _M_transposition_table;
       delete _M_evaluation_function;
     }
+
+    void ABDADASearcherTests::test_searcher_changes_thread_count()
+    {
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      Board board("r1bqkb1r/pppp1ppp/2n2n2/4p3/4P3/2N2N2/PPPP1PPP/R1BQKB1R w KQkq - 0 4");
+      board.generate_pseudolegal_moves(move_pairs);
+      CPPUNIT_ASSERT_EQUAL(true, _M_searcher->can_set_thread_count());
+      unsigned thread_counts[] = { 4, 1, 3 };
+      for(unsigned thread_count : thread_counts) {
+        vector<Board> boards;
+        Move best_move;
+        _M_searcher->set_thread_count(thread_count);
+        CPPUNIT_ASSERT_EQUAL(thread_count, _M_searcher->thread_count());
+        CPPUNIT_ASSERT_EQUAL(thread_count, _M_transposition_table->thread_count());
+        _M_searcher->clear_for_new_game();
+        _M_searcher->set_board(board);
+        boards.push_back(board);
+        int value = _M_searcher->search_from_root(MIN_VALUE, MAX_VALUE, 3, nullptr, best_move, boards, nullptr);
+        CPPUNIT_ASSERT(value >= MIN_VALUE && value <= MAX_VALUE);
+        CPPUNIT_ASSERT(move_pairs.contain_move(best_move));
+        CPPUNIT_ASSERT(board.has_legal_move(best_move));
+      }
+    }
   }
 }
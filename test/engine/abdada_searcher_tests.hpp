@@ -27,6 +27,7 @@ namespace peacockspider
     class ABDADASearcherTests : public SearcherTests
     {
       CPPUNIT_TEST_SUB_SUITE(ABDADASearcherTests, SearcherTests);
+      CPPUNIT_TEST(test_searcher_changes_thread_count);
       CPPUNIT_TEST_SUITE_END();
     protected:
       TranspositionTable *_M_transposition_table;
@@ -34,6 +35,8 @@ namespace peacockspider
       void setUp();
 
       void tearDown();
+
+      void test_searcher_changes_thread_count();
     };
   }
 }
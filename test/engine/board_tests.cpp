@@ -1378,6 +1378,179 @@ namespace peacockspider
       CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::KNIGHT, C6, D4, PromotionPiece::NONE)));
     }
     
+    void BoardTests::test_board_generate_pseudolegal_quiet_moves_method_generates_moves_for_white_side()
+    {
+      Board board("4k3/1P6/8/3p4/2P5/3b1N2/4P3/R3K3 w Q - 0 1");
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      board.generate_pseudolegal_quiet_moves(move_pairs);
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(25), move_pairs.length());
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::PAWN, C4, C5, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::PAWN, E2, E3, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::PAWN, E2, E4, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::KNIGHT, F3, G5, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::ROOK, A1, A8, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::KING, E1, C1, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!move_pairs.contain_move(Move(Piece::PAWN, E2, D3, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!move_pairs.contain_move(Move(Piece::PAWN, C4, D5, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!move_pairs.contain_move(Move(Piece::PAWN, B7, B8, PromotionPiece::QUEEN)));
+    }
+
+    void BoardTests::test_board_generate_pseudolegal_quiet_moves_method_generates_moves_for_black_side()
+    {
+      Board board("r3k3/4p3/5P2/2p5/1B1N4/8/6p1/4K3 b q - 0 1");
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      board.generate_pseudolegal_quiet_moves(move_pairs);
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(18), move_pairs.length());
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::PAWN, E7, E6, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::PAWN, E7, E5, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::PAWN, C5, C4, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::ROOK, A8, A1, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::KING, E8, C8, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!move_pairs.contain_move(Move(Piece::PAWN, C5, B4, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!move_pairs.contain_move(Move(Piece::PAWN, E7, F6, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!move_pairs.contain_move(Move(Piece::PAWN, G2, G1, PromotionPiece::QUEEN)));
+    }
+
+    void BoardTests::test_board_has_pseudolegal_move_method_returns_true_for_pseudolegal_moves()
+    {
+      Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1");
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      board.generate_pseudolegal_moves(move_pairs);
+      for(size_t i = 0; i < move_pairs.length(); i++) {
+        CPPUNIT_ASSERT(board.has_pseudolegal_move(move_pairs[i].move));
+      }
+      Board board2("4k3/1P6/8/2Pp4/8/8/8/4K3 w - d6 0 1");
+      CPPUNIT_ASSERT(board2.has_pseudolegal_move(Move(Piece::PAWN, C5, D6, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(board2.has_pseudolegal_move(Move(Piece::PAWN, B7, B8, PromotionPiece::KNIGHT)));
+    }
+
+    void BoardTests::test_board_has_pseudolegal_move_method_returns_false_for_non_pseudolegal_moves()
+    {
+      Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      CPPUNIT_ASSERT(!board.has_pseudolegal_move(Move(Piece::PAWN, -1, -1, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!board.has_pseudolegal_move(Move(Piece::QUEEN, F3, F7, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!board.has_pseudolegal_move(Move(Piece::ROOK, H1, H3, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!board.has_pseudolegal_move(Move(Piece::KNIGHT, E5, F3, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!board.has_pseudolegal_move(Move(Piece::PAWN, A2, B3, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!board.has_pseudolegal_move(Move(Piece::PAWN, B2, B4, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!board.has_pseudolegal_move(Move(Piece::PAWN, D5, D6, PromotionPiece::QUEEN)));
+      CPPUNIT_ASSERT(!board.has_pseudolegal_move(Move(Piece::KING, E1, E3, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!board.has_pseudolegal_move(Move(Piece::ROOK, A8, A7, PromotionPiece::NONE)));
+    }
+
+    void BoardTests::test_board_checker_bitboard_method_returns_checkers()
+    {
+      Board board("4k3/8/8/8/1b6/8/3P4/r3K1n1 w - - 0 1");
+      CPPUNIT_ASSERT_EQUAL((static_cast<Bitboard>(1) << A1), board.checker_bitboard());
+      Board board2("4k3/8/8/8/1b6/8/8/r3K1n1 w - - 0 1");
+      CPPUNIT_ASSERT_EQUAL((static_cast<Bitboard>(1) << A1) | (static_cast<Bitboard>(1) << B4), board2.checker_bitboard());
+      Board board3("4k3/8/8/8/8/8/3P4/4K3 w - - 0 1");
+      CPPUNIT_ASSERT_EQUAL(static_cast<Bitboard>(0), board3.checker_bitboard());
+    }
+
+    void BoardTests::test_board_pinned_piece_bitboard_method_returns_pinned_pieces()
+    {
+      Board board("4r1k1/8/8/b7/8/2N5/4P3/4K3 w - - 0 1");
+      CPPUNIT_ASSERT_EQUAL((static_cast<Bitboard>(1) << C3) | (static_cast<Bitboard>(1) << E2), board.pinned_piece_bitboard());
+      Board board2("4r1k1/8/8/b7/8/2N5/3PP3/4K3 w - - 0 1");
+      CPPUNIT_ASSERT_EQUAL(static_cast<Bitboard>(1) << E2, board2.pinned_piece_bitboard());
+      Board board3("4r1k1/8/8/8/4N3/8/4P3/4K3 w - - 0 1");
+      CPPUNIT_ASSERT_EQUAL(static_cast<Bitboard>(0), board3.pinned_piece_bitboard());
+    }
+
+    void BoardTests::test_board_see_method_evaluates_exchanges()
+    {
+      int piece_values[6] = { 100, 300, 300, 500, 900, 10000 };
+      Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      CPPUNIT_ASSERT_EQUAL(300, board.see(Move(Piece::BISHOP, E2, A6, PromotionPiece::NONE), piece_values));
+      CPPUNIT_ASSERT_EQUAL(0, board.see(Move(Piece::PAWN, D5, E6, PromotionPiece::NONE), piece_values));
+      CPPUNIT_ASSERT_EQUAL(-600, board.see(Move(Piece::QUEEN, F3, F6, PromotionPiece::NONE), piece_values));
+      // The rook on h8 defends the pawn on h3 through the empty h file.
+      CPPUNIT_ASSERT_EQUAL(-300, board.see(Move(Piece::QUEEN, F3, H3, PromotionPiece::NONE), piece_values));
+      // The rook on e1 is behind the rook on e2.
+      Board board2("4k3/4r3/8/4p3/8/8/4R3/4RK2 w - - 0 1");
+      CPPUNIT_ASSERT_EQUAL(100, board2.see(Move(Piece::ROOK, E2, E5, PromotionPiece::NONE), piece_values));
+      Board board3("4k3/4r3/8/4p3/8/8/4R3/5K2 w - - 0 1");
+      CPPUNIT_ASSERT_EQUAL(-400, board3.see(Move(Piece::ROOK, E2, E5, PromotionPiece::NONE), piece_values));
+      Board board4("8/8/3k4/8/2pP4/8/8/3KR3 b - d3 0 1");
+      CPPUNIT_ASSERT_EQUAL(100, board4.see(Move(Piece::PAWN, C4, D3, PromotionPiece::NONE), piece_values));
+    }
+
+    void BoardTests::test_board_generate_legal_moves_method_generates_only_legal_moves()
+    {
+      const char *fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+        "8/8/3k4/8/2pP4/8/8/3KR3 b - d3 0 1"
+      };
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT * 2]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      MovePairList pseudolegal_move_pairs(tmp_move_pairs.get() + MAX_MOVE_COUNT, 0);
+      for(const char *fen : fens) {
+        Board board(fen);
+        board.generate_legal_moves(move_pairs);
+        board.generate_pseudolegal_moves(pseudolegal_move_pairs);
+        size_t legal_move_count = 0;
+        for(size_t i = 0; i < pseudolegal_move_pairs.length(); i++) {
+          Board tmp_board;
+          Move move = pseudolegal_move_pairs[i].move;
+          if(board.make_move(move, tmp_board)) {
+            CPPUNIT_ASSERT(move_pairs.contain_move(move));
+            legal_move_count++;
+          }
+        }
+        CPPUNIT_ASSERT_EQUAL(legal_move_count, move_pairs.length());
+      }
+    }
+
+    void BoardTests::test_board_generate_legal_moves_method_generates_moves_for_double_check()
+    {
+      Board board("4k3/8/8/8/1b5Q/8/8/r3K1n1 w - - 0 1");
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      board.generate_legal_moves(move_pairs);
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), move_pairs.length());
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::KING, E1, F2, PromotionPiece::NONE)));
+    }
+
+    void BoardTests::test_board_generate_legal_moves_method_does_not_generate_en_passant_for_discovered_check()
+    {
+      Board board("7k/8/8/KPp4r/8/8/8/8 w - c6 0 1");
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      board.generate_legal_moves(move_pairs);
+      CPPUNIT_ASSERT(!move_pairs.contain_move(Move(Piece::PAWN, B5, C6, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::PAWN, B5, B6, PromotionPiece::NONE)));
+      Board board2("7k/8/8/1Pp5/K7/8/8/8 w - c6 0 1");
+      board2.generate_legal_moves(move_pairs);
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::PAWN, B5, C6, PromotionPiece::NONE)));
+    }
+
+    void BoardTests::test_board_generate_legal_good_moves_method_generates_captures_for_check()
+    {
+      Board board("4k3/1p6/8/8/8/8/6Q1/4K2r w - - 0 1");
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      board.generate_legal_good_moves(move_pairs);
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), move_pairs.length());
+      CPPUNIT_ASSERT(move_pairs.contain_move(Move(Piece::QUEEN, G2, H1, PromotionPiece::NONE)));
+    }
+
+    void BoardTests::test_board_has_legal_move_method_returns_true_for_pinned_piece_moves_on_line()
+    {
+      Board board("4k3/4r3/8/8/8/8/4R3/4K3 w - - 0 1");
+      CPPUNIT_ASSERT(board.has_legal_move(Move(Piece::ROOK, E2, E5, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(board.has_legal_move(Move(Piece::ROOK, E2, E7, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT(!board.has_legal_move(Move(Piece::ROOK, E2, D2, PromotionPiece::NONE)));
+    }
+
     void BoardTests::test_board_make_move_method_makes_move_for_piece()
     {
       Board board("4k3/8/2b5/8/8/2B3N1/8/4K3 w - - 0 1");
@@ -1714,6 +1887,170 @@ namespace peacockspider
       CPPUNIT_ASSERT(Board("rnbqkbnr/p1pp1ppp/8/4p3/1pP1P3/5N1P/PP1P1PP1/RNBQKB1R w KQkq - 0 5") == board2);
     }
 
+    void BoardTests::test_board_do_move_method_makes_same_moves_as_make_move_method()
+    {
+      const char *fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbqkb1r/ppp2ppp/5n2/2Ppp3/4P3/8/PP1P1PPP/RNBQKBNR w KQkq d6 0 4",
+        "rnbqkbnr/p1pp1ppp/8/4p3/1pP1P3/5N1P/PP1P1PP1/RNBQKB1R b KQkq c3 0 4"
+      };
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      for(const char *fen : fens) {
+        Board board(fen);
+        board.generate_legal_moves(move_pairs);
+        for(size_t i = 0; i < move_pairs.length(); i++) {
+          Move move = move_pairs[i].move;
+          Board expected_board;
+          board.make_move(move, expected_board);
+          Board board2 = board;
+          UndoRecord undo;
+          board2.do_move(move, undo);
+          CPPUNIT_ASSERT(expected_board == board2);
+          CPPUNIT_ASSERT_EQUAL(expected_board.hash_key(), board2.hash_key());
+          CPPUNIT_ASSERT(board2.has_consistent_pieces());
+        }
+      }
+    }
+
+    void BoardTests::test_board_undo_move_method_restores_board()
+    {
+      const char *fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbqkb1r/ppp2ppp/5n2/2Ppp3/4P3/8/PP1P1PPP/RNBQKBNR w KQkq d6 0 4",
+        "rnbqkbnr/p1pp1ppp/8/4p3/1pP1P3/5N1P/PP1P1PP1/RNBQKB1R b KQkq c3 0 4"
+      };
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      for(const char *fen : fens) {
+        Board board(fen);
+        board.generate_legal_moves(move_pairs);
+        for(size_t i = 0; i < move_pairs.length(); i++) {
+          Move move = move_pairs[i].move;
+          Board board2 = board;
+          UndoRecord undo;
+          board2.do_move(move, undo);
+          board2.undo_move(move, undo);
+          CPPUNIT_ASSERT(board == board2);
+          CPPUNIT_ASSERT_EQUAL(board.hash_key(), board2.hash_key());
+          CPPUNIT_ASSERT(board2.has_consistent_pieces());
+        }
+      }
+    }
+
+    void BoardTests::test_board_do_null_move_method_makes_same_null_move_as_make_null_move_method()
+    {
+      Board board("rnbqkbnr/p1pp1ppp/8/4p3/1pP1P3/5N1P/PP1P1PP1/RNBQKB1R b KQkq c3 0 4");
+      Board expected_board;
+      board.make_null_move(expected_board);
+      Board board2 = board;
+      UndoRecord undo;
+      board2.do_null_move(undo);
+      CPPUNIT_ASSERT(expected_board == board2);
+      CPPUNIT_ASSERT_EQUAL(expected_board.hash_key(), board2.hash_key());
+      board2.undo_null_move(undo);
+      CPPUNIT_ASSERT(board == board2);
+      CPPUNIT_ASSERT_EQUAL(board.hash_key(), board2.hash_key());
+    }
+
+    void BoardTests::test_board_pieces_are_consistent_after_setting_and_making_moves()
+    {
+      const char *fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbqkbnr/p1pp1ppp/8/4p3/1pP1P3/5N1P/PP1P1PP1/RNBQKB1R b KQkq c3 0 4"
+      };
+      CPPUNIT_ASSERT(Board().has_consistent_pieces());
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      for(const char *fen : fens) {
+        Board board(fen);
+        CPPUNIT_ASSERT(board.has_consistent_pieces());
+        board.generate_legal_moves(move_pairs);
+        for(size_t i = 0; i < move_pairs.length(); i++) {
+          Board board2;
+          CPPUNIT_ASSERT(board.make_move(move_pairs[i].move, board2));
+          CPPUNIT_ASSERT(board2.has_consistent_pieces());
+        }
+        Board board3;
+        board.make_null_move(board3);
+        CPPUNIT_ASSERT(board3.has_consistent_pieces());
+      }
+    }
+
+    void BoardTests::test_board_piece_mutators_keep_pieces_consistent()
+    {
+      Board board;
+      board.set_piece(E4, Piece::QUEEN);
+      CPPUNIT_ASSERT(board.has_consistent_pieces());
+      CPPUNIT_ASSERT(make_pair(Piece::QUEEN, true) == board.piece_pair(E4));
+      CPPUNIT_ASSERT((board.piece_bitboard(Piece::QUEEN) & (static_cast<Bitboard>(1) << E4)) != 0);
+      board.unset_piece(E2);
+      CPPUNIT_ASSERT(board.has_consistent_pieces());
+      CPPUNIT_ASSERT(make_pair(Piece::PAWN, false) == board.piece_pair(E2));
+      CPPUNIT_ASSERT((board.piece_bitboard(Piece::PAWN) & (static_cast<Bitboard>(1) << E2)) == 0);
+      board.set_piece_pair(E7, make_pair(Piece::KNIGHT, true));
+      CPPUNIT_ASSERT(board.has_consistent_pieces());
+      CPPUNIT_ASSERT(make_pair(Piece::KNIGHT, true) == board.piece_pair(E7));
+      CPPUNIT_ASSERT((board.piece_bitboard(Piece::PAWN) & (static_cast<Bitboard>(1) << E7)) == 0);
+    }
+
+    void BoardTests::test_board_pawn_hash_key_is_updated_after_making_moves()
+    {
+      const char *fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+        "rnbqkb1r/ppp2ppp/5n2/2Ppp3/4P3/8/PP1P1PPP/RNBQKBNR w KQkq d6 0 4"
+      };
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      for(const char *fen : fens) {
+        Board board(fen);
+        board.generate_legal_moves(move_pairs);
+        for(size_t i = 0; i < move_pairs.length(); i++) {
+          Board board2;
+          CPPUNIT_ASSERT(board.make_move(move_pairs[i].move, board2));
+          Board board3 = board2;
+          board3.update_hash_key();
+          CPPUNIT_ASSERT(board3.pawn_hash_key() == board2.pawn_hash_key());
+        }
+        Board board4;
+        board.make_null_move(board4);
+        CPPUNIT_ASSERT(board.pawn_hash_key() == board4.pawn_hash_key());
+      }
+    }
+
+    void BoardTests::test_board_pawn_hash_key_is_updated_after_doing_and_undoing_moves()
+    {
+      const char *fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+        "rnbqkb1r/ppp2ppp/5n2/2Ppp3/4P3/8/PP1P1PPP/RNBQKBNR w KQkq d6 0 4"
+      };
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      for(const char *fen : fens) {
+        Board board(fen);
+        HashKey pawn_hash_key = board.pawn_hash_key();
+        board.generate_legal_moves(move_pairs);
+        for(size_t i = 0; i < move_pairs.length(); i++) {
+          UndoRecord undo;
+          board.do_move(move_pairs[i].move, undo);
+          Board board2 = board;
+          board2.update_hash_key();
+          CPPUNIT_ASSERT(board2.pawn_hash_key() == board.pawn_hash_key());
+          board.undo_move(move_pairs[i].move, undo);
+          CPPUNIT_ASSERT(pawn_hash_key == board.pawn_hash_key());
+        }
+      }
+    }
+
     void BoardTests::test_board_set_method_complains_for_white_side_and_bug_of_board_setting_check()
     {
       Board board;
@@ -117,6 +117,18 @@ namespace peacockspider
       CPPUNIT_TEST(test_board_generate_pseudolegal_good_moves_method_does_not_generate_castlings_for_black_side);
       CPPUNIT_TEST(test_board_generate_pseudolegal_good_moves_method_generates_captures_for_white_side_and_pieces);
       CPPUNIT_TEST(test_board_generate_pseudolegal_good_moves_method_generates_captures_for_black_side_and_pieces);
+      CPPUNIT_TEST(test_board_generate_pseudolegal_quiet_moves_method_generates_moves_for_white_side);
+      CPPUNIT_TEST(test_board_generate_pseudolegal_quiet_moves_method_generates_moves_for_black_side);
+      CPPUNIT_TEST(test_board_has_pseudolegal_move_method_returns_true_for_pseudolegal_moves);
+      CPPUNIT_TEST(test_board_has_pseudolegal_move_method_returns_false_for_non_pseudolegal_moves);
+      CPPUNIT_TEST(test_board_checker_bitboard_method_returns_checkers);
+      CPPUNIT_TEST(test_board_pinned_piece_bitboard_method_returns_pinned_pieces);
+      CPPUNIT_TEST(test_board_see_method_evaluates_exchanges);
+      CPPUNIT_TEST(test_board_generate_legal_moves_method_generates_only_legal_moves);
+      CPPUNIT_TEST(test_board_generate_legal_moves_method_generates_moves_for_double_check);
+      CPPUNIT_TEST(test_board_generate_legal_moves_method_does_not_generate_en_passant_for_discovered_check);
+      CPPUNIT_TEST(test_board_generate_legal_good_moves_method_generates_captures_for_check);
+      CPPUNIT_TEST(test_board_has_legal_move_method_returns_true_for_pinned_piece_moves_on_line);
       CPPUNIT_TEST(test_board_make_move_method_makes_move_for_piece);
       CPPUNIT_TEST(test_board_make_move_method_makes_capture_for_piece);
       CPPUNIT_TEST(test_board_make_move_method_makes_capture_for_king_and_captured_pawn);
@@ -160,6 +172,13 @@ namespace peacockspider
       CPPUNIT_TEST(test_board_make_null_move_method_makes_null_move_for_black_side);
       CPPUNIT_TEST(test_board_make_null_move_method_does_not_set_en_passant_column_for_white_side_and_en_passant);
       CPPUNIT_TEST(test_board_make_null_move_method_does_not_set_en_passant_column_for_black_side_and_en_passant);
+      CPPUNIT_TEST(test_board_do_move_method_makes_same_moves_as_make_move_method);
+      CPPUNIT_TEST(test_board_undo_move_method_restores_board);
+      CPPUNIT_TEST(test_board_do_null_move_method_makes_same_null_move_as_make_null_move_method);
+      CPPUNIT_TEST(test_board_pieces_are_consistent_after_setting_and_making_moves);
+      CPPUNIT_TEST(test_board_piece_mutators_keep_pieces_consistent);
+      CPPUNIT_TEST(test_board_pawn_hash_key_is_updated_after_making_moves);
+      CPPUNIT_TEST(test_board_pawn_hash_key_is_updated_after_doing_and_undoing_moves);
       CPPUNIT_TEST(test_board_set_method_complains_for_white_side_and_bug_of_board_setting_check);
       CPPUNIT_TEST(test_board_set_method_complains_for_black_side_and_bug_of_board_setting_check);
       CPPUNIT_TEST_SUITE_END();
@@ -256,6 +275,18 @@ namespace peacockspider
       void test_board_generate_pseudolegal_good_moves_method_does_not_generate_castlings_for_black_side();
       void test_board_generate_pseudolegal_good_moves_method_generates_captures_for_white_side_and_pieces();
       void test_board_generate_pseudolegal_good_moves_method_generates_captures_for_black_side_and_pieces();
+      void test_board_generate_pseudolegal_quiet_moves_method_generates_moves_for_white_side();
+      void test_board_generate_pseudolegal_quiet_moves_method_generates_moves_for_black_side();
+      void test_board_has_pseudolegal_move_method_returns_true_for_pseudolegal_moves();
+      void test_board_has_pseudolegal_move_method_returns_false_for_non_pseudolegal_moves();
+      void test_board_checker_bitboard_method_returns_checkers();
+      void test_board_pinned_piece_bitboard_method_returns_pinned_pieces();
+      void test_board_see_method_evaluates_exchanges();
+      void test_board_generate_legal_moves_method_generates_only_legal_moves();
+      void test_board_generate_legal_moves_method_generates_moves_for_double_check();
+      void test_board_generate_legal_moves_method_does_not_generate_en_passant_for_discovered_check();
+      void test_board_generate_legal_good_moves_method_generates_captures_for_check();
+      void test_board_has_legal_move_method_returns_true_for_pinned_piece_moves_on_line();
       void test_board_make_move_method_makes_move_for_piece();
       void test_board_make_move_method_makes_capture_for_piece();
       void test_board_make_move_method_makes_capture_for_king_and_captured_pawn();
@@ -299,6 +330,13 @@ namespace peacockspider
       void test_board_make_null_move_method_makes_null_move_for_black_side();
       void test_board_make_null_move_method_does_not_set_en_passant_column_for_white_side_and_en_passant();
       void test_board_make_null_move_method_does_not_set_en_passant_column_for_black_side_and_en_passant();
+      void test_board_do_move_method_makes_same_moves_as_make_move_method();
+      void test_board_undo_move_method_restores_board();
+      void test_board_do_null_move_method_makes_same_null_move_as_make_null_move_method();
+      void test_board_pieces_are_consistent_after_setting_and_making_moves();
+      void test_board_piece_mutators_keep_pieces_consistent();
+      void test_board_pawn_hash_key_is_updated_after_making_moves();
+      void test_board_pawn_hash_key_is_updated_after_doing_and_undoing_moves();
       void test_board_set_method_complains_for_white_side_and_bug_of_board_setting_check();
       void test_board_set_method_complains_for_black_side_and_bug_of_board_setting_check();
     };
@@ -36,17 +36,17 @@ namespace peacockspider
     {
       vector<Board> boards {
         Board("4k3/8/1b6/8/8/6B1/8/4K3 w - - 0 1"),
-        Board("4k3/8/1b6/8/8/8/5B2/4K3 b - - 0 1"),
-        Board("4k3/2b5/8/8/8/8/5B2/4K3 w - - 0 2"),
-        Board("4k3/2b5/8/8/8/6B1/8/4K3 b - - 0 2"),
-        Board("4k3/8/1b6/8/8/6B1/8/4K3 w - - 0 3"),
-        Board("4k3/8/1b6/8/8/8/5B2/4K3 b - - 0 3"),
-        Board("4k3/2b5/8/8/8/8/5B2/4K3 w - - 0 4"),
-        Board("4k3/2b5/8/8/8/6B1/8/4K3 b - - 0 4"),
-        Board("4k3/8/1b6/8/8/6B1/8/4K3 w - - 0 5"),
-        Board("4k3/8/1b6/8/8/8/5B2/4K3 b - - 0 5"),
-        Board("4k3/2b5/8/8/8/8/5B2/4K3 w - - 0 6"),
-        Board("4k3/2b5/8/8/8/6B1/8/4K3 b - - 0 6")
+        Board("4k3/8/1b6/8/8/8/5B2/4K3 b - - 1 1"),
+        Board("4k3/2b5/8/8/8/8/5B2/4K3 w - - 2 2"),
+        Board("4k3/2b5/8/8/8/6B1/8/4K3 b - - 3 2"),
+        Board("4k3/8/1b6/8/8/6B1/8/4K3 w - - 4 3"),
+        Board("4k3/8/1b6/8/8/8/5B2/4K3 b - - 5 3"),
+        Board("4k3/2b5/8/8/8/8/5B2/4K3 w - - 6 4"),
+        Board("4k3/2b5/8/8/8/6B1/8/4K3 b - - 7 4"),
+        Board("4k3/8/1b6/8/8/6B1/8/4K3 w - - 8 5"),
+        Board("4k3/8/1b6/8/8/8/5B2/4K3 b - - 9 5"),
+        Board("4k3/2b5/8/8/8/8/5B2/4K3 w - - 10 6"),
+        Board("4k3/2b5/8/8/8/6B1/8/4K3 b - - 11 6")
       };
       Board board("4k3/8/1b6/8/8/6B1/8/4K3 w - - 0 1");
       CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), repetitions(board, boards));
@@ -56,17 +56,17 @@ namespace peacockspider
     {
       vector<Board> boards {
         Board("4k3/2n5/8/8/8/8/5N2/4K3 w - - 0 1"),
-        Board("4k3/2n5/8/8/8/3N4/8/4K3 b - - 0 1"),
-        Board("4k3/8/8/3n4/8/3N4/8/4K3 w - - 0 2"),
-        Board("4k3/8/8/3n4/8/8/5N2/4K3 b - - 0 2"),
-        Board("4k3/2n5/8/8/8/8/5N2/4K3 w - - 0 3"),
-        Board("4k3/2n5/8/8/8/3N4/8/4K3 b - - 0 3"),
-        Board("4k3/8/8/3n4/8/3N4/8/4K3 w - - 0 4"),
-        Board("4k3/8/8/3n4/8/8/5N2/4K3 b - - 0 4"),
-        Board("4k3/2n5/8/8/8/8/5N2/4K3 w - - 0 5"),
-        Board("4k3/2n5/8/8/8/3N4/8/4K3 b - - 0 5"),
-        Board("4k3/8/8/3n4/8/3N4/8/4K3 w - - 0 6"),
-        Board("4k3/8/8/3n4/8/8/5N2/4K3 b - - 0 6")
+        Board("4k3/2n5/8/8/8/3N4/8/4K3 b - - 1 1"),
+        Board("4k3/8/8/3n4/8/3N4/8/4K3 w - - 2 2"),
+        Board("4k3/8/8/3n4/8/8/5N2/4K3 b - - 3 2"),
+        Board("4k3/2n5/8/8/8/8/5N2/4K3 w - - 4 3"),
+        Board("4k3/2n5/8/8/8/3N4/8/4K3 b - - 5 3"),
+        Board("4k3/8/8/3n4/8/3N4/8/4K3 w - - 6 4"),
+        Board("4k3/8/8/3n4/8/8/5N2/4K3 b - - 7 4"),
+        Board("4k3/2n5/8/8/8/8/5N2/4K3 w - - 8 5"),
+        Board("4k3/2n5/8/8/8/3N4/8/4K3 b - - 9 5"),
+        Board("4k3/8/8/3n4/8/3N4/8/4K3 w - - 10 6"),
+        Board("4k3/8/8/3n4/8/8/5N2/4K3 b - - 11 6")
       };
       Board board("4k3/2n5/8/8/8/8/5N2/4K3 w - - 0 1");
       CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), repetitions(board, boards, nullptr));
@@ -76,23 +76,132 @@ namespace peacockspider
     {
       vector<Board> boards {
         Board("4k3/2r5/8/8/8/8/6R1/4K3 w - - 0 1"),
-        Board("4k3/2r5/8/8/6R1/8/8/4K3 b - - 0 1"),
-        Board("4k3/8/8/2r5/6R1/8/8/4K3 w - - 0 2"),
-        Board("4k3/8/8/2r5/8/8/6R1/4K3 b - - 0 2"),
-        Board("4k3/2r5/8/8/8/8/6R1/4K3 w - - 0 3"),
-        Board("4k3/2r5/8/8/6R1/8/8/4K3 b - - 0 3"),
-        Board("4k3/8/8/2r5/6R1/8/8/4K3 w - - 0 4"),
-        Board("4k3/8/8/2r5/8/8/6R1/4K3 b - - 0 4"),
-        Board("4k3/2r5/8/8/8/8/6R1/4K3 w - - 0 5"),
-        Board("4k3/2r5/8/8/6R1/8/8/4K3 b - - 0 5"),
-        Board("4k3/8/8/2r5/6R1/8/8/4K3 w - - 0 6"),
-        Board("4k3/8/8/2r5/8/8/6R1/4K3 b - - 0 6"),
+        Board("4k3/2r5/8/8/6R1/8/8/4K3 b - - 1 1"),
+        Board("4k3/8/8/2r5/6R1/8/8/4K3 w - - 2 2"),
+        Board("4k3/8/8/2r5/8/8/6R1/4K3 b - - 3 2"),
+        Board("4k3/2r5/8/8/8/8/6R1/4K3 w - - 4 3"),
+        Board("4k3/2r5/8/8/6R1/8/8/4K3 b - - 5 3"),
+        Board("4k3/8/8/2r5/6R1/8/8/4K3 w - - 6 4"),
+        Board("4k3/8/8/2r5/8/8/6R1/4K3 b - - 7 4"),
+        Board("4k3/2r5/8/8/8/8/6R1/4K3 w - - 8 5"),
+        Board("4k3/2r5/8/8/6R1/8/8/4K3 b - - 9 5"),
+        Board("4k3/8/8/2r5/6R1/8/8/4K3 w - - 10 6"),
+        Board("4k3/8/8/2r5/8/8/6R1/4K3 b - - 11 6"),
       };
-      Board last_board("4k3/2r5/8/8/8/8/6R1/4K3 w - - 0 7");
+      Board last_board("4k3/2r5/8/8/8/8/6R1/4K3 w - - 12 7");
       Board board("4k3/2r5/8/8/8/8/6R1/4K3 w - - 0 1");
       CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), repetitions(board, boards, &last_board));
     }
 
+    void ChessTests::test_repetitions_function_returns_number_of_repetirions_since_irreversible_move()
+    {
+      vector<Board> boards {
+        Board("4k3/8/1b6/8/8/6B1/8/4K3 w - - 0 1"),
+        Board("4k3/8/1b6/8/8/8/5B2/4K3 b - - 1 1"),
+        Board("4k3/2b5/8/8/8/8/5B2/4K3 w - - 2 2"),
+        Board("4k3/2b5/8/8/8/6B1/8/4K3 b - - 3 2"),
+        Board("4k3/8/1b6/8/8/6B1/8/4K3 w - - 0 3"),
+        Board("4k3/8/1b6/8/8/8/5B2/4K3 b - - 1 3"),
+        Board("4k3/2b5/8/8/8/8/5B2/4K3 w - - 2 4"),
+        Board("4k3/2b5/8/8/8/6B1/8/4K3 b - - 3 4"),
+        Board("4k3/8/1b6/8/8/6B1/8/4K3 w - - 4 5")
+      };
+      Board board("4k3/8/1b6/8/8/6B1/8/4K3 w - - 0 1");
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), repetitions(board, boards));
+      Board last_board("4k3/8/1b6/8/8/6B1/8/4K3 w - - 0 6");
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), repetitions(board, boards, &last_board));
+    }
+
+    void ChessTests::test_hash_key_history_repetitions_method_returns_number_of_repetitions_since_irreversible_move()
+    {
+      Move moves[] = {
+        Move(Piece::PAWN, A2, A3, PromotionPiece::NONE),
+        Move(Piece::BISHOP, B6, C7, PromotionPiece::NONE),
+        Move(Piece::BISHOP, G3, F2, PromotionPiece::NONE),
+        Move(Piece::BISHOP, C7, B6, PromotionPiece::NONE),
+        Move(Piece::BISHOP, F2, G3, PromotionPiece::NONE),
+        Move(Piece::BISHOP, B6, C7, PromotionPiece::NONE),
+        Move(Piece::BISHOP, G3, F2, PromotionPiece::NONE),
+        Move(Piece::BISHOP, C7, B6, PromotionPiece::NONE),
+        Move(Piece::BISHOP, F2, G3, PromotionPiece::NONE)
+      };
+      vector<Board> boards;
+      boards.push_back(Board("4k3/8/1b6/8/8/6B1/P7/4K3 w - - 0 1"));
+      for(Move move : moves) {
+        Board board;
+        CPPUNIT_ASSERT(boards.back().make_move(move, board));
+        boards.push_back(board);
+      }
+      HashKeyHistory history(8);
+      history.set_root(boards, nullptr);
+      CPPUNIT_ASSERT_EQUAL(boards.back().hash_key(), history.hash_key(0));
+      CPPUNIT_ASSERT_EQUAL(8, boards.back().halfmove_clock());
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), history.repetitions(0, boards.back().halfmove_clock()));
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), history.repetitions(0, 4));
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), history.repetitions(0, 3));
+    }
+
+    void ChessTests::test_hash_key_history_has_repetition_method_finds_repetitions_for_search_tree()
+    {
+      Move moves[] = {
+        Move(Piece::KNIGHT, F3, G1, PromotionPiece::NONE),
+        Move(Piece::KNIGHT, C6, B8, PromotionPiece::NONE),
+        Move(Piece::KNIGHT, G1, F3, PromotionPiece::NONE),
+        Move(Piece::KNIGHT, B8, C6, PromotionPiece::NONE)
+      };
+      vector<Board> boards;
+      boards.push_back(Board("r1bqkbnr/pppppppp/2n5/8/8/5N2/PPPPPPPP/RNBQKB1R b KQkq - 2 2"));
+      Board last_board;
+      CPPUNIT_ASSERT(boards.back().make_move(Move(Piece::PAWN, E7, E5, PromotionPiece::NONE), last_board));
+      HashKeyHistory history(8);
+      history.set_root(boards, &last_board);
+      CPPUNIT_ASSERT_EQUAL(last_board.hash_key(), history.hash_key(0));
+      Board board = last_board;
+      UndoRecord undos[4];
+      for(int ply = 1; ply <= 4; ply++) {
+        board.do_move(moves[ply - 1], undos[ply - 1]);
+        history.set_hash_key(ply, board.hash_key());
+        CPPUNIT_ASSERT_EQUAL(ply == 4, history.has_repetition(ply, board.halfmove_clock()));
+      }
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), history.repetitions(4, board.halfmove_clock()));
+      CPPUNIT_ASSERT_EQUAL(false, history.has_repetition(4, 3));
+      history.set_root(boards, nullptr);
+      CPPUNIT_ASSERT_EQUAL(boards.back().hash_key(), history.hash_key(0));
+      CPPUNIT_ASSERT_EQUAL(false, history.has_repetition(0, boards.back().halfmove_clock()));
+    }
+
+    void ChessTests::test_hash_key_history_has_repetition_method_does_not_find_repetitions_before_null_move()
+    {
+      Move moves[] = {
+        Move(Piece::KING, E8, D8, PromotionPiece::NONE),
+        Move(Piece::KING, E1, D1, PromotionPiece::NONE),
+        Move(Piece::KING, D8, D7, PromotionPiece::NONE),
+        Move(Piece::KING, D1, E1, PromotionPiece::NONE),
+        Move(Piece::KING, D7, E8, PromotionPiece::NONE)
+      };
+      vector<Board> boards;
+      boards.push_back(Board("4k3/8/8/8/8/8/8/4K3 w - - 10 40"));
+      HashKeyHistory history(8);
+      history.set_root(boards, nullptr);
+      Board board = boards.back();
+      UndoRecord undos[6];
+      board.do_null_move(undos[0]);
+      history.set_null_move_flag(1, true);
+      history.set_hash_key(1, board.hash_key());
+      for(int ply = 2; ply <= 6; ply++) {
+        board.do_move(moves[ply - 2], undos[ply - 1]);
+        history.set_hash_key(ply, board.hash_key());
+      }
+      CPPUNIT_ASSERT_EQUAL(boards.back().hash_key(), history.hash_key(6));
+      CPPUNIT_ASSERT_EQUAL(false, history.has_repetition(6, board.halfmove_clock()));
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), history.repetitions(6, board.halfmove_clock()));
+      history.set_null_move_flag(1, false);
+      for(int ply = 1; ply <= 6; ply++) {
+        history.set_hash_key(ply, history.hash_key(ply));
+      }
+      CPPUNIT_ASSERT_EQUAL(true, history.has_repetition(6, board.halfmove_clock()));
+    }
+
     void ChessTests::test_fold_squares_function_folds_squares()
     {
       vector<Square> squares;
@@ -32,6 +32,10 @@ namespace peacockspider
       CPPUNIT_TEST(test_repetitions_function_returns_number_of_repetirions);
       CPPUNIT_TEST(test_repetitions_function_with_last_board_returns_number_of_repetirions_without_last_board);
       CPPUNIT_TEST(test_repetitions_function_with_last_board_returns_number_of_repetirions_with_last_board);
+      CPPUNIT_TEST(test_repetitions_function_returns_number_of_repetirions_since_irreversible_move);
+      CPPUNIT_TEST(test_hash_key_history_repetitions_method_returns_number_of_repetitions_since_irreversible_move);
+      CPPUNIT_TEST(test_hash_key_history_has_repetition_method_finds_repetitions_for_search_tree);
+      CPPUNIT_TEST(test_hash_key_history_has_repetition_method_does_not_find_repetitions_before_null_move);
       CPPUNIT_TEST(test_fold_squares_function_folds_squares);
       CPPUNIT_TEST(test_fold_pawn_capture_squares_function_folds_squares_for_white_side);
       CPPUNIT_TEST(test_fold_pawn_capture_squares_function_folds_squares_for_black_side);
@@ -53,6 +57,10 @@ namespace peacockspider
       void test_repetitions_function_returns_number_of_repetirions();
       void test_repetitions_function_with_last_board_returns_number_of_repetirions_without_last_board();
       void test_repetitions_function_with_last_board_returns_number_of_repetirions_with_last_board();
+      void test_repetitions_function_returns_number_of_repetirions_since_irreversible_move();
+      void test_hash_key_history_repetitions_method_returns_number_of_repetitions_since_irreversible_move();
+      void test_hash_key_history_has_repetition_method_finds_repetitions_for_search_tree();
+      void test_hash_key_history_has_repetition_method_does_not_find_repetitions_before_null_move();
       void test_fold_squares_function_folds_squares();
       void test_fold_pawn_capture_squares_function_folds_squares_for_white_side();
       void test_fold_pawn_capture_squares_function_folds_squares_for_black_side();
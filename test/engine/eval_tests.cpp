@@ -15,6 +15,7 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <memory>
 #include <sstream>
 #include "eval_tests.hpp"
 #include "eval.hpp"
@@ -205,5 +206,77 @@ namespace peacockspider\n\
 }\n\
 "), oss.str());
     }
+
+    void EvaluationTests::test_evaluation_function_returns_same_value_for_accumulator()
+    {
+      const char *fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+        "4k3/8/1p1n4/8/8/5N1P/8/4K3 w - - 0 1"
+      };
+      EvaluationFunction eval_fun;
+      for(const char *fen : fens) {
+        Board board(fen);
+        EvaluationAccumulator accumulator;
+        eval_fun.set_accumulator(board, accumulator);
+        CPPUNIT_ASSERT_EQUAL(eval_fun(board), eval_fun(board, accumulator));
+      }
+    }
+
+    void EvaluationTests::test_evaluation_function_update_accumulator_method_updates_accumulator_as_set_accumulator_method()
+    {
+      const char *fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbqkb1r/ppp2ppp/5n2/2Ppp3/4P3/8/PP1P1PPP/RNBQKBNR w KQkq d6 0 4",
+        "4k3/8/8/8/8/8/3q4/4K3 w - - 0 1"
+      };
+      EvaluationFunction eval_fun;
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      for(const char *fen : fens) {
+        Board board(fen);
+        EvaluationAccumulator accumulator;
+        eval_fun.set_accumulator(board, accumulator);
+        board.generate_legal_moves(move_pairs);
+        CPPUNIT_ASSERT(move_pairs.length() > 0);
+        for(size_t i = 0; i < move_pairs.length(); i++) {
+          Move move = move_pairs[i].move;
+          Board new_board;
+          CPPUNIT_ASSERT(board.make_move(move, new_board));
+          EvaluationAccumulator new_accumulator;
+          eval_fun.update_accumulator(board, move, accumulator, new_accumulator);
+          EvaluationAccumulator expected_accumulator;
+          eval_fun.set_accumulator(new_board, expected_accumulator);
+          CPPUNIT_ASSERT_EQUAL(expected_accumulator.material_values[0], new_accumulator.material_values[0]);
+          CPPUNIT_ASSERT_EQUAL(expected_accumulator.material_values[1], new_accumulator.material_values[1]);
+          CPPUNIT_ASSERT_EQUAL(expected_accumulator.piece_square_values[0], new_accumulator.piece_square_values[0]);
+          CPPUNIT_ASSERT_EQUAL(expected_accumulator.piece_square_values[1], new_accumulator.piece_square_values[1]);
+          CPPUNIT_ASSERT_EQUAL(eval_fun(new_board), eval_fun(new_board, new_accumulator));
+        }
+      }
+    }
+
+    void EvaluationTests::test_evaluation_function_returns_same_value_for_pawn_table()
+    {
+      const char *fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+        "4k3/pp1p4/1p1n4/3p4/8/5NPP/6P1/4K3 w - - 0 1",
+        "4k3/8/8/8/8/8/3q4/4K3 w - - 0 1"
+      };
+      EvaluationFunction eval_fun;
+      PawnTable pawn_table(1024);
+      for(const char *fen : fens) {
+        Board board(fen);
+        EvaluationAccumulator accumulator;
+        eval_fun.set_accumulator(board, accumulator);
+        CPPUNIT_ASSERT_EQUAL(eval_fun(board), eval_fun(board, accumulator, pawn_table));
+        CPPUNIT_ASSERT_EQUAL(eval_fun(board), eval_fun(board, accumulator, pawn_table));
+      }
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(8), pawn_table.probe_count());
+      CPPUNIT_ASSERT(pawn_table.hit_count() >= 4);
+    }
   }
 }
@@ -36,6 +36,9 @@ namespace peacockspider
       CPPUNIT_TEST(test_write_evaluation_parameters_function_writes_parent_pair_and_evaluation_parameters);
       CPPUNIT_TEST(test_skip_evaluation_parameters_function_skips_two_evaluation_parameter_sets);
       CPPUNIT_TEST(test_write_default_evaluation_parameters_function_writes_evaluation_parameters);
+      CPPUNIT_TEST(test_evaluation_function_returns_same_value_for_accumulator);
+      CPPUNIT_TEST(test_evaluation_function_update_accumulator_method_updates_accumulator_as_set_accumulator_method);
+      CPPUNIT_TEST(test_evaluation_function_returns_same_value_for_pawn_table);
       CPPUNIT_TEST_SUITE_END();
     public:
       void setUp();
@@ -49,6 +52,9 @@ namespace peacockspider
       void test_write_evaluation_parameters_function_writes_parent_pair_and_evaluation_parameters();
       void test_skip_evaluation_parameters_function_skips_two_evaluation_parameter_sets();
       void test_write_default_evaluation_parameters_function_writes_evaluation_parameters();
+      void test_evaluation_function_returns_same_value_for_accumulator();
+      void test_evaluation_function_update_accumulator_method_updates_accumulator_as_set_accumulator_method();
+      void test_evaluation_function_returns_same_value_for_pawn_table();
     };
   }
 }
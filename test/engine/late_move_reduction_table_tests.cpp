@@ -0,0 +1,59 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "late_move_reduction_table_tests.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  namespace test
+  {
+    CPPUNIT_TEST_SUITE_REGISTRATION(LateMoveReductionTableTests);
+
+    void LateMoveReductionTableTests::test_late_move_reduction_table_does_not_reduce_early_moves_and_small_depths()
+    {
+      LateMoveReductionTable table;
+      for(size_t move_count = 0; move_count < 4; move_count++) {
+        CPPUNIT_ASSERT_EQUAL(0, table.reduction(10, move_count));
+      }
+      for(int depth = 0; depth < 3; depth++) {
+        CPPUNIT_ASSERT_EQUAL(0, table.reduction(depth, 40));
+      }
+    }
+
+    void LateMoveReductionTableTests::test_late_move_reduction_table_reduces_late_moves()
+    {
+      LateMoveReductionTable table;
+      CPPUNIT_ASSERT(table.reduction(3, 40) >= 1);
+      CPPUNIT_ASSERT(table.reduction(3, 40) <= 1);
+      CPPUNIT_ASSERT(table.reduction(10, 40) >= table.reduction(10, 8));
+      CPPUNIT_ASSERT(table.reduction(20, 20) >= table.reduction(6, 20));
+      CPPUNIT_ASSERT(table.reduction(1000, 1000) == table.reduction(MAX_LATE_MOVE_REDUCTION_DEPTH - 1, MAX_LATE_MOVE_REDUCTION_MOVE_COUNT - 1));
+      CPPUNIT_ASSERT(table.reduction(1000, 1000) > 0);
+    }
+
+    void LateMoveReductionTableTests::test_late_move_reduction_table_does_not_reduce_moves_if_it_is_disabled()
+    {
+      LateMoveReductionTable table(false, DEFAULT_LATE_MOVE_REDUCTION_BASE, DEFAULT_LATE_MOVE_REDUCTION_DIVISOR);
+      CPPUNIT_ASSERT_EQUAL(false, table.flag());
+      CPPUNIT_ASSERT_EQUAL(0, table.reduction(3, 40));
+      CPPUNIT_ASSERT_EQUAL(0, table.reduction(20, 20));
+      CPPUNIT_ASSERT_EQUAL(0, table.reduction(1000, 1000));
+    }
+  }
+}
@@ -0,0 +1,45 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _LATE_MOVE_REDUCTION_TABLE_TESTS_HPP
+#define _LATE_MOVE_REDUCTION_TABLE_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include "search.hpp"
+
+namespace peacockspider
+{
+  namespace test
+  {
+    class LateMoveReductionTableTests : public CppUnit::TestFixture
+    {
+      CPPUNIT_TEST_SUITE(LateMoveReductionTableTests);
+      CPPUNIT_TEST(test_late_move_reduction_table_does_not_reduce_early_moves_and_small_depths);
+      CPPUNIT_TEST(test_late_move_reduction_table_reduces_late_moves);
+      CPPUNIT_TEST(test_late_move_reduction_table_does_not_reduce_moves_if_it_is_disabled);
+      CPPUNIT_TEST_SUITE_END();
+    public:
+      void test_late_move_reduction_table_does_not_reduce_early_moves_and_small_depths();
+      void test_late_move_reduction_table_reduces_late_moves();
+      void test_late_move_reduction_table_does_not_reduce_moves_if_it_is_disabled();
+    };
+  }
+}
+
+#endif
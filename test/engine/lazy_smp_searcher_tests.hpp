@@ -27,6 +27,8 @@ namespace peacockspider
     class LazySMPSearcherTests : public SearcherTests
     {
       CPPUNIT_TEST_SUB_SUITE(LazySMPSearcherTests, SearcherTests);
+      CPPUNIT_TEST(test_searcher_changes_thread_count);
+      CPPUNIT_TEST(test_searcher_searches_with_iterative_deepening_in_threads);
       CPPUNIT_TEST_SUITE_END();
     protected:
       TranspositionTable *_M_transposition_table;
@@ -34,6 +36,10 @@ namespace peacockspider
       void setUp();
 
       void tearDown();
+
+      void test_searcher_changes_thread_count();
+
+      void test_searcher_searches_with_iterative_deepening_in_threads();
     };
   }
 }
@@ -0,0 +1,161 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <vector>
+#include "move_picker_tests.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  namespace test
+  {
+    CPPUNIT_TEST_SUITE_REGISTRATION(MovePickerTests);
+
+    void MovePickerTests::setUp()
+    {
+      _M_evaluation_function = new EvaluationFunction(start_evaluation_parameters);
+      _M_move_order = new MoveOrder(MAX_DEPTH);
+      _M_move_order->clear();
+      _M_move_pairs = new MovePair[MAX_MOVE_COUNT * 2];
+    }
+
+    void MovePickerTests::tearDown()
+    {
+      delete [] _M_move_pairs;
+      delete _M_move_order;
+      delete _M_evaluation_function;
+    }
+
+    void MovePickerTests::test_move_picker_next_method_picks_all_moves()
+    {
+      Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      MovePairList move_pairs(_M_move_pairs, 0);
+      MovePairList expected_move_pairs(_M_move_pairs + MAX_MOVE_COUNT, 0);
+      board.generate_pseudolegal_moves(expected_move_pairs);
+      Move best_move(Piece::KNIGHT, E5, G6, PromotionPiece::NONE);
+      MovePicker move_picker(move_pairs, 1, board, *_M_move_order, _M_evaluation_function, &best_move);
+      vector<Move> moves;
+      Move move;
+      while(move_picker.next(move)) moves.push_back(move);
+      CPPUNIT_ASSERT_EQUAL(expected_move_pairs.length(), moves.size());
+      for(size_t i = 0; i < expected_move_pairs.length(); i++) {
+        CPPUNIT_ASSERT(moves.end() != find(moves.begin(), moves.end(), expected_move_pairs[i].move));
+      }
+      CPPUNIT_ASSERT(best_move == moves[0]);
+    }
+
+    void MovePickerTests::test_move_picker_next_method_picks_best_move_without_move_generation()
+    {
+      Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      MovePairList move_pairs(_M_move_pairs, 0);
+      Move best_move(Piece::KING, E1, G1, PromotionPiece::NONE);
+      MovePicker move_picker(move_pairs, 1, board, *_M_move_order, _M_evaluation_function, &best_move);
+      Move move;
+      CPPUNIT_ASSERT(move_picker.next(move));
+      CPPUNIT_ASSERT(best_move == move);
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), move_pairs.length());
+    }
+
+    void MovePickerTests::test_move_picker_next_method_picks_good_moves_before_quiet_moves()
+    {
+      Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      MovePairList move_pairs(_M_move_pairs, 0);
+      Move best_move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+      MovePicker move_picker(move_pairs, 1, board, *_M_move_order, _M_evaluation_function, &best_move);
+      vector<Move> moves;
+      Move move;
+      while(move_picker.next(move)) moves.push_back(move);
+      size_t good_move_count = 0;
+      while(good_move_count < moves.size() && moves[good_move_count].is_capture(board)) good_move_count++;
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), good_move_count);
+      size_t bad_move_count = 0;
+      while(bad_move_count < moves.size() && moves[moves.size() - bad_move_count - 1].is_capture(board)) bad_move_count++;
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), bad_move_count);
+      for(size_t i = good_move_count; i < moves.size() - bad_move_count; i++) {
+        CPPUNIT_ASSERT(!moves[i].is_capture(board));
+      }
+    }
+
+    void MovePickerTests::test_move_picker_next_method_picks_only_good_moves_for_quiescence_search()
+    {
+      Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      MovePairList move_pairs(_M_move_pairs, 0);
+      MovePicker move_picker(move_pairs, 1, board, *_M_move_order, _M_evaluation_function);
+      vector<Move> moves;
+      Move move;
+      while(move_picker.next(move)) moves.push_back(move);
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(8), moves.size());
+      for(size_t i = 0; i < moves.size(); i++) {
+        CPPUNIT_ASSERT(moves[i].is_capture(board));
+      }
+    }
+
+    void MovePickerTests::test_move_picker_rewind_method_rewinds_moves()
+    {
+      Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      MovePairList move_pairs(_M_move_pairs, 0);
+      Move best_move(Piece::QUEEN, F3, F6, PromotionPiece::NONE);
+      MovePicker move_picker(move_pairs, 1, board, *_M_move_order, _M_evaluation_function, &best_move);
+      vector<Move> moves;
+      Move move;
+      while(move_picker.next(move)) moves.push_back(move);
+      move_picker.rewind();
+      vector<Move> rewound_moves;
+      while(move_picker.next(move)) rewound_moves.push_back(move);
+      CPPUNIT_ASSERT(moves == rewound_moves);
+    }
+
+    void MovePickerTests::test_move_picker_next_method_picks_killer_moves_before_other_quiet_moves()
+    {
+      Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      MovePairList move_pairs(_M_move_pairs, 0);
+      Move no_move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+      _M_move_order->add_cutoff_move(Move(Piece::PAWN, A2, A3, PromotionPiece::NONE), 1, board, no_move);
+      _M_move_order->add_cutoff_move(Move(Piece::KING, E1, D1, PromotionPiece::NONE), 1, board, no_move);
+      _M_move_order->add_cutoff_move(Move(Piece::QUEEN, F3, F6, PromotionPiece::NONE), 1, board, no_move);
+      Move best_move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+      MovePicker move_picker(move_pairs, 1, board, *_M_move_order, _M_evaluation_function, &best_move);
+      vector<Move> moves;
+      Move move;
+      while(move_picker.next(move)) moves.push_back(move);
+      size_t good_move_count = 0;
+      while(good_move_count < moves.size() && moves[good_move_count].is_capture(board)) good_move_count++;
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), good_move_count);
+      CPPUNIT_ASSERT(Move(Piece::KING, E1, D1, PromotionPiece::NONE) == moves[good_move_count]);
+      CPPUNIT_ASSERT(Move(Piece::PAWN, A2, A3, PromotionPiece::NONE) == moves[good_move_count + 1]);
+    }
+
+    void MovePickerTests::test_move_picker_next_method_picks_countermove_before_other_quiet_moves()
+    {
+      Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      MovePairList move_pairs(_M_move_pairs, 0);
+      Move previous_move(Piece::KNIGHT, F6, G8, PromotionPiece::NONE);
+      _M_move_order->add_cutoff_move(Move(Piece::PAWN, G2, G3, PromotionPiece::NONE), 2, board, previous_move);
+      Move best_move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+      MovePicker move_picker(move_pairs, 1, board, *_M_move_order, _M_evaluation_function, &best_move, previous_move);
+      vector<Move> moves;
+      Move move;
+      while(move_picker.next(move)) moves.push_back(move);
+      size_t good_move_count = 0;
+      while(good_move_count < moves.size() && moves[good_move_count].is_capture(board)) good_move_count++;
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), good_move_count);
+      CPPUNIT_ASSERT(Move(Piece::PAWN, G2, G3, PromotionPiece::NONE) == moves[good_move_count]);
+    }
+  }
+}
@@ -0,0 +1,60 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _MOVE_PICKER_TESTS_HPP
+#define _MOVE_PICKER_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include "search.hpp"
+
+namespace peacockspider
+{
+  namespace test
+  {
+    class MovePickerTests : public CppUnit::TestFixture
+    {
+      CPPUNIT_TEST_SUITE(MovePickerTests);
+      CPPUNIT_TEST(test_move_picker_next_method_picks_all_moves);
+      CPPUNIT_TEST(test_move_picker_next_method_picks_best_move_without_move_generation);
+      CPPUNIT_TEST(test_move_picker_next_method_picks_good_moves_before_quiet_moves);
+      CPPUNIT_TEST(test_move_picker_next_method_picks_only_good_moves_for_quiescence_search);
+      CPPUNIT_TEST(test_move_picker_rewind_method_rewinds_moves);
+      CPPUNIT_TEST(test_move_picker_next_method_picks_killer_moves_before_other_quiet_moves);
+      CPPUNIT_TEST(test_move_picker_next_method_picks_countermove_before_other_quiet_moves);
+      CPPUNIT_TEST_SUITE_END();
+      EvaluationFunction *_M_evaluation_function;
+      MoveOrder *_M_move_order;
+      MovePair *_M_move_pairs;
+    public:
+      void setUp();
+
+      void tearDown();
+
+      void test_move_picker_next_method_picks_all_moves();
+      void test_move_picker_next_method_picks_best_move_without_move_generation();
+      void test_move_picker_next_method_picks_good_moves_before_quiet_moves();
+      void test_move_picker_next_method_picks_only_good_moves_for_quiescence_search();
+      void test_move_picker_rewind_method_rewinds_moves();
+      void test_move_picker_next_method_picks_killer_moves_before_other_quiet_moves();
+      void test_move_picker_next_method_picks_countermove_before_other_quiet_moves();
+    };
+  }
+}
+
+#endif
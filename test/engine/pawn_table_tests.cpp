@@ -0,0 +1,99 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "pawn_table_tests.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  namespace test
+  {
+    CPPUNIT_TEST_SUITE_REGISTRATION(PawnTableTests);
+
+    void PawnTableTests::setUp()
+    { _M_pawn_table = new PawnTable(1024); }
+
+    void PawnTableTests::tearDown()
+    { delete _M_pawn_table; }
+
+    void PawnTableTests::test_pawn_table_stores_entry()
+    {
+      _M_pawn_table->store(static_cast<HashKey>(0x123456), 25);
+      int value = 0;
+      CPPUNIT_ASSERT_EQUAL(true, _M_pawn_table->retrieve(static_cast<HashKey>(0x123456), value));
+      CPPUNIT_ASSERT_EQUAL(25, value);
+    }
+
+    void PawnTableTests::test_pawn_table_replaces_entry()
+    {
+      _M_pawn_table->store(static_cast<HashKey>(0x1234), 10);
+      _M_pawn_table->store(static_cast<HashKey>(0x1234 + 1024), -15);
+      int value = 0;
+      CPPUNIT_ASSERT_EQUAL(false, _M_pawn_table->retrieve(static_cast<HashKey>(0x1234), value));
+      CPPUNIT_ASSERT_EQUAL(true, _M_pawn_table->retrieve(static_cast<HashKey>(0x1234 + 1024), value));
+      CPPUNIT_ASSERT_EQUAL(-15, value);
+    }
+
+    void PawnTableTests::test_pawn_table_does_not_retrieve_entry_for_unequal_pawn_hash_key()
+    {
+      _M_pawn_table->store(static_cast<HashKey>(0x123456), 25);
+      int value = 0;
+      CPPUNIT_ASSERT_EQUAL(false, _M_pawn_table->retrieve(static_cast<HashKey>(0x123457), value));
+      CPPUNIT_ASSERT_EQUAL(false, _M_pawn_table->retrieve(static_cast<HashKey>(0x123456 + 1024), value));
+    }
+
+    void PawnTableTests::test_pawn_table_clears_entries()
+    {
+      _M_pawn_table->store(static_cast<HashKey>(0x123456), 25);
+      _M_pawn_table->clear();
+      int value = 0;
+      CPPUNIT_ASSERT_EQUAL(false, _M_pawn_table->retrieve(static_cast<HashKey>(0x123456), value));
+      CPPUNIT_ASSERT_EQUAL(true, _M_pawn_table->retrieve(static_cast<HashKey>(0), value));
+      CPPUNIT_ASSERT_EQUAL(0, value);
+    }
+
+    void PawnTableTests::test_pawn_table_counts_probes_and_hits()
+    {
+      _M_pawn_table->store(static_cast<HashKey>(0x123456), 25);
+      int value = 0;
+      _M_pawn_table->retrieve(static_cast<HashKey>(0x123456), value);
+      _M_pawn_table->retrieve(static_cast<HashKey>(0x123457), value);
+      _M_pawn_table->retrieve(static_cast<HashKey>(0x123456), value);
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(3), _M_pawn_table->probe_count());
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(2), _M_pawn_table->hit_count());
+      _M_pawn_table->clear_counts();
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), _M_pawn_table->probe_count());
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), _M_pawn_table->hit_count());
+      CPPUNIT_ASSERT_EQUAL(true, _M_pawn_table->retrieve(static_cast<HashKey>(0x123456), value));
+    }
+
+    void PawnTableTests::test_pawn_table_resizes_to_power_of_two()
+    {
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1024), _M_pawn_table->entry_count());
+      _M_pawn_table->store(static_cast<HashKey>(0x123456), 25);
+      _M_pawn_table->resize(3000);
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2048), _M_pawn_table->entry_count());
+      int value = 0;
+      CPPUNIT_ASSERT_EQUAL(false, _M_pawn_table->retrieve(static_cast<HashKey>(0x123456), value));
+      _M_pawn_table->store(static_cast<HashKey>(0x123456 + 1024), -5);
+      CPPUNIT_ASSERT_EQUAL(false, _M_pawn_table->retrieve(static_cast<HashKey>(0x123456), value));
+      CPPUNIT_ASSERT_EQUAL(true, _M_pawn_table->retrieve(static_cast<HashKey>(0x123456 + 1024), value));
+      CPPUNIT_ASSERT_EQUAL(-5, value);
+    }
+  }
+}
@@ -0,0 +1,57 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _PAWN_TABLE_TESTS_HPP
+#define _PAWN_TABLE_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include "pawn_table.hpp"
+
+namespace peacockspider
+{
+  namespace test
+  {
+    class PawnTableTests : public CppUnit::TestFixture
+    {
+      CPPUNIT_TEST_SUITE(PawnTableTests);
+      CPPUNIT_TEST(test_pawn_table_stores_entry);
+      CPPUNIT_TEST(test_pawn_table_replaces_entry);
+      CPPUNIT_TEST(test_pawn_table_does_not_retrieve_entry_for_unequal_pawn_hash_key);
+      CPPUNIT_TEST(test_pawn_table_clears_entries);
+      CPPUNIT_TEST(test_pawn_table_counts_probes_and_hits);
+      CPPUNIT_TEST(test_pawn_table_resizes_to_power_of_two);
+      CPPUNIT_TEST_SUITE_END();
+
+      PawnTable *_M_pawn_table;
+    public:
+      void setUp();
+
+      void tearDown();
+
+      void test_pawn_table_stores_entry();
+      void test_pawn_table_replaces_entry();
+      void test_pawn_table_does_not_retrieve_entry_for_unequal_pawn_hash_key();
+      void test_pawn_table_clears_entries();
+      void test_pawn_table_counts_probes_and_hits();
+      void test_pawn_table_resizes_to_power_of_two();
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include "consts.hpp"
+#include "perft.hpp"
+#include "perft_tests.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  namespace test
+  {
+    CPPUNIT_TEST_SUITE_REGISTRATION(PerftTests);
+
+    void PerftTests::setUp()
+    { _M_move_pairs = unique_ptr<MovePair []>(new MovePair[MAX_MOVE_COUNT * 4]); }
+
+    void PerftTests::tearDown()
+    { _M_move_pairs.reset(); }
+
+    void PerftTests::test_perft_function_counts_nodes_for_initial_board()
+    {
+      Board board;
+      MovePairList move_pairs(_M_move_pairs.get(), 0);
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(20), perft(board, 1, move_pairs));
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(400), perft(board, 2, move_pairs));
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(8902), perft(board, 3, move_pairs));
+    }
+
+    void PerftTests::test_perft_function_counts_nodes_for_castlings_and_en_passant()
+    {
+      Board board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      MovePairList move_pairs(_M_move_pairs.get(), 0);
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(48), perft(board, 1, move_pairs));
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(2039), perft(board, 2, move_pairs));
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(97862), perft(board, 3, move_pairs));
+    }
+
+    void PerftTests::test_perft_function_counts_nodes_for_promotions()
+    {
+      Board board("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+      MovePairList move_pairs(_M_move_pairs.get(), 0);
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(6), perft(board, 1, move_pairs));
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(240), perft(board, 2, move_pairs));
+    }
+
+    void PerftTests::test_perft_with_undo_function_counts_same_nodes_as_perft_function()
+    {
+      MovePairList move_pairs(_M_move_pairs.get(), 0);
+      for(size_t i = 0; i < perft_position_count; i++) {
+        Board board(perft_positions[i].fen);
+        Board board2 = board;
+        uint64_t nodes = perft(board, 3, move_pairs);
+        CPPUNIT_ASSERT_EQUAL(nodes, perft_with_undo(board2, 3, move_pairs));
+        CPPUNIT_ASSERT(board == board2);
+      }
+    }
+
+    void PerftTests::test_divide_function_counts_nodes_for_moves()
+    {
+      Board board;
+      MovePairList move_pairs(_M_move_pairs.get(), 0);
+      vector<Move> moves;
+      uint64_t sum = 0;
+      uint64_t nodes = divide(board, 3, move_pairs, [&](Move move, uint64_t move_nodes) {
+        moves.push_back(move);
+        sum += move_nodes;
+        if(move == Move(Piece::PAWN, E2, E4, PromotionPiece::NONE)) CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(600), move_nodes);
+        if(move == Move(Piece::KNIGHT, G1, F3, PromotionPiece::NONE)) CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(440), move_nodes);
+      });
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(20), moves.size());
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(8902), nodes);
+      CPPUNIT_ASSERT_EQUAL(nodes, sum);
+    }
+  }
+}
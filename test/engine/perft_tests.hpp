@@ -0,0 +1,55 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _PERFT_TESTS_HPP
+#define _PERFT_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include <memory>
+#include "chess.hpp"
+
+namespace peacockspider
+{
+  namespace test
+  {
+    class PerftTests : public CppUnit::TestFixture
+    {
+      CPPUNIT_TEST_SUITE(PerftTests);
+      CPPUNIT_TEST(test_perft_function_counts_nodes_for_initial_board);
+      CPPUNIT_TEST(test_perft_function_counts_nodes_for_castlings_and_en_passant);
+      CPPUNIT_TEST(test_perft_function_counts_nodes_for_promotions);
+      CPPUNIT_TEST(test_perft_with_undo_function_counts_same_nodes_as_perft_function);
+      CPPUNIT_TEST(test_divide_function_counts_nodes_for_moves);
+      CPPUNIT_TEST_SUITE_END();
+      std::unique_ptr<MovePair []> _M_move_pairs;
+    public:
+      void setUp();
+
+      void tearDown();
+
+      void test_perft_function_counts_nodes_for_initial_board();
+      void test_perft_function_counts_nodes_for_castlings_and_en_passant();
+      void test_perft_function_counts_nodes_for_promotions();
+      void test_perft_with_undo_function_counts_same_nodes_as_perft_function();
+      void test_divide_function_counts_nodes_for_moves();
+    };
+  }
+}
+
+#endif
@@ -202,5 +202,33 @@ namespace peacockspider
       }
       CPPUNIT_ASSERT(are_pv_line_legal_moves);
     }
+
+    void SearcherTests::test_searcher_finds_draw_by_repetition_for_perpetual_check()
+    {
+      Board board("q4r1k/5p1p/8/8/5Q2/8/6PP/7K w - - 0 1");
+      vector<Board> boards;
+      Move best_move;
+      _M_searcher->clear_for_new_game();
+      _M_searcher->set_board(board);
+      boards.push_back(board);
+      int value = _M_searcher->search_from_root(MIN_VALUE, MAX_VALUE, 6, nullptr, best_move, boards, nullptr);
+      CPPUNIT_ASSERT_EQUAL(0, value);
+      CPPUNIT_ASSERT(Move(Piece::QUEEN, F4, F6, PromotionPiece::NONE) == best_move);
+    }
+
+    void SearcherTests::test_searcher_cuts_off_mostly_on_first_move()
+    {
+      Board board("r1bqkb1r/pppp1ppp/2n2n2/4p3/4P3/2N2N2/PPPP1PPP/R1BQKB1R w KQkq - 0 4");
+      vector<Board> boards;
+      Move best_move;
+      _M_searcher->clear_for_new_game();
+      _M_searcher->clear();
+      _M_searcher->set_board(board);
+      boards.push_back(board);
+      _M_searcher->search_from_root(MIN_VALUE, MAX_VALUE, 4, nullptr, best_move, boards, nullptr);
+      CPPUNIT_ASSERT(0 < _M_searcher->cutoff_count());
+      CPPUNIT_ASSERT(_M_searcher->first_move_cutoff_count() <= _M_searcher->cutoff_count());
+      CPPUNIT_ASSERT(_M_searcher->first_move_cutoff_count() * 2 >= _M_searcher->cutoff_count());
+    }
   }
 }
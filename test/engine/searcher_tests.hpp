@@ -35,6 +35,8 @@ namespace peacockspider
       CPPUNIT_TEST(test_searcher_finds_best_move_for_black_side_and_pieces);
       CPPUNIT_TEST(test_searcher_finds_best_move_for_white_side_and_endgame);
       CPPUNIT_TEST(test_searcher_finds_best_move_for_black_side_and_endgame);
+      CPPUNIT_TEST(test_searcher_finds_draw_by_repetition_for_perpetual_check);
+      CPPUNIT_TEST(test_searcher_cuts_off_mostly_on_first_move);
       CPPUNIT_TEST_SUITE_END();
     protected:
       EvaluationFunction *_M_evaluation_function;
@@ -45,6 +47,8 @@ namespace peacockspider
       void test_searcher_finds_best_move_for_black_side_and_pieces();
       void test_searcher_finds_best_move_for_white_side_and_endgame();
       void test_searcher_finds_best_move_for_black_side_and_endgame();
+      void test_searcher_finds_draw_by_repetition_for_perpetual_check();
+      void test_searcher_cuts_off_mostly_on_first_move();
     };
   }
 }
@@ -0,0 +1,113 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <random>
+#include "tables_tests.hpp"
+#include "chess.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  namespace test
+  {
+    CPPUNIT_TEST_SUITE_REGISTRATION(TablesTests);
+
+    namespace
+    {
+      Bitboard bishop_slide_bitboard(Square squ, Bitboard occupied)
+      {
+        return fold_bishop_slides(squ, static_cast<Bitboard>(0), [](Bitboard bbd) {
+          return bbd;
+        }, [occupied](Bitboard bbd, Square to) {
+          return make_pair(bbd | (static_cast<Bitboard>(1) << to), (occupied & (static_cast<Bitboard>(1) << to)) == 0);
+        });
+      }
+
+      Bitboard rook_slide_bitboard(Square squ, Bitboard occupied)
+      {
+        return fold_rook_slides(squ, static_cast<Bitboard>(0), [](Bitboard bbd) {
+          return bbd;
+        }, [occupied](Bitboard bbd, Square to) {
+          return make_pair(bbd | (static_cast<Bitboard>(1) << to), (occupied & (static_cast<Bitboard>(1) << to)) == 0);
+        });
+      }
+
+      bool check_slide_attack_bitboards()
+      {
+        mt19937_64 generator(1234);
+        for(Square squ = 0; squ < 64; squ++) {
+          for(int i = 0; i < 256; i++) {
+            Bitboard occupied = generator() & generator();
+            if(bishop_attack_bitboard(squ, occupied) != bishop_slide_bitboard(squ, occupied)) return false;
+            if(rook_attack_bitboard(squ, occupied) != rook_slide_bitboard(squ, occupied)) return false;
+          }
+        }
+        return true;
+      }
+    }
+
+    void TablesTests::setUp() {}
+
+    void TablesTests::tearDown() {}
+
+    void TablesTests::test_bishop_attack_bitboard_function_returns_attacks()
+    {
+      Bitboard occupied = (static_cast<Bitboard>(1) << E4) | (static_cast<Bitboard>(1) << A6) | (static_cast<Bitboard>(1) << G2);
+      Bitboard expected_bbd = 0;
+      expected_bbd |= static_cast<Bitboard>(1) << A8;
+      expected_bbd |= static_cast<Bitboard>(1) << C8;
+      expected_bbd |= static_cast<Bitboard>(1) << A6;
+      expected_bbd |= static_cast<Bitboard>(1) << C6;
+      expected_bbd |= static_cast<Bitboard>(1) << D5;
+      expected_bbd |= static_cast<Bitboard>(1) << E4;
+      CPPUNIT_ASSERT_EQUAL(expected_bbd, bishop_attack_bitboard(B7, occupied));
+    }
+
+    void TablesTests::test_rook_attack_bitboard_function_returns_attacks()
+    {
+      Bitboard occupied = (static_cast<Bitboard>(1) << F6) | (static_cast<Bitboard>(1) << B3) | (static_cast<Bitboard>(1) << H6);
+      Bitboard expected_bbd = 0;
+      expected_bbd |= static_cast<Bitboard>(1) << B7;
+      expected_bbd |= static_cast<Bitboard>(1) << B8;
+      expected_bbd |= static_cast<Bitboard>(1) << A6;
+      expected_bbd |= static_cast<Bitboard>(1) << C6;
+      expected_bbd |= static_cast<Bitboard>(1) << D6;
+      expected_bbd |= static_cast<Bitboard>(1) << E6;
+      expected_bbd |= static_cast<Bitboard>(1) << F6;
+      expected_bbd |= static_cast<Bitboard>(1) << B5;
+      expected_bbd |= static_cast<Bitboard>(1) << B4;
+      expected_bbd |= static_cast<Bitboard>(1) << B3;
+      CPPUNIT_ASSERT_EQUAL(expected_bbd, rook_attack_bitboard(B6, occupied));
+    }
+
+    void TablesTests::test_queen_attack_bitboard_function_returns_attacks()
+    {
+      Bitboard occupied = (static_cast<Bitboard>(1) << D6) | (static_cast<Bitboard>(1) << G6) | (static_cast<Bitboard>(1) << C3);
+      CPPUNIT_ASSERT_EQUAL(bishop_slide_bitboard(G3, occupied) | rook_slide_bitboard(G3, occupied), queen_attack_bitboard(G3, occupied));
+    }
+
+    void TablesTests::test_slide_attack_bitboard_functions_return_attacks_for_magics()
+    {
+      CPPUNIT_ASSERT(check_slide_attack_bitboards());
+      initialize_tables(false);
+      bool is_correct = check_slide_attack_bitboards();
+      initialize_tables();
+      CPPUNIT_ASSERT(is_correct);
+    }
+  }
+}
@@ -0,0 +1,50 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _TABLES_TESTS_HPP
+#define _TABLES_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+
+namespace peacockspider
+{
+  namespace test
+  {
+    class TablesTests : public CppUnit::TestFixture
+    {
+      CPPUNIT_TEST_SUITE(TablesTests);
+      CPPUNIT_TEST(test_bishop_attack_bitboard_function_returns_attacks);
+      CPPUNIT_TEST(test_rook_attack_bitboard_function_returns_attacks);
+      CPPUNIT_TEST(test_queen_attack_bitboard_function_returns_attacks);
+      CPPUNIT_TEST(test_slide_attack_bitboard_functions_return_attacks_for_magics);
+      CPPUNIT_TEST_SUITE_END();
+    public:
+      void setUp();
+
+      void tearDown();
+
+      void test_bishop_attack_bitboard_function_returns_attacks();
+      void test_rook_attack_bitboard_function_returns_attacks();
+      void test_queen_attack_bitboard_function_returns_attacks();
+      void test_slide_attack_bitboard_functions_return_attacks_for_magics();
+    };
+  }
+}
+
+#endif
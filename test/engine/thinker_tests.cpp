@@ -15,7 +15,11 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
+#include <cstdio>
 #include <limits>
+#include <memory>
+#include "engine.hpp"
 #include "thinker_tests.hpp"
 
 using namespace std;
@@ -55,7 +59,7 @@ namespace peacockspider
       _M_thinker->unset_hint_move();
       _M_thinker->unset_next_hint_move();
       is_ok = true;
-      bool result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, unsigned ms, const Searcher *searcher) {
+      bool result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
         if(old_depth == 0) first_depth = depth;
         is_ok &= (old_depth <= depth);
         is_ok &= (0 < searcher->nodes());
@@ -100,7 +104,7 @@ namespace peacockspider
       _M_thinker->unset_hint_move();
       _M_thinker->unset_next_hint_move();
       is_ok = true;
-      bool result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, unsigned ms, const Searcher *searcher) {
+      bool result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
         if(old_depth == 0) first_depth = depth;
         is_ok &= (old_depth <= depth);
         is_ok &= (0 < searcher->nodes());
@@ -134,7 +138,7 @@ namespace peacockspider
       _M_thinker->set_pondering_move();
       CPPUNIT_ASSERT_EQUAL(_M_thinker->has_hint_move(), _M_thinker->has_pondering_move());
       CPPUNIT_ASSERT(_M_thinker->hint_move() == _M_thinker->pondering_move());
-      result = _M_thinker->ponder(4, nullptr, numeric_limits<uint64_t>::max(), 0, boards, [&](int depth, int value, unsigned ms, const Searcher *searcher) {
+      result = _M_thinker->ponder(4, nullptr, numeric_limits<uint64_t>::max(), 0, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
         if(old_depth == 0) first_depth = depth;
         is_ok &= (old_depth <= depth);
         is_ok &= (0 < searcher->nodes());
@@ -172,7 +176,7 @@ namespace peacockspider
       _M_thinker->unset_hint_move();
       _M_thinker->unset_next_hint_move();
       is_ok = true;
-      bool result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, unsigned ms, const Searcher *searcher) {
+      bool result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
         if(old_depth == 0) first_depth = depth;
         is_ok &= (old_depth <= depth);
         is_ok &= (0 < searcher->nodes());
@@ -206,7 +210,7 @@ namespace peacockspider
       _M_thinker->set_pondering_move();
       CPPUNIT_ASSERT_EQUAL(_M_thinker->has_hint_move(), _M_thinker->has_pondering_move());
       CPPUNIT_ASSERT(_M_thinker->hint_move() == _M_thinker->pondering_move());
-      result = _M_thinker->ponder(2, nullptr, numeric_limits<uint64_t>::max(), 0, boards, [&](int depth, int value, unsigned ms, const Searcher *searcher) {
+      result = _M_thinker->ponder(2, nullptr, numeric_limits<uint64_t>::max(), 0, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
         if(old_depth == 0) first_depth = depth;
         is_ok &= (old_depth <= depth);
         is_ok &= (0 < searcher->nodes());
@@ -231,7 +235,7 @@ namespace peacockspider
       boards.push_back(new_board);
       is_ok = true;
       old_depth = 0;
-      result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, unsigned ms, const Searcher *searcher) {
+      result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
         if(old_depth == 0) first_depth = depth;
         is_ok &= (old_depth <= depth);
         is_ok &= (0 < searcher->nodes());
@@ -276,7 +280,7 @@ namespace peacockspider
       _M_thinker->unset_hint_move();
       _M_thinker->unset_next_hint_move();
       is_ok = true;
-      bool result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, unsigned ms, const Searcher *searcher) {
+      bool result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
         if(old_depth == 0) first_depth = depth;
         is_ok &= (old_depth <= depth);
         is_ok &= (0 < searcher->nodes());
@@ -310,7 +314,7 @@ namespace peacockspider
       _M_thinker->set_pondering_move();
       CPPUNIT_ASSERT_EQUAL(_M_thinker->has_hint_move(), _M_thinker->has_pondering_move());
       CPPUNIT_ASSERT(_M_thinker->hint_move() == _M_thinker->pondering_move());
-      result = _M_thinker->ponder(2, nullptr, numeric_limits<uint64_t>::max(), 0, boards, [&](int depth, int value, unsigned ms, const Searcher *searcher) {
+      result = _M_thinker->ponder(2, nullptr, numeric_limits<uint64_t>::max(), 0, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
         if(old_depth == 0) first_depth = depth;
         is_ok &= (old_depth <= depth);
         is_ok &= (0 < searcher->nodes());
@@ -346,7 +350,7 @@ namespace peacockspider
       _M_thinker->discard_hint_move();
       is_ok = true;
       old_depth = 0;
-      result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, unsigned ms, const Searcher *searcher) {
+      result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
         if(old_depth == 0) first_depth = depth;
         is_ok &= (old_depth <= depth);
         is_ok &= (0 < searcher->nodes());
@@ -393,7 +397,7 @@ namespace peacockspider
       _M_thinker->unset_hint_move();
       _M_thinker->unset_next_hint_move();
       is_ok = true;
-      bool result = _M_thinker->ponder(4, nullptr, numeric_limits<uint64_t>::max(), 0, boards, [&](int depth, int value, unsigned ms, const Searcher *searcher) {
+      bool result = _M_thinker->ponder(4, nullptr, numeric_limits<uint64_t>::max(), 0, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
         if(old_depth == 0) first_depth = depth;
         is_ok &= (old_depth <= depth);
         is_ok &= (0 < searcher->nodes());
@@ -415,5 +419,167 @@ namespace peacockspider
       CPPUNIT_ASSERT_EQUAL(true, result);
       CPPUNIT_ASSERT_EQUAL(true, is_ok);
     }
+
+    void ThinkerTests::test_thinker_widens_aspiration_window_after_fail_high()
+    {
+      vector<Board> boards;
+      Move best_move;
+      vector<int> depths;
+      vector<int> values;
+      vector<ValueType> value_types;
+      boards.push_back(Board("k7/8/2K5/8/8/8/8/7R w - - 0 1"));
+      _M_thinker->clear();
+      _M_thinker->unset_hint_move();
+      _M_thinker->unset_next_hint_move();
+      bool result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
+        depths.push_back(depth);
+        values.push_back(value);
+        value_types.push_back(value_type);
+      });
+      CPPUNIT_ASSERT_EQUAL(true, result);
+      CPPUNIT_ASSERT(find(value_types.begin(), value_types.end(), ValueType::LOWER_BOUND) != value_types.end());
+      for(size_t i = 0; i < depths.size(); i++) {
+        if(i + 1 == depths.size() || depths[i + 1] != depths[i])
+          CPPUNIT_ASSERT(ValueType::EXACT == value_types[i]);
+        else
+          CPPUNIT_ASSERT(ValueType::EXACT != value_types[i]);
+      }
+      CPPUNIT_ASSERT_EQUAL(4, depths.back());
+      CPPUNIT_ASSERT(values.back() >= MAX_VALUE - MAX_DEPTH);
+    }
+
+    void ThinkerTests::test_thinker_stops_thinking_at_deadline()
+    {
+      vector<Board> boards;
+      Move best_move;
+      int last_depth = 0;
+      boards.push_back(Board());
+      _M_thinker->clear();
+      _M_thinker->unset_hint_move();
+      _M_thinker->unset_next_hint_move();
+      bool result = _M_thinker->think(MAX_DEPTH, 20, nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
+        last_depth = depth;
+      });
+      CPPUNIT_ASSERT_EQUAL(true, result);
+      CPPUNIT_ASSERT(best_move.to() != -1);
+      CPPUNIT_ASSERT(last_depth < MAX_DEPTH);
+      CPPUNIT_ASSERT_EQUAL(true, _M_thinker->has_stop_latency());
+      CPPUNIT_ASSERT(_M_thinker->stop_latency() < 20000U);
+      last_depth = 0;
+      result = _M_thinker->think(3, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
+        last_depth = depth;
+      });
+      CPPUNIT_ASSERT_EQUAL(true, result);
+      CPPUNIT_ASSERT_EQUAL(3, last_depth);
+      CPPUNIT_ASSERT_EQUAL(false, _M_thinker->has_stop_latency());
+    }
+
+    void ThinkerTests::test_thinker_stops_thinking_at_deadline_for_many_threads()
+    {
+      TranspositionTable transposition_table(65536);
+      unique_ptr<Searcher> searchers[3] = {
+        unique_ptr<Searcher>(new LazySMPSearcher(_M_evaluation_function, &transposition_table, 4)),
+        unique_ptr<Searcher>(new ABDADASearcher(_M_evaluation_function, &transposition_table, 4)),
+        unique_ptr<Searcher>(new YBWCSearcher(_M_evaluation_function, &transposition_table, 4))
+      };
+      for(unique_ptr<Searcher> &tmp_searcher : searchers) {
+        Thinker thinker(tmp_searcher.get());
+        vector<Board> boards;
+        Move best_move;
+        int last_depth = 0;
+        boards.push_back(Board());
+        transposition_table.clear();
+        thinker.clear();
+        thinker.unset_hint_move();
+        thinker.unset_next_hint_move();
+        bool result = thinker.think(MAX_DEPTH, 20, nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
+          last_depth = depth;
+        });
+        CPPUNIT_ASSERT_EQUAL(true, result);
+        CPPUNIT_ASSERT(best_move.to() != -1);
+        CPPUNIT_ASSERT(last_depth < MAX_DEPTH);
+        CPPUNIT_ASSERT_EQUAL(true, thinker.has_stop_latency());
+        CPPUNIT_ASSERT(thinker.stop_latency() < 100000U);
+        // A think with a node limit after the deadline searches more than one depth.
+        last_depth = 0;
+        transposition_table.clear();
+        result = thinker.think(MAX_DEPTH, numeric_limits<unsigned>::max(), nullptr, 20000, 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
+          last_depth = depth;
+        });
+        CPPUNIT_ASSERT_EQUAL(true, result);
+        CPPUNIT_ASSERT(best_move.to() != -1);
+        CPPUNIT_ASSERT(last_depth > 1);
+        CPPUNIT_ASSERT(last_depth < MAX_DEPTH);
+        CPPUNIT_ASSERT_EQUAL(false, thinker.has_stop_latency());
+      }
+    }
+
+    void ThinkerTests::test_thinker_thinks_for_new_evaluation_parameters_after_clearing()
+    {
+      int params[MAX_EVALUATION_PARAMETER_COUNT];
+      copy(start_evaluation_parameters, start_evaluation_parameters + MAX_EVALUATION_PARAMETER_COUNT, params);
+      params[EVALUATION_PARAMETER_ISOLATED_PAWN] = -100;
+      params[EVALUATION_PARAMETER_DOUBLED_PAWN] = -100;
+      EvaluationFunction new_evaluation_function(params);
+      SingleSearcher new_searcher(&new_evaluation_function);
+      Thinker new_thinker(&new_searcher);
+      vector<Board> boards;
+      Move best_move;
+      int last_value = 0;
+      int new_last_value = 0;
+      boards.push_back(Board("r1bqkb1r/pp3ppp/2n1pn2/3p4/3P4/2PB1N2/P4PPP/R1BQK2R w KQkq - 0 8"));
+      _M_thinker->clear();
+      _M_thinker->unset_hint_move();
+      _M_thinker->unset_next_hint_move();
+      bool result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {});
+      CPPUNIT_ASSERT_EQUAL(true, result);
+      // The searcher must not use the pawn structure values for the old evaluation parameters.
+      _M_evaluation_function->set(params);
+      _M_thinker->clear();
+      _M_thinker->unset_hint_move();
+      _M_thinker->unset_next_hint_move();
+      result = _M_thinker->think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
+        last_value = value;
+      });
+      CPPUNIT_ASSERT_EQUAL(true, result);
+      new_thinker.clear();
+      new_thinker.unset_hint_move();
+      new_thinker.unset_next_hint_move();
+      result = new_thinker.think(4, numeric_limits<unsigned>::max(), nullptr, numeric_limits<uint64_t>::max(), 0, best_move, boards, [&](int depth, int value, ValueType value_type, unsigned ms, const Searcher *searcher) {
+        new_last_value = value;
+      });
+      CPPUNIT_ASSERT_EQUAL(true, result);
+      CPPUNIT_ASSERT_EQUAL(new_last_value, last_value);
+    }
+
+    void ThinkerTests::test_thinker_keeps_loaded_transposition_table_for_new_game()
+    {
+      const char *file_name = "thinker_tests.tt";
+      TranspositionTable transposition_table(65536);
+      transposition_table.increase_age_or_clear();
+      CPPUNIT_ASSERT_EQUAL(true, transposition_table.store(static_cast<HashKey>(0x1234), -10, 10, 2, 5, Move(Piece::PAWN, D2, D3, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT_EQUAL(true, transposition_table.save(file_name));
+      TranspositionTable new_transposition_table(1024);
+      SingleSearcherWithTT searcher(_M_evaluation_function, &new_transposition_table);
+      Thinker thinker(&searcher);
+      {
+        Engine engine(&thinker);
+        CPPUNIT_ASSERT_EQUAL(true, engine.load_transposition_table(file_name));
+        engine.new_game();
+      }
+      remove(file_name);
+      new_transposition_table.increase_age_or_clear();
+      int alpha = -10, beta = 10, best_value = MIN_VALUE;
+      Move best_move;
+      CPPUNIT_ASSERT_EQUAL(true, new_transposition_table.retrieve(static_cast<HashKey>(0x1234), alpha, beta, 2, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(5, best_value);
+      CPPUNIT_ASSERT(Move(Piece::PAWN, D2, D3, PromotionPiece::NONE) == best_move);
+      // The table is cleared for a next new game.
+      thinker.clear();
+      new_transposition_table.increase_age_or_clear();
+      alpha = -10; beta = 10;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(false, new_transposition_table.retrieve(static_cast<HashKey>(0x1234), alpha, beta, 2, best_value, best_move));
+    }
   }
 }
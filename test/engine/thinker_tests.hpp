@@ -35,6 +35,11 @@ namespace peacockspider
       CPPUNIT_TEST(test_thinker_thinks_after_pondering_with_move_hitting);
       CPPUNIT_TEST(test_thinker_thinks_after_pondering_without_move_hitting);
       CPPUNIT_TEST(test_thinker_ponders_without_pondering_move);
+      CPPUNIT_TEST(test_thinker_widens_aspiration_window_after_fail_high);
+      CPPUNIT_TEST(test_thinker_stops_thinking_at_deadline);
+      CPPUNIT_TEST(test_thinker_stops_thinking_at_deadline_for_many_threads);
+      CPPUNIT_TEST(test_thinker_thinks_for_new_evaluation_parameters_after_clearing);
+      CPPUNIT_TEST(test_thinker_keeps_loaded_transposition_table_for_new_game);
       CPPUNIT_TEST_SUITE_END();
 
       EvaluationFunction *_M_evaluation_function;
@@ -50,6 +55,11 @@ namespace peacockspider
       void test_thinker_thinks_after_pondering_with_move_hitting();
       void test_thinker_thinks_after_pondering_without_move_hitting();
       void test_thinker_ponders_without_pondering_move();
+      void test_thinker_widens_aspiration_window_after_fail_high();
+      void test_thinker_stops_thinking_at_deadline();
+      void test_thinker_stops_thinking_at_deadline_for_many_threads();
+      void test_thinker_thinks_for_new_evaluation_parameters_after_clearing();
+      void test_thinker_keeps_loaded_transposition_table_for_new_game();
     };
   }
 }
@@ -0,0 +1,249 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <stdexcept>
+#include "thread_pool_tests.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  namespace test
+  {
+    CPPUNIT_TEST_SUITE_REGISTRATION(ThreadPoolTests);
+
+    void ThreadPoolTests::test_thread_pool_reserve_method_adds_workers()
+    {
+      ThreadPool pool(2);
+      CPPUNIT_ASSERT_EQUAL(2U, pool.worker_count());
+      pool.reserve(3);
+      CPPUNIT_ASSERT_EQUAL(5U, pool.worker_count());
+    }
+
+    void ThreadPoolTests::test_thread_pool_release_method_retires_workers()
+    {
+      ThreadPool pool(4);
+      pool.release(2);
+      CPPUNIT_ASSERT_EQUAL(2U, pool.worker_count());
+      pool.reserve(1);
+      CPPUNIT_ASSERT_EQUAL(3U, pool.worker_count());
+      pool.release(3);
+      CPPUNIT_ASSERT_EQUAL(0U, pool.worker_count());
+      pool.reserve(5);
+      CPPUNIT_ASSERT_EQUAL(5U, pool.worker_count());
+    }
+
+    void ThreadPoolTests::test_thread_pool_ensure_method_reserves_missing_workers()
+    {
+      ThreadPool pool(2);
+      CPPUNIT_ASSERT_EQUAL(3U, pool.ensure(5));
+      CPPUNIT_ASSERT_EQUAL(5U, pool.worker_count());
+      CPPUNIT_ASSERT_EQUAL(0U, pool.ensure(4));
+      CPPUNIT_ASSERT_EQUAL(5U, pool.worker_count());
+      pool.release(3);
+      CPPUNIT_ASSERT_EQUAL(2U, pool.worker_count());
+      CPPUNIT_ASSERT_EQUAL(1U, pool.ensure(3));
+      CPPUNIT_ASSERT_EQUAL(3U, pool.worker_count());
+    }
+
+    void ThreadPoolTests::test_thread_pool_runs_tasks()
+    {
+      ThreadPool pool(4);
+      TaskGroup task_group;
+      atomic<int> sum(0);
+      for(int i = 1; i <= 1000; i++) {
+        task_group.run(pool, [&sum, i]() { sum.fetch_add(i); });
+      }
+      task_group.wait();
+      CPPUNIT_ASSERT_EQUAL(500500, sum.load());
+    }
+
+    void ThreadPoolTests::test_thread_pool_runs_tasks_that_are_submitted_by_tasks()
+    {
+      ThreadPool pool(3);
+      TaskGroup task_group;
+      atomic<int> count(0);
+      for(int i = 0; i < 10; i++) {
+        task_group.run(pool, [&pool, &task_group, &count]() {
+          for(int j = 0; j < 10; j++) {
+            task_group.run(pool, [&count]() { count.fetch_add(1); });
+          }
+          count.fetch_add(1);
+        });
+      }
+      task_group.wait();
+      CPPUNIT_ASSERT_EQUAL(110, count.load());
+    }
+
+    void ThreadPoolTests::test_thread_pool_runs_tasks_without_workers()
+    {
+      ThreadPool pool;
+      TaskGroup task_group;
+      int count = 0;
+      for(int i = 0; i < 10; i++) {
+        task_group.run(pool, [&count]() { count++; });
+      }
+      task_group.wait();
+      CPPUNIT_ASSERT_EQUAL(0U, pool.worker_count());
+      CPPUNIT_ASSERT_EQUAL(10, count);
+    }
+
+    void ThreadPoolTests::test_thread_pool_runs_tasks_after_retiring_workers()
+    {
+      ThreadPool pool(4);
+      atomic<int> sum(0);
+      for(int j = 0; j < 3; j++) {
+        TaskGroup task_group;
+        for(int i = 1; i <= 1000; i++) {
+          task_group.run(pool, [&sum, i]() { sum.fetch_add(i); });
+        }
+        if(j == 0)
+          pool.release(3);
+        else if(j == 1)
+          pool.reserve(2);
+        task_group.wait();
+      }
+      CPPUNIT_ASSERT_EQUAL(3U, pool.worker_count());
+      CPPUNIT_ASSERT_EQUAL(1501500, sum.load());
+    }
+
+    void ThreadPoolTests::test_thread_pool_retires_worker_after_running_task()
+    {
+      ThreadPool pool(1);
+      TaskGroup task_group;
+      atomic<bool> is_started(false);
+      atomic<bool> can_finish(false);
+      atomic<int> count(0);
+      task_group.run(pool, [&is_started, &can_finish, &count]() {
+        is_started.store(true);
+        while(!can_finish.load()) {
+          this_thread::yield();
+        }
+        count.fetch_add(1);
+      });
+      while(!is_started.load()) {
+        this_thread::yield();
+      }
+      // The release doesn't wait for the task of the retiring worker.
+      pool.release(1);
+      CPPUNIT_ASSERT_EQUAL(0U, pool.worker_count());
+      can_finish.store(true);
+      task_group.wait();
+      CPPUNIT_ASSERT_EQUAL(1, count.load());
+    }
+
+    void ThreadPoolTests::test_task_group_waits_for_tasks_that_run_at_the_same_time()
+    {
+      ThreadPool pool(4);
+      TaskGroup task_group;
+      atomic<int> started_task_count(0);
+      atomic<int> finished_task_count(0);
+      // Each task waits for all tasks, so the tasks must run on different workers.
+      for(int i = 0; i < 4; i++) {
+        task_group.run(pool, [&started_task_count, &finished_task_count]() {
+          started_task_count.fetch_add(1);
+          while(started_task_count.load() < 4) {
+            this_thread::yield();
+          }
+          finished_task_count.fetch_add(1);
+        });
+      }
+      task_group.wait();
+      CPPUNIT_ASSERT_EQUAL(4, finished_task_count.load());
+    }
+
+    void ThreadPoolTests::test_task_group_runs_nested_task_groups_with_one_worker()
+    {
+      ThreadPool pool(1);
+      TaskGroup task_group;
+      atomic<int> count(0);
+      // The worker and the main thread wait for the nested groups, so they must run the tasks of
+      // the nested groups while waiting.
+      for(int i = 0; i < 4; i++) {
+        task_group.run(pool, [&pool, &count]() {
+          TaskGroup nested_task_group;
+          for(int j = 0; j < 10; j++) {
+            nested_task_group.run(pool, [&count]() { count.fetch_add(1); });
+          }
+          nested_task_group.wait();
+          count.fetch_add(1);
+        });
+      }
+      task_group.wait();
+      CPPUNIT_ASSERT_EQUAL(44, count.load());
+    }
+
+    void ThreadPoolTests::test_task_group_wait_method_rethrows_exception_from_task()
+    {
+      ThreadPool pool(2);
+      TaskGroup task_group;
+      atomic<int> count(0);
+      for(int i = 0; i < 10; i++) {
+        task_group.run(pool, [&count, i]() {
+          if(i == 5) throw runtime_error("task error");
+          count.fetch_add(1);
+        });
+      }
+      bool has_exception = false;
+      try {
+        task_group.wait();
+      } catch(runtime_error &e) {
+        has_exception = true;
+      }
+      CPPUNIT_ASSERT(has_exception);
+      CPPUNIT_ASSERT_EQUAL(9, count.load());
+      task_group.run(pool, [&count]() { count.fetch_add(1); });
+      task_group.wait();
+      CPPUNIT_ASSERT_EQUAL(10, count.load());
+    }
+
+    void ThreadPoolTests::test_task_group_wait_method_does_not_run_unrelated_tasks()
+    {
+      ThreadPool pool(1);
+      TaskGroup task_group;
+      atomic<bool> is_started(false);
+      atomic<bool> can_finish(false);
+      atomic<bool> is_unrelated_task_finished(false);
+      thread::id unrelated_thread_id;
+      thread::id group_thread_id;
+      pool.submit([&is_started, &can_finish]() {
+        is_started.store(true);
+        while(!can_finish.load()) {
+          this_thread::yield();
+        }
+      });
+      while(!is_started.load()) {
+        this_thread::yield();
+      }
+      // The worker is busy, so the unrelated task and the group task wait in its deque.
+      pool.submit([&unrelated_thread_id, &is_unrelated_task_finished]() {
+        unrelated_thread_id = this_thread::get_id();
+        is_unrelated_task_finished.store(true);
+      });
+      task_group.run(pool, [&group_thread_id]() { group_thread_id = this_thread::get_id(); });
+      task_group.wait();
+      CPPUNIT_ASSERT(this_thread::get_id() == group_thread_id);
+      CPPUNIT_ASSERT(!is_unrelated_task_finished.load());
+      can_finish.store(true);
+      while(!is_unrelated_task_finished.load()) {
+        this_thread::yield();
+      }
+      CPPUNIT_ASSERT(this_thread::get_id() != unrelated_thread_id);
+    }
+  }
+}
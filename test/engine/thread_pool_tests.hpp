@@ -0,0 +1,63 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _THREAD_POOL_TESTS_HPP
+#define _THREAD_POOL_TESTS_HPP
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestAssert.h>
+#include "thread_pool.hpp"
+
+namespace peacockspider
+{
+  namespace test
+  {
+    class ThreadPoolTests : public CppUnit::TestFixture
+    {
+      CPPUNIT_TEST_SUITE(ThreadPoolTests);
+      CPPUNIT_TEST(test_thread_pool_reserve_method_adds_workers);
+      CPPUNIT_TEST(test_thread_pool_release_method_retires_workers);
+      CPPUNIT_TEST(test_thread_pool_ensure_method_reserves_missing_workers);
+      CPPUNIT_TEST(test_thread_pool_runs_tasks);
+      CPPUNIT_TEST(test_thread_pool_runs_tasks_that_are_submitted_by_tasks);
+      CPPUNIT_TEST(test_thread_pool_runs_tasks_without_workers);
+      CPPUNIT_TEST(test_thread_pool_runs_tasks_after_retiring_workers);
+      CPPUNIT_TEST(test_thread_pool_retires_worker_after_running_task);
+      CPPUNIT_TEST(test_task_group_waits_for_tasks_that_run_at_the_same_time);
+      CPPUNIT_TEST(test_task_group_runs_nested_task_groups_with_one_worker);
+      CPPUNIT_TEST(test_task_group_wait_method_rethrows_exception_from_task);
+      CPPUNIT_TEST(test_task_group_wait_method_does_not_run_unrelated_tasks);
+      CPPUNIT_TEST_SUITE_END();
+    public:
+      void test_thread_pool_reserve_method_adds_workers();
+      void test_thread_pool_release_method_retires_workers();
+      void test_thread_pool_ensure_method_reserves_missing_workers();
+      void test_thread_pool_runs_tasks();
+      void test_thread_pool_runs_tasks_that_are_submitted_by_tasks();
+      void test_thread_pool_runs_tasks_without_workers();
+      void test_thread_pool_runs_tasks_after_retiring_workers();
+      void test_thread_pool_retires_worker_after_running_task();
+      void test_task_group_waits_for_tasks_that_run_at_the_same_time();
+      void test_task_group_runs_nested_task_groups_with_one_worker();
+      void test_task_group_wait_method_rethrows_exception_from_task();
+      void test_task_group_wait_method_does_not_run_unrelated_tasks();
+    };
+  }
+}
+
+#endif
@@ -15,6 +15,8 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <cstdio>
+#include <fstream>
 #include "search.hpp"
 #include "transpos_table_tests.hpp"
 
@@ -468,5 +470,256 @@ namespace peacockspider
       CPPUNIT_ASSERT_EQUAL(MIN_VALUE, best_value);
       CPPUNIT_ASSERT(Move(Piece::PAWN, -1, -1, PromotionPiece::NONE) == best_move);
     }
+
+    void TranspositionTableTests::test_transposition_table_does_not_retrieve_entry_for_abdada_and_exclusive_after_retrieve_for_other_hash_key()
+    {
+      int alpha, beta, best_value;
+      Move best_move;
+      alpha = -100; beta = 100;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(false, _M_tt->retrieve_for_abdada(static_cast<HashKey>(0x123456), alpha, beta, 2, best_value, best_move, false));
+      alpha = -100; beta = 100;
+      best_value = MIN_VALUE;
+      best_move = Move(Piece::PAWN, E1, E3, PromotionPiece::NONE);
+      CPPUNIT_ASSERT_EQUAL(false, _M_tt->retrieve_for_abdada(static_cast<HashKey>(0x133456), alpha, beta, 2, best_value, best_move, true));
+      CPPUNIT_ASSERT_EQUAL(-100, alpha);
+      CPPUNIT_ASSERT_EQUAL(100, beta);
+      CPPUNIT_ASSERT_EQUAL(MIN_VALUE, best_value);
+      CPPUNIT_ASSERT(Move(Piece::PAWN, -1, -1, PromotionPiece::NONE) == best_move);
+      alpha = -100; beta = 100;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->retrieve_for_abdada(static_cast<HashKey>(0x123456), alpha, beta, 2, best_value, best_move, true));
+      CPPUNIT_ASSERT_EQUAL(VALUE_ON_EVALUATION, best_value);
+    }
+
+    void TranspositionTableTests::test_transposition_table_stores_entries_in_same_bucket()
+    {
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->store(static_cast<HashKey>(0x1234), -100, 100, 2, 10, Move(Piece::PAWN, E2, E4, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->store(static_cast<HashKey>(0x5234), -100, 100, 4, 20, Move(Piece::PAWN, D2, D4, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->store(static_cast<HashKey>(0x9234), -100, 100, 3, 30, Move(Piece::PAWN, C2, C4, PromotionPiece::NONE)));
+      int alpha, beta, best_value;
+      Move best_move;
+      alpha = -100; beta = 100;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->retrieve(static_cast<HashKey>(0x1234), alpha, beta, 2, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(10, best_value);
+      CPPUNIT_ASSERT(Move(Piece::PAWN, E2, E4, PromotionPiece::NONE) == best_move);
+      alpha = -100; beta = 100;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->retrieve(static_cast<HashKey>(0x5234), alpha, beta, 4, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(20, best_value);
+      CPPUNIT_ASSERT(Move(Piece::PAWN, D2, D4, PromotionPiece::NONE) == best_move);
+      alpha = -100; beta = 100;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->retrieve(static_cast<HashKey>(0x9234), alpha, beta, 3, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(30, best_value);
+      CPPUNIT_ASSERT(Move(Piece::PAWN, C2, C4, PromotionPiece::NONE) == best_move);
+    }
+
+    void TranspositionTableTests::test_transposition_table_replaces_entry_with_least_depth_in_bucket()
+    {
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->store(static_cast<HashKey>(0x1234), -100, 100, 5, 10, Move(Piece::PAWN, E2, E4, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->store(static_cast<HashKey>(0x5234), -100, 100, 2, 20, Move(Piece::PAWN, D2, D4, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->store(static_cast<HashKey>(0x9234), -100, 100, 4, 30, Move(Piece::PAWN, C2, C4, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->store(static_cast<HashKey>(0xd234), -100, 100, 6, 40, Move(Piece::PAWN, B2, B4, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->store(static_cast<HashKey>(0x11234), -100, 100, 3, 60, Move(Piece::PAWN, A2, A4, PromotionPiece::NONE)));
+      int alpha, beta, best_value;
+      Move best_move;
+      alpha = -100; beta = 100;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(false, _M_tt->retrieve(static_cast<HashKey>(0x5234), alpha, beta, 2, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(MIN_VALUE, best_value);
+      CPPUNIT_ASSERT(Move(Piece::PAWN, -1, -1, PromotionPiece::NONE) == best_move);
+      alpha = -100; beta = 100;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->retrieve(static_cast<HashKey>(0x1234), alpha, beta, 5, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(10, best_value);
+      alpha = -100; beta = 100;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->retrieve(static_cast<HashKey>(0x9234), alpha, beta, 4, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(30, best_value);
+      alpha = -100; beta = 100;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->retrieve(static_cast<HashKey>(0xd234), alpha, beta, 6, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(40, best_value);
+      alpha = -100; beta = 100;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, _M_tt->retrieve(static_cast<HashKey>(0x11234), alpha, beta, 3, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(60, best_value);
+    }
+
+    void TranspositionTableTests::test_transposition_table_has_power_of_two_bucket_count()
+    {
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(64), sizeof(TranspositionTableBucket));
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(65536), _M_tt->entry_count());
+      TranspositionTable tt(200000);
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(131072), tt.entry_count());
+    }
+
+    void TranspositionTableTests::test_transposition_table_bucket_does_not_load_torn_entry()
+    {
+      TranspositionTableEntry entry1;
+      entry1.set_partial_hash_key(0x12345678);
+      entry1.set_depth(4);
+      entry1.set_value(10);
+      entry1.set_best_move(Move(Piece::PAWN, E2, E4, PromotionPiece::NONE));
+      entry1.set_value_type(ValueType::EXACT);
+      entry1.set_age(3);
+      TranspositionTableEntry entry2 = entry1;
+      entry2.set_depth(5);
+      TranspositionTableEntry entry3 = entry1;
+      entry3.set_value_type(ValueType::LOWER_BOUND);
+      entry3.set_best_move(Move(Piece::KNIGHT, G1, F3, PromotionPiece::NONE));
+      TranspositionTableEntry entries[] = { entry2, entry3 };
+      for(const TranspositionTableEntry &entry : entries) {
+        TranspositionTableBucket bucket1, bucket2, torn_bucket;
+        bucket1.store(0, entry1);
+        bucket2.store(0, entry);
+        torn_bucket.words[0].store(bucket1.words[0].load());
+        torn_bucket.words[1].store(bucket2.words[1].load());
+        TranspositionTableEntry loaded_entry;
+        bucket1.load(0, loaded_entry);
+        CPPUNIT_ASSERT_EQUAL(static_cast<uint32_t>(0x12345678), loaded_entry.partial_hash_key());
+        CPPUNIT_ASSERT_EQUAL(4, loaded_entry.depth());
+        torn_bucket.load(0, loaded_entry);
+        CPPUNIT_ASSERT(static_cast<uint32_t>(0x12345678) != loaded_entry.partial_hash_key());
+      }
+    }
+
+    void TranspositionTableTests::test_transposition_table_clears_entries_for_many_threads()
+    {
+      TranspositionTable tt(65536, 4);
+      HashKey hash_keys[] = { 0x1234, 0x123456, 0x2345678, 0xfff0, 0x1fff0 };
+      for(HashKey hash_key : hash_keys) {
+        CPPUNIT_ASSERT_EQUAL(true, tt.store(hash_key, -10, 10, 2, 5, Move(Piece::PAWN, D2, D3, PromotionPiece::NONE)));
+      }
+      tt.clear();
+      for(HashKey hash_key : hash_keys) {
+        int alpha, beta, best_value;
+        Move best_move;
+        alpha = -10; beta = 10;
+        best_value = MIN_VALUE;
+        CPPUNIT_ASSERT_EQUAL(false, tt.retrieve(hash_key, alpha, beta, 2, best_value, best_move));
+        CPPUNIT_ASSERT_EQUAL(MIN_VALUE, best_value);
+        CPPUNIT_ASSERT(Move(Piece::PAWN, -1, -1, PromotionPiece::NONE) == best_move);
+      }
+      CPPUNIT_ASSERT_EQUAL(true, tt.store(static_cast<HashKey>(0xfff0), -10, 10, 2, 5, Move(Piece::PAWN, D2, D3, PromotionPiece::NONE)));
+      int alpha, beta, best_value;
+      Move best_move;
+      alpha = -10; beta = 10;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, tt.retrieve(static_cast<HashKey>(0xfff0), alpha, beta, 2, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(5, best_value);
+    }
+
+    void TranspositionTableTests::test_transposition_table_resizes()
+    {
+      TranspositionTable tt(65536);
+      CPPUNIT_ASSERT_EQUAL(true, tt.store(static_cast<HashKey>(0x1234), -10, 10, 2, 5, Move(Piece::PAWN, D2, D3, PromotionPiece::NONE)));
+      tt.increase_age_or_clear();
+      tt.resize(262144);
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(262144), tt.entry_count());
+      int alpha, beta, best_value;
+      Move best_move;
+      alpha = -10; beta = 10;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(false, tt.retrieve(static_cast<HashKey>(0x1234), alpha, beta, 2, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(MIN_VALUE, best_value);
+      CPPUNIT_ASSERT_EQUAL(true, tt.store(static_cast<HashKey>(0x1234), -10, 10, 2, 7, Move(Piece::PAWN, D2, D4, PromotionPiece::NONE)));
+      tt.resize(1024);
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1024), tt.entry_count());
+      CPPUNIT_ASSERT_EQUAL(true, tt.store(static_cast<HashKey>(0x1234), -10, 10, 2, 9, Move(Piece::PAWN, D2, D4, PromotionPiece::NONE)));
+      alpha = -10; beta = 10;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, tt.retrieve(static_cast<HashKey>(0x1234), alpha, beta, 2, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(9, best_value);
+    }
+
+    void TranspositionTableTests::test_transposition_table_saves_and_loads_entries()
+    {
+      const char *file_name = "transpos_table_tests.tt";
+      TranspositionTable tt(65536);
+      tt.increase_age_or_clear();
+      tt.increase_age_or_clear();
+      CPPUNIT_ASSERT_EQUAL(true, tt.store(static_cast<HashKey>(0x1234), -10, 10, 2, 5, Move(Piece::PAWN, D2, D3, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT_EQUAL(true, tt.store(static_cast<HashKey>(0x123456), -10, 10, 3, -10, Move(Piece::KNIGHT, G1, F3, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT_EQUAL(true, tt.save(file_name));
+      TranspositionTable tt2(1024);
+      CPPUNIT_ASSERT_EQUAL(true, tt2.load(file_name));
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(65536), tt2.entry_count());
+      tt2.increase_age_or_clear();
+      int alpha, beta, best_value;
+      Move best_move;
+      alpha = -10; beta = 10;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, tt2.retrieve(static_cast<HashKey>(0x1234), alpha, beta, 2, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(5, best_value);
+      CPPUNIT_ASSERT(Move(Piece::PAWN, D2, D3, PromotionPiece::NONE) == best_move);
+      alpha = -10; beta = 10;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, tt2.retrieve(static_cast<HashKey>(0x123456), alpha, beta, 3, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(-10, best_value);
+      CPPUNIT_ASSERT(Move(Piece::KNIGHT, G1, F3, PromotionPiece::NONE) == best_move);
+      CPPUNIT_ASSERT_EQUAL(true, tt2.store(static_cast<HashKey>(0x2345678), -10, 10, 2, 7, Move(Piece::PAWN, E2, E4, PromotionPiece::NONE)));
+      alpha = -10; beta = 10;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, tt2.retrieve(static_cast<HashKey>(0x2345678), alpha, beta, 2, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(7, best_value);
+      TranspositionTable tt3(1024);
+      CPPUNIT_ASSERT_EQUAL(true, tt3.load(file_name));
+      tt3.increase_age_or_clear();
+      alpha = -10; beta = 10;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(false, tt3.retrieve(static_cast<HashKey>(0x2345678), alpha, beta, 2, best_value, best_move));
+      remove(file_name);
+    }
+
+    void TranspositionTableTests::test_transposition_table_saves_and_loads_entries_for_zero_age()
+    {
+      const char *file_name = "transpos_table_tests.tt";
+      TranspositionTable tt(65536);
+      CPPUNIT_ASSERT_EQUAL(true, tt.store(static_cast<HashKey>(0x1234), -10, 10, 2, 5, Move(Piece::PAWN, D2, D3, PromotionPiece::NONE)));
+      CPPUNIT_ASSERT_EQUAL(true, tt.save(file_name));
+      TranspositionTable tt2(1024);
+      tt2.increase_age_or_clear();
+      tt2.increase_age_or_clear();
+      tt2.clear();
+      CPPUNIT_ASSERT_EQUAL(true, tt2.load(file_name));
+      tt2.increase_age_or_clear();
+      int alpha, beta, best_value;
+      Move best_move;
+      alpha = -10; beta = 10;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, tt2.retrieve(static_cast<HashKey>(0x1234), alpha, beta, 2, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(5, best_value);
+      CPPUNIT_ASSERT(Move(Piece::PAWN, D2, D3, PromotionPiece::NONE) == best_move);
+      tt2.increase_age_or_clear();
+      alpha = -10; beta = 10;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(false, tt2.retrieve(static_cast<HashKey>(0x1234), alpha, beta, 2, best_value, best_move));
+      remove(file_name);
+    }
+
+    void TranspositionTableTests::test_transposition_table_does_not_load_entries_from_incorrect_file()
+    {
+      const char *file_name = "transpos_table_tests.tt";
+      TranspositionTable tt(1024);
+      CPPUNIT_ASSERT_EQUAL(true, tt.store(static_cast<HashKey>(0x1234), -10, 10, 2, 5, Move(Piece::PAWN, D2, D3, PromotionPiece::NONE)));
+      remove(file_name);
+      CPPUNIT_ASSERT_EQUAL(false, tt.load(file_name));
+      {
+        ofstream ofs(file_name, ios_base::out | ios_base::binary | ios_base::trunc);
+        ofs << "incorrect transposition table file";
+      }
+      CPPUNIT_ASSERT_EQUAL(false, tt.load(file_name));
+      remove(file_name);
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1024), tt.entry_count());
+      int alpha, beta, best_value;
+      Move best_move;
+      alpha = -10; beta = 10;
+      best_value = MIN_VALUE;
+      CPPUNIT_ASSERT_EQUAL(true, tt.retrieve(static_cast<HashKey>(0x1234), alpha, beta, 2, best_value, best_move));
+      CPPUNIT_ASSERT_EQUAL(5, best_value);
+    }
   }
 }
@@ -57,6 +57,16 @@ namespace peacockspider
       CPPUNIT_TEST(test_transposition_table_does_not_retrieve_entry_for_abdada_and_exclusive);
       CPPUNIT_TEST(test_transposition_table_does_not_retrieve_entry_for_abdada_and_exclusive_after_retrieve);
       CPPUNIT_TEST(test_transposition_table_decreases_thread_count);
+      CPPUNIT_TEST(test_transposition_table_does_not_retrieve_entry_for_abdada_and_exclusive_after_retrieve_for_other_hash_key);
+      CPPUNIT_TEST(test_transposition_table_stores_entries_in_same_bucket);
+      CPPUNIT_TEST(test_transposition_table_replaces_entry_with_least_depth_in_bucket);
+      CPPUNIT_TEST(test_transposition_table_has_power_of_two_bucket_count);
+      CPPUNIT_TEST(test_transposition_table_bucket_does_not_load_torn_entry);
+      CPPUNIT_TEST(test_transposition_table_clears_entries_for_many_threads);
+      CPPUNIT_TEST(test_transposition_table_resizes);
+      CPPUNIT_TEST(test_transposition_table_saves_and_loads_entries);
+      CPPUNIT_TEST(test_transposition_table_saves_and_loads_entries_for_zero_age);
+      CPPUNIT_TEST(test_transposition_table_does_not_load_entries_from_incorrect_file);
       CPPUNIT_TEST_SUITE_END();
 
       TranspositionTable *_M_tt;
@@ -92,6 +102,16 @@ namespace peacockspider
       void test_transposition_table_does_not_retrieve_entry_for_abdada_and_exclusive();
       void test_transposition_table_does_not_retrieve_entry_for_abdada_and_exclusive_after_retrieve();
       void test_transposition_table_decreases_thread_count();
+      void test_transposition_table_does_not_retrieve_entry_for_abdada_and_exclusive_after_retrieve_for_other_hash_key();
+      void test_transposition_table_stores_entries_in_same_bucket();
+      void test_transposition_table_replaces_entry_with_least_depth_in_bucket();
+      void test_transposition_table_has_power_of_two_bucket_count();
+      void test_transposition_table_bucket_does_not_load_torn_entry();
+      void test_transposition_table_clears_entries_for_many_threads();
+      void test_transposition_table_resizes();
+      void test_transposition_table_saves_and_loads_entries();
+      void test_transposition_table_saves_and_loads_entries_for_zero_age();
+      void test_transposition_table_does_not_load_entries_from_incorrect_file();
     };
   }
 }
@@ -0,0 +1,165 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ybwc_searcher_tests.hpp"
+
+using namespace std;
+
+namespace peacockspider
+{
+  namespace test
+  {
+    CPPUNIT_TEST_SUITE_REGISTRATION(YBWCSearcherTests);
+
+    void YBWCSearcherTests::setUp()
+    {
+      _M_evaluation_function = new EvaluationFunction(start_evaluation_parameters);
+      _M_transposition_table = new TranspositionTable(65536);
+      _M_searcher = new YBWCSearcher(_M_evaluation_function, _M_transposition_table, 4);
+    }
+
+    void YBWCSearcherTests::tearDown()
+    {
+      delete _M_searcher;
+      delete _M_transposition_table;
+      delete _M_evaluation_function;
+    }
+
+    void YBWCSearcherTests::test_searcher_changes_thread_count()
+    {
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      Board board("r1bqkb1r/pppp1ppp/2n2n2/4p3/4P3/2N2N2/PPPP1PPP/R1BQKB1R w KQkq - 0 4");
+      board.generate_pseudolegal_moves(move_pairs);
+      CPPUNIT_ASSERT_EQUAL(true, _M_searcher->can_set_thread_count());
+      unsigned thread_counts[] = { 4, 1, 3 };
+      for(unsigned thread_count : thread_counts) {
+        vector<Board> boards;
+        Move best_move;
+        _M_searcher->set_thread_count(thread_count);
+        CPPUNIT_ASSERT_EQUAL(thread_count, _M_searcher->thread_count());
+        CPPUNIT_ASSERT_EQUAL(thread_count, _M_transposition_table->thread_count());
+        _M_searcher->clear_for_new_game();
+        _M_searcher->set_board(board);
+        boards.push_back(board);
+        int value = _M_searcher->search_from_root(MIN_VALUE, MAX_VALUE, 5, nullptr, best_move, boards, nullptr);
+        CPPUNIT_ASSERT(value >= MIN_VALUE && value <= MAX_VALUE);
+        CPPUNIT_ASSERT(move_pairs.contain_move(best_move));
+        CPPUNIT_ASSERT(board.has_legal_move(best_move));
+      }
+    }
+
+    void YBWCSearcherTests::test_searcher_splits_nodes()
+    {
+      YBWCSearcher *searcher = static_cast<YBWCSearcher *>(_M_searcher);
+      Board board("r1bqkb1r/pppp1ppp/2n2n2/4p3/4P3/2N2N2/PPPP1PPP/R1BQKB1R w KQkq - 0 4");
+      vector<Board> boards;
+      boards.push_back(board);
+      searcher->clear();
+      searcher->set_board(board);
+      for(int depth = 1; depth <= 6; depth++) {
+        Move best_move;
+        int value = searcher->search_from_root(MIN_VALUE, MAX_VALUE, depth, nullptr, best_move, boards, nullptr);
+        CPPUNIT_ASSERT(value > MIN_VALUE && value < MAX_VALUE);
+        CPPUNIT_ASSERT(board.has_legal_move(best_move));
+        searcher->set_previous_pv_line(searcher->pv_line());
+      }
+      CPPUNIT_ASSERT(searcher->split_count() > 0);
+      searcher->clear();
+      CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0), searcher->split_count());
+    }
+
+    void YBWCSearcherTests::test_searcher_aborts_helper_thread_for_cutoff()
+    {
+      Board board("r1bqkb1r/pppp1ppp/2n2n2/4p3/4P3/2N2N2/PPPP1PPP/R1BQKB1R w KQkq - 0 4");
+      vector<Board> boards;
+      boards.push_back(board);
+      vector<YBWCThread> threads;
+      YBWCSplitPointList split_point_list;
+      split_point_list.idle_thread_count.store(0);
+      split_point_list.quit_flag = false;
+      YBWCSinglePVSSearcher searcher(_M_evaluation_function, _M_transposition_table, nullptr, threads, split_point_list, MAX_DEPTH, MAX_QUIESCENCE_DEPTH);
+      searcher.clear();
+      searcher.set_board(board);
+      searcher.set_root_hash_keys(boards, nullptr);
+      HashKeyHistory hash_key_history(MAX_DEPTH + MAX_QUIESCENCE_DEPTH + 1);
+      hash_key_history.set_root(boards, nullptr);
+      // The cutoff in the parent split point must abort the helper thread in the search of the
+      // first move.
+      unique_ptr<YBWCSplitPoint> parent_split_point(new YBWCSplitPoint(hash_key_history, MAX_DEPTH + MAX_QUIESCENCE_DEPTH));
+      parent_split_point->parent = nullptr;
+      parent_split_point->cutoff_flag.store(true);
+      unique_ptr<YBWCSplitPoint> split_point(new YBWCSplitPoint(hash_key_history, MAX_DEPTH + MAX_QUIESCENCE_DEPTH));
+      split_point->parent = parent_split_point.get();
+      split_point->board = board;
+      _M_evaluation_function->set_accumulator(board, split_point->evaluation_accumulator);
+      split_point->previous_move = Move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+      split_point->depth = 8;
+      split_point->ply = 0;
+      split_point->beta = MAX_VALUE;
+      split_point->in_check = false;
+      split_point->can_make_null_move = true;
+      split_point->eval_value = 0;
+      unique_ptr<MovePair []> tmp_move_pairs(new MovePair[MAX_MOVE_COUNT]);
+      MovePairList move_pairs(tmp_move_pairs.get(), 0);
+      board.generate_legal_moves(move_pairs);
+      for(size_t i = 0; i < move_pairs.length(); i++) {
+        split_point->moves[i] = move_pairs[i].move;
+        split_point->move_counts[i] = i + 1;
+      }
+      split_point->move_count = move_pairs.length();
+      split_point->alpha = MIN_VALUE;
+      split_point->best_value = MIN_VALUE;
+      split_point->best_move = Move(Piece::PAWN, -1, -1, PromotionPiece::NONE);
+      split_point->thread_count = 1;
+      searcher.join_split_point(split_point.get());
+      CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), split_point->next_move_index);
+      CPPUNIT_ASSERT_EQUAL(MIN_VALUE, split_point->best_value);
+      CPPUNIT_ASSERT(Move(Piece::PAWN, -1, -1, PromotionPiece::NONE) == split_point->best_move);
+      CPPUNIT_ASSERT(searcher.nodes() <= NODE_PUBLISHING_MASK + 1);
+    }
+
+    void YBWCSearcherTests::test_searcher_finds_same_values_as_single_pvs_searcher()
+    {
+      const char *fens[] = {
+        "3r2k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+        "6k1/8/6K1/8/8/8/8/R7 w - - 0 1",
+        "r1bqkbnr/pppp1ppp/2n5/4p3/2B1P3/5Q2/PPPP1PPP/RNB1K1NR w KQkq - 4 4",
+        "7k/8/8/8/8/8/R7/1R4K1 w - - 0 1"
+      };
+      SinglePVSSearcher single_searcher(_M_evaluation_function);
+      unsigned thread_counts[] = { 2, 4 };
+      for(unsigned thread_count : thread_counts) {
+        _M_searcher->set_thread_count(thread_count);
+        for(const char *fen : fens) {
+          Board board(fen);
+          vector<Board> boards;
+          boards.push_back(board);
+          Move best_move, single_best_move;
+          single_searcher.clear();
+          single_searcher.set_board(board);
+          int single_value = single_searcher.search_from_root(MIN_VALUE, MAX_VALUE, 5, nullptr, single_best_move, boards, nullptr);
+          _M_searcher->clear_for_new_game();
+          _M_searcher->set_board(board);
+          int value = _M_searcher->search_from_root(MIN_VALUE, MAX_VALUE, 5, nullptr, best_move, boards, nullptr);
+          CPPUNIT_ASSERT_EQUAL(single_value, value);
+          CPPUNIT_ASSERT(board.has_legal_move(best_move));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,50 @@
+/*
+ * Peacock Spider - Chess engine.
+ * Copyright (C) 2020 Łukasz Szpakowski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _YBWC_SEARCHER_TESTS_HPP
+#define _YBWC_SEARCHER_TESTS_HPP
+
+#include "searcher_tests.hpp"
+
+namespace peacockspider
+{
+  namespace test
+  {
+    class YBWCSearcherTests : public SearcherTests
+    {
+      CPPUNIT_TEST_SUB_SUITE(YBWCSearcherTests, SearcherTests);
+      CPPUNIT_TEST(test_searcher_changes_thread_count);
+      CPPUNIT_TEST(test_searcher_splits_nodes);
+      CPPUNIT_TEST(test_searcher_aborts_helper_thread_for_cutoff);
+      CPPUNIT_TEST(test_searcher_finds_same_values_as_single_pvs_searcher);
+      CPPUNIT_TEST_SUITE_END();
+    protected:
+      TranspositionTable *_M_transposition_table;
+    public:
+      void setUp();
+
+      void tearDown();
+
+      void test_searcher_changes_thread_count();
+      void test_searcher_splits_nodes();
+      void test_searcher_aborts_helper_thread_for_cutoff();
+      void test_searcher_finds_same_values_as_single_pvs_searcher();
+    };
+  }
+}
+
+#endif